@@ -0,0 +1,370 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <complex>
+#include <functional>
+#include <stdexcept>
+
+#include "matrix.h"
+#include "lu.h"
+#include "dense_vector.h"
+#include "quantized_matrix.h"
+
+
+using namespace std;
+
+///   Matrix<T>:  (, , ), GFLOP/s  GB/s.
+///    CSV  JSON,     diff.
+///
+/// lab_1_bench [--sizes 3,64,1024] [--max-size N] [--types float,double,complex]
+///             [--ops mul,add,scale,trace,inverse,copy,transpose,random,gemv,qmul] [--min-runs N] [--max-runs N]
+///             [--min-time SEC] [--max-memory MB] [--format csv|json] [--output FILE] [--threads N]
+
+///  
+struct BenchOptions {
+    vector<size_t> sizes = {3, 8, 16, 32, 64, 128, 256, 512, 1024, 2048, 4096, 8192};
+    vector<string> types = {"float", "double", "complex"};
+    vector<string> ops = {"mul", "add", "scale", "trace", "inverse", "copy", "transpose", "random", "gemv", "qmul"};
+    size_t minRuns = 3;
+    size_t maxRuns = 1000;
+    double minTime = 0.2;
+    size_t maxMemoryMb = 3072;
+    string format = "csv";
+    string output;
+    size_t threads = 0;
+};
+
+///    
+struct BenchResult {
+    string op;
+    string type;
+    size_t n = 0;
+    size_t runs = 0;
+    double minSec = 0;
+    double medianSec = 0;
+    double p90Sec = 0;
+    double p99Sec = 0;
+    double maxSec = 0;
+    double gflops = 0;
+    double gbps = 0;
+};
+
+///    ( )
+double percentile(const vector<double>& sorted, double p) {
+    const size_t rank = static_cast<size_t>(p / 100.0 * (sorted.size() - 1) + 0.5);
+    return sorted[min(rank, sorted.size() - 1)];
+}
+
+///  f,    minRuns   minTime  (   maxRuns)
+vector<double> measure(const BenchOptions& options, const function<void()>& f) {
+    f();  // :  , ,  
+    vector<double> samples;
+    double total = 0;
+    while (samples.size() < options.maxRuns && (samples.size() < options.minRuns || total < options.minTime)) {
+        const auto start = chrono::steady_clock::now();
+        f();
+        const double sec = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        samples.push_back(sec);
+        total += sec;
+    }
+    sort(samples.begin(), samples.end());
+    return samples;
+}
+
+///         T
+template<typename T>
+constexpr double flopScale(double real, double complex) {
+    return is_complex<T>::value ? complex : real;
+}
+
+/// ,       
+template<typename T>
+double checksum(const Matrix<T>& matrix) {
+    return abs(matrix(0, 0)) + abs(matrix(matrix.getRows() - 1, matrix.getCols() - 1));
+}
+
+volatile double benchSink = 0;
+
+///   T (     )
+template<typename T>
+T benchValue(double re, double im) {
+    if constexpr (is_complex<T>::value) {
+        return T(re, im);
+    }
+    else {
+        return T(re);
+    }
+}
+
+template<typename T>
+void benchType(const BenchOptions& options, const string& typeName, vector<BenchResult>& results) {
+    const T lower = benchValue<T>(-1, -1);
+    const T upper = benchValue<T>(1, 1);
+    const T scalar = benchValue<T>(1.5, 0.5);
+    const double bytes = sizeof(T);
+
+    for (size_t n : options.sizes) {
+        const double n2 = double(n) * n;
+        const double n3 = n2 * n;
+        for (const string& op : options.ops) {
+            //   -    Matrix<float>
+            if (op == "qmul" && !is_same_v<T, float>) {
+                continue;
+            }
+            //     n x n (   3M  9  )
+            double matrices = 3;
+            if (op == "mul" && is_complex<T>::value) {
+                matrices = 3 + 4.5;
+            }
+            else if (op == "inverse") {
+                matrices = 4;
+            }
+            if (matrices * n2 * bytes > double(options.maxMemoryMb) * 1024 * 1024) {
+                cerr << "skip " << op << " " << typeName << " " << n << ": exceeds --max-memory" << endl;
+                continue;
+            }
+
+            Matrix<T> a(n, n, lower, upper, 1);
+            Matrix<T> b(n, n, lower, upper, 2);
+            double flops = 0;
+            double traffic = 0;
+            vector<double> samples;
+
+            if (op == "mul") {
+                flops = flopScale<T>(2, 8) * n3;
+                traffic = 3 * n2 * bytes;
+                samples = measure(options, [&] { Matrix<T> c = a * b; benchSink = benchSink + checksum(c); });
+            }
+            else if (op == "add") {
+                flops = flopScale<T>(1, 2) * n2;
+                traffic = 3 * n2 * bytes;
+                samples = measure(options, [&] { Matrix<T> c = a + b; benchSink = benchSink + checksum(c); });
+            }
+            else if (op == "scale") {
+                flops = flopScale<T>(1, 6) * n2;
+                traffic = 2 * n2 * bytes;
+                samples = measure(options, [&] { Matrix<T> c = a * scalar; benchSink = benchSink + checksum(c); });
+            }
+            else if (op == "trace") {
+                flops = flopScale<T>(1, 2) * n;
+                traffic = n * bytes;
+                samples = measure(options, [&] { benchSink = benchSink + abs(a.trace()); });
+            }
+            else if (op == "inverse") {
+                // LU (2/3 n^3)       (4/3 n^3)
+                flops = flopScale<T>(2, 8) * n3;
+                traffic = 2 * n2 * bytes;
+                samples = measure(options, [&] { Matrix<T> c = inverse(a); benchSink = benchSink + checksum(c); });
+            }
+            else if (op == "copy") {
+                traffic = 2 * n2 * bytes;
+                samples = measure(options, [&] { Matrix<T> c(a); benchSink = benchSink + checksum(c); });
+            }
+            else if (op == "transpose") {
+                traffic = 2 * n2 * bytes;
+                samples = measure(options, [&] { Matrix<T> c(a.transposed()); benchSink = benchSink + checksum(c); });
+            }
+            else if (op == "random") {
+                traffic = n2 * bytes;
+                uint64_t seed = 3;
+                samples = measure(options, [&] { a.fillRandom(lower, upper, seed++); benchSink = benchSink + checksum(a); });
+            }
+            else if (op == "gemv") {
+                flops = flopScale<T>(2, 8) * n2;
+                traffic = n2 * bytes;
+                const Vector<T> x(n, scalar);
+                Vector<T> y(n);
+                samples = measure(options, [&] { gemv(scalar, a, x, T(), y); benchSink = benchSink + abs(y[0]); });
+            }
+            else if (op == "qmul") {
+                //  int8 :   ,  -  
+                if constexpr (is_same_v<T, float>) {
+                    flops = 2 * n3;
+                    traffic = 2 * n2 + n2 * bytes;
+                    const QuantizedMatrix qa(a, QuantAxis::Rows);
+                    const QuantizedMatrix qb(b, QuantAxis::Columns);
+                    samples = measure(options, [&] { Matrix<T> c = qa * qb; benchSink = benchSink + checksum(c); });
+                }
+            }
+            else {
+                throw invalid_argument(" : " + op);
+            }
+
+            BenchResult result;
+            result.op = op;
+            result.type = typeName;
+            result.n = n;
+            result.runs = samples.size();
+            result.minSec = samples.front();
+            result.medianSec = percentile(samples, 50);
+            result.p90Sec = percentile(samples, 90);
+            result.p99Sec = percentile(samples, 99);
+            result.maxSec = samples.back();
+            result.gflops = flops / result.medianSec / 1e9;
+            result.gbps = traffic / result.medianSec / 1e9;
+            results.push_back(result);
+            cerr << op << " " << typeName << " " << n << ": " << result.medianSec << " s" << endl;
+        }
+    }
+}
+
+const char* simdLevelName() {
+    switch (simdLevel()) {
+    case SimdLevel::Avx512:
+        return "avx512";
+    case SimdLevel::Avx2:
+        return "avx2";
+    default:
+        return "generic";
+    }
+}
+
+void writeCsv(ostream& os, const vector<BenchResult>& results) {
+    os << "# simd=" << simdLevelName() << " threads=" << threadCount() << endl;
+    os << "op,type,n,runs,min_s,median_s,p90_s,p99_s,max_s,gflops,gbps" << endl;
+    os.precision(6);
+    for (const BenchResult& r : results) {
+        os << r.op << "," << r.type << "," << r.n << "," << r.runs << "," << r.minSec << "," << r.medianSec << ","
+           << r.p90Sec << "," << r.p99Sec << "," << r.maxSec << "," << r.gflops << "," << r.gbps << endl;
+    }
+}
+
+void writeJson(ostream& os, const vector<BenchResult>& results) {
+    os.precision(6);
+    os << "{" << endl;
+    os << "  \"simd\": \"" << simdLevelName() << "\"," << endl;
+    os << "  \"threads\": " << threadCount() << "," << endl;
+    os << "  \"results\": [" << endl;
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchResult& r = results[i];
+        os << "    {\"op\": \"" << r.op << "\", \"type\": \"" << r.type << "\", \"n\": " << r.n << ", \"runs\": " << r.runs
+           << ", \"min_s\": " << r.minSec << ", \"median_s\": " << r.medianSec << ", \"p90_s\": " << r.p90Sec
+           << ", \"p99_s\": " << r.p99Sec << ", \"max_s\": " << r.maxSec << ", \"gflops\": " << r.gflops
+           << ", \"gbps\": " << r.gbps << "}" << (i + 1 < results.size() ? "," : "") << endl;
+    }
+    os << "  ]" << endl;
+    os << "}" << endl;
+}
+
+vector<string> splitList(const string& text) {
+    vector<string> items;
+    stringstream ss(text);
+    string item;
+    while (getline(ss, item, ',')) {
+        if (!item.empty()) {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+BenchOptions parseOptions(int argc, char* argv[]) {
+    BenchOptions options;
+    size_t maxSize = 0;
+    for (int i = 1; i < argc; i++) {
+        const string arg = argv[i];
+        if (i + 1 >= argc) {
+            throw invalid_argument("    " + arg);
+        }
+        const string value = argv[++i];
+        if (arg == "--sizes") {
+            options.sizes.clear();
+            for (const string& item : splitList(value)) {
+                options.sizes.push_back(stoul(item));
+            }
+        }
+        else if (arg == "--max-size") {
+            maxSize = stoul(value);
+        }
+        else if (arg == "--types") {
+            options.types = splitList(value);
+        }
+        else if (arg == "--ops") {
+            options.ops = splitList(value);
+        }
+        else if (arg == "--min-runs") {
+            options.minRuns = max<size_t>(1, stoul(value));
+        }
+        else if (arg == "--max-runs") {
+            options.maxRuns = max<size_t>(1, stoul(value));
+        }
+        else if (arg == "--min-time") {
+            options.minTime = stod(value);
+        }
+        else if (arg == "--max-memory") {
+            options.maxMemoryMb = stoul(value);
+        }
+        else if (arg == "--format") {
+            options.format = value;
+        }
+        else if (arg == "--output") {
+            options.output = value;
+        }
+        else if (arg == "--threads") {
+            options.threads = stoul(value);
+        }
+        else {
+            throw invalid_argument("  " + arg);
+        }
+    }
+    if (maxSize != 0) {
+        options.sizes.erase(remove_if(options.sizes.begin(), options.sizes.end(), [&](size_t n) { return n > maxSize; }),
+            options.sizes.end());
+    }
+    if (options.format != "csv" && options.format != "json") {
+        throw invalid_argument("   csv  json");
+    }
+    return options;
+}
+
+
+int main(int argc, char* argv[]) {
+    try {
+        const BenchOptions options = parseOptions(argc, argv);
+        if (options.threads != 0) {
+            setThreadCount(options.threads);
+        }
+
+        vector<BenchResult> results;
+        for (const string& type : options.types) {
+            if (type == "float") {
+                benchType<float>(options, type, results);
+            }
+            else if (type == "double") {
+                benchType<double>(options, type, results);
+            }
+            else if (type == "complex") {
+                benchType<complex<double>>(options, type, results);
+            }
+            else {
+                throw invalid_argument(" : " + type);
+            }
+        }
+
+        ofstream file;
+        if (!options.output.empty()) {
+            file.open(options.output);
+            if (!file) {
+                throw runtime_error("    " + options.output);
+            }
+        }
+        ostream& os = options.output.empty() ? cout : file;
+        if (options.format == "json") {
+            writeJson(os, results);
+        }
+        else {
+            writeCsv(os, results);
+        }
+    }
+
+    catch (const std::exception& e) {
+        cerr << "Error: " << e.what() << endl;
+        return 1;
+    }
+
+    return 0;
+}
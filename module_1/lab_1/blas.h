@@ -0,0 +1,522 @@
+#pragma once
+
+#include <cstddef>
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include "cpu.h"
+#include "simd.h"
+#include "thread_pool.h"
+
+
+///  BLAS  1  2  "" : DOT, AXPY, NRM2, GEMV  GEMV  .
+///  float, double  std::complex<double>   SSE2/AVX2/AVX-512  CPUID,
+///    -  .       
+///  .          ,
+///  DOT  NRM2          .
+
+namespace detail {
+
+///     DOT/AXPY       GEMV
+inline constexpr size_t blasChunk = 1 << 16;
+
+///     GEMV  :  y   L1
+inline constexpr size_t blasColumnSlice = 1024;
+
+template<typename T>
+T conjugate(const T& x) {
+    return x;
+}
+
+template<typename R>
+std::complex<R> conjugate(const std::complex<R>& x) {
+    return std::conj(x);
+}
+
+///  :      
+template<typename T, bool Conj>
+inline T scalarDot(const T* x, const T* y, size_t n) {
+    T s0 = T(), s1 = T();
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        s0 += (Conj ? conjugate(x[i]) : x[i]) * y[i];
+        s1 += (Conj ? conjugate(x[i + 1]) : x[i + 1]) * y[i + 1];
+    }
+    if (i < n) {
+        s0 += (Conj ? conjugate(x[i]) : x[i]) * y[i];
+    }
+    return s0 + s1;
+}
+
+template<typename T>
+inline void scalarAxpy(T alpha, const T* x, T* y, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        y[i] += alpha * x[i];
+    }
+}
+
+#if MATRIX_X86_DISPATCH
+template<typename R, SimdLevel L>
+inline R reduceSum(const typename SimdOps<R, L>::V& v) {
+    using Ops = SimdOps<R, L>;
+    alignas(64) R lanes[Ops::W];
+    Ops::store(lanes, v);
+    R sum = R();
+    for (size_t i = 0; i < Ops::W; i++) {
+        sum += lanes[i];
+    }
+    return sum;
+}
+
+///  x[i] * y[i]    
+template<typename R, SimdLevel L>
+inline R simdDot(const R* x, const R* y, size_t n) {
+    using Ops = SimdOps<R, L>;
+    using V = typename Ops::V;
+    constexpr size_t W = Ops::W;
+    V a0, a1, a2, a3;
+    Ops::zero(a0);
+    Ops::zero(a1);
+    Ops::zero(a2);
+    Ops::zero(a3);
+    size_t i = 0;
+    for (; i + 4 * W <= n; i += 4 * W) {
+        V x0, x1, x2, x3, y0, y1, y2, y3;
+        Ops::load(x0, x + i);
+        Ops::load(x1, x + i + W);
+        Ops::load(x2, x + i + 2 * W);
+        Ops::load(x3, x + i + 3 * W);
+        Ops::load(y0, y + i);
+        Ops::load(y1, y + i + W);
+        Ops::load(y2, y + i + 2 * W);
+        Ops::load(y3, y + i + 3 * W);
+        Ops::fma(a0, x0, y0);
+        Ops::fma(a1, x1, y1);
+        Ops::fma(a2, x2, y2);
+        Ops::fma(a3, x3, y3);
+    }
+    for (; i + W <= n; i += W) {
+        V xv, yv;
+        Ops::load(xv, x + i);
+        Ops::load(yv, y + i);
+        Ops::fma(a0, xv, yv);
+    }
+    Ops::add(a0, a0, a1);
+    Ops::add(a2, a2, a3);
+    Ops::add(a0, a0, a2);
+    return reduceSum<R, L>(a0) + scalarDot<R, false>(x + i, y + i, n - i);
+}
+
+///       (re, im):
+/// direct = x * y  (xr yr, xi yi), cross = x * swap(y) (xr yi, xi yr).
+/// parts = {  direct,  direct,  cross,  cross}
+template<SimdLevel L>
+inline void simdComplexDotParts(const double* x, const double* y, size_t n, double* parts) {
+    using Ops = SimdOps<double, L>;
+    using V = typename Ops::V;
+    constexpr size_t W = Ops::W;
+    V d0, d1, c0, c1;
+    Ops::zero(d0);
+    Ops::zero(d1);
+    Ops::zero(c0);
+    Ops::zero(c1);
+    size_t i = 0;
+    for (; i + 2 * W <= 2 * n; i += 2 * W) {
+        V x0, x1, y0, y1, s0, s1;
+        Ops::load(x0, x + i);
+        Ops::load(x1, x + i + W);
+        Ops::load(y0, y + i);
+        Ops::load(y1, y + i + W);
+        Ops::swapPairs(s0, y0);
+        Ops::swapPairs(s1, y1);
+        Ops::fma(d0, x0, y0);
+        Ops::fma(d1, x1, y1);
+        Ops::fma(c0, x0, s0);
+        Ops::fma(c1, x1, s1);
+    }
+    Ops::add(d0, d0, d1);
+    Ops::add(c0, c0, c1);
+    alignas(64) double direct[W], cross[W];
+    Ops::store(direct, d0);
+    Ops::store(cross, c0);
+    parts[0] = parts[1] = parts[2] = parts[3] = 0;
+    for (size_t k = 0; k < W; k += 2) {
+        parts[0] += direct[k];
+        parts[1] += direct[k + 1];
+        parts[2] += cross[k];
+        parts[3] += cross[k + 1];
+    }
+    for (; i < 2 * n; i += 2) {
+        parts[0] += x[i] * y[i];
+        parts[1] += x[i + 1] * y[i + 1];
+        parts[2] += x[i] * y[i + 1];
+        parts[3] += x[i + 1] * y[i];
+    }
+}
+
+template<typename R, SimdLevel L>
+inline void simdAxpy(R alpha, const R* x, R* y, size_t n) {
+    using Ops = SimdOps<R, L>;
+    using V = typename Ops::V;
+    constexpr size_t W = Ops::W;
+    V av;
+    Ops::broadcast(av, alpha);
+    size_t i = 0;
+    for (; i + 2 * W <= n; i += 2 * W) {
+        V x0, x1, y0, y1;
+        Ops::load(x0, x + i);
+        Ops::load(x1, x + i + W);
+        Ops::load(y0, y + i);
+        Ops::load(y1, y + i + W);
+        Ops::fma(y0, x0, av);
+        Ops::fma(y1, x1, av);
+        Ops::store(y + i, y0);
+        Ops::store(y + i + W, y1);
+    }
+    for (; i + W <= n; i += W) {
+        V xv, yv;
+        Ops::load(xv, x + i);
+        Ops::load(yv, y + i);
+        Ops::fma(yv, xv, av);
+        Ops::store(y + i, yv);
+    }
+    scalarAxpy(alpha, x + i, y + i, n - i);
+}
+
+/// y += alpha * x   (re, im): alpha * x = fmaddsub(x, ar, swap(x) * ai)
+template<SimdLevel L>
+inline void simdComplexAxpy(std::complex<double> alpha, const double* x, double* y, size_t n) {
+    using Ops = SimdOps<double, L>;
+    using V = typename Ops::V;
+    constexpr size_t W = Ops::W;
+    V ar, ai;
+    Ops::broadcast(ar, alpha.real());
+    Ops::broadcast(ai, alpha.imag());
+    size_t i = 0;
+    for (; i + W <= 2 * n; i += W) {
+        V xv, yv, swapped, cross, product;
+        Ops::load(xv, x + i);
+        Ops::load(yv, y + i);
+        Ops::swapPairs(swapped, xv);
+        Ops::mul(cross, swapped, ai);
+        Ops::fmaddsub(product, xv, ar, cross);
+        Ops::add(yv, yv, product);
+        Ops::store(y + i, yv);
+    }
+    scalarAxpy(alpha, reinterpret_cast<const std::complex<double>*>(x) + i / 2,
+        reinterpret_cast<std::complex<double>*>(y) + i / 2, n - i / 2);
+}
+
+///   A  x  : x      
+template<typename R, SimdLevel L>
+inline void simdDot4(size_t n, const R* a, size_t lda, const R* x, R* sums) {
+    using Ops = SimdOps<R, L>;
+    using V = typename Ops::V;
+    constexpr size_t W = Ops::W;
+    V a0, a1, a2, a3;
+    Ops::zero(a0);
+    Ops::zero(a1);
+    Ops::zero(a2);
+    Ops::zero(a3);
+    const R* r0 = a;
+    const R* r1 = a + lda;
+    const R* r2 = a + 2 * lda;
+    const R* r3 = a + 3 * lda;
+    size_t j = 0;
+    for (; j + W <= n; j += W) {
+        V xv, v0, v1, v2, v3;
+        Ops::load(xv, x + j);
+        Ops::load(v0, r0 + j);
+        Ops::load(v1, r1 + j);
+        Ops::load(v2, r2 + j);
+        Ops::load(v3, r3 + j);
+        Ops::fma(a0, v0, xv);
+        Ops::fma(a1, v1, xv);
+        Ops::fma(a2, v2, xv);
+        Ops::fma(a3, v3, xv);
+    }
+    sums[0] = reduceSum<R, L>(a0) + scalarDot<R, false>(r0 + j, x + j, n - j);
+    sums[1] = reduceSum<R, L>(a1) + scalarDot<R, false>(r1 + j, x + j, n - j);
+    sums[2] = reduceSum<R, L>(a2) + scalarDot<R, false>(r2 + j, x + j, n - j);
+    sums[3] = reduceSum<R, L>(a3) + scalarDot<R, false>(r3 + j, x + j, n - j);
+}
+#endif
+
+///       L   
+#if MATRIX_X86_DISPATCH && defined(__SSE2__)
+template<SimdLevel L>
+inline constexpr bool blasVectorLevel = true;
+#elif MATRIX_X86_DISPATCH
+template<SimdLevel L>
+inline constexpr bool blasVectorLevel = L != SimdLevel::Generic;
+#else
+template<SimdLevel L>
+inline constexpr bool blasVectorLevel = false;
+#endif
+
+template<typename T, SimdLevel L>
+inline constexpr bool blasRealVector = blasVectorLevel<L> && (std::is_same_v<T, float> || std::is_same_v<T, double>);
+
+template<typename T, SimdLevel L>
+inline constexpr bool blasComplexVector = blasVectorLevel<L> && std::is_same_v<T, std::complex<double>>;
+
+template<typename T, SimdLevel L, bool Conj>
+T dotImpl(const T* x, const T* y, size_t n) {
+#if MATRIX_X86_DISPATCH
+    if constexpr (blasRealVector<T, L>) {
+        return simdDot<T, L>(x, y, n);
+    }
+    if constexpr (blasComplexVector<T, L>) {
+        double p[4];
+        simdComplexDotParts<L>(reinterpret_cast<const double*>(x), reinterpret_cast<const double*>(y), n, p);
+        // dot:  re = xr yr - xi yi, im = xr yi + xi yr
+        // dotc: re = xr yr + xi yi, im = xr yi - xi yr
+        return Conj ? T(p[0] + p[1], p[2] - p[3]) : T(p[0] - p[1], p[2] + p[3]);
+    }
+#endif
+    return scalarDot<T, Conj>(x, y, n);
+}
+
+template<typename T, SimdLevel L>
+void axpyImpl(T alpha, const T* x, T* y, size_t n) {
+#if MATRIX_X86_DISPATCH
+    if constexpr (blasRealVector<T, L>) {
+        simdAxpy<T, L>(alpha, x, y, n);
+        return;
+    }
+    if constexpr (blasComplexVector<T, L>) {
+        simdComplexAxpy<L>(alpha, reinterpret_cast<const double*>(x), reinterpret_cast<double*>(y), n);
+        return;
+    }
+#endif
+    scalarAxpy(alpha, x, y, n);
+}
+
+/// y[i * incy] = alpha * (A x)[i] + beta * y[i * incy]   [0, m);  beta == 0 y  
+template<typename T, SimdLevel L>
+void gemvRowsImpl(size_t m, size_t n, T alpha, const T* a, size_t lda, const T* x, T beta, T* y, size_t incy) {
+    auto store = [&](size_t i, T sum) {
+        T& out = y[i * incy];
+        out = beta == T() ? alpha * sum : alpha * sum + beta * out;
+    };
+    size_t i = 0;
+#if MATRIX_X86_DISPATCH
+    if constexpr (blasRealVector<T, L>) {
+        for (; i + 4 <= m; i += 4) {
+            T sums[4];
+            simdDot4<T, L>(n, a + i * lda, lda, x, sums);
+            for (size_t r = 0; r < 4; r++) {
+                store(i + r, sums[r]);
+            }
+        }
+    }
+#endif
+    for (; i < m; i++) {
+        store(i, dotImpl<T, L, false>(a + i * lda, x, n));
+    }
+}
+
+/// y[c0, c1) = alpha * (A^T x)[c0, c1) + beta * y[c0, c1):  A    y
+template<typename T, SimdLevel L>
+void gemvColumnsImpl(size_t m, T alpha, const T* a, size_t lda, const T* x, T beta, T* y, size_t c0, size_t c1) {
+    T* slice = y + c0;
+    const size_t width = c1 - c0;
+    if (beta == T()) {
+        std::fill(slice, slice + width, T());
+    }
+    else if (beta != T(1)) {
+        for (size_t j = 0; j < width; j++) {
+            slice[j] *= beta;
+        }
+    }
+    for (size_t i = 0; i < m; i++) {
+        const T s = alpha * x[i];
+        if (s != T()) {
+            axpyImpl<T, L>(s, a + i * lda + c0, slice, width);
+        }
+    }
+}
+
+template<typename T, SimdLevel L>
+struct BlasKernels {
+    static T dot(const T* x, const T* y, size_t n) { return dotImpl<T, L, false>(x, y, n); }
+    static T dotc(const T* x, const T* y, size_t n) { return dotImpl<T, L, true>(x, y, n); }
+    static void axpy(T alpha, const T* x, T* y, size_t n) { axpyImpl<T, L>(alpha, x, y, n); }
+    static void gemvRows(size_t m, size_t n, T alpha, const T* a, size_t lda, const T* x, T beta, T* y, size_t incy) {
+        gemvRowsImpl<T, L>(m, n, alpha, a, lda, x, beta, y, incy);
+    }
+    static void gemvColumns(size_t m, T alpha, const T* a, size_t lda, const T* x, T beta, T* y, size_t c0, size_t c1) {
+        gemvColumnsImpl<T, L>(m, alpha, a, lda, x, beta, y, c0, c1);
+    }
+};
+
+#if MATRIX_X86_DISPATCH
+template<typename T>
+struct BlasKernels<T, SimdLevel::Avx2> {
+    MATRIX_TARGET("avx2,fma") MATRIX_FLATTEN
+    static T dot(const T* x, const T* y, size_t n) { return dotImpl<T, SimdLevel::Avx2, false>(x, y, n); }
+    MATRIX_TARGET("avx2,fma") MATRIX_FLATTEN
+    static T dotc(const T* x, const T* y, size_t n) { return dotImpl<T, SimdLevel::Avx2, true>(x, y, n); }
+    MATRIX_TARGET("avx2,fma") MATRIX_FLATTEN
+    static void axpy(T alpha, const T* x, T* y, size_t n) { axpyImpl<T, SimdLevel::Avx2>(alpha, x, y, n); }
+    MATRIX_TARGET("avx2,fma") MATRIX_FLATTEN
+    static void gemvRows(size_t m, size_t n, T alpha, const T* a, size_t lda, const T* x, T beta, T* y, size_t incy) {
+        gemvRowsImpl<T, SimdLevel::Avx2>(m, n, alpha, a, lda, x, beta, y, incy);
+    }
+    MATRIX_TARGET("avx2,fma") MATRIX_FLATTEN
+    static void gemvColumns(size_t m, T alpha, const T* a, size_t lda, const T* x, T beta, T* y, size_t c0, size_t c1) {
+        gemvColumnsImpl<T, SimdLevel::Avx2>(m, alpha, a, lda, x, beta, y, c0, c1);
+    }
+};
+
+template<typename T>
+struct BlasKernels<T, SimdLevel::Avx512> {
+    MATRIX_TARGET("avx512f") MATRIX_FLATTEN
+    static T dot(const T* x, const T* y, size_t n) { return dotImpl<T, SimdLevel::Avx512, false>(x, y, n); }
+    MATRIX_TARGET("avx512f") MATRIX_FLATTEN
+    static T dotc(const T* x, const T* y, size_t n) { return dotImpl<T, SimdLevel::Avx512, true>(x, y, n); }
+    MATRIX_TARGET("avx512f") MATRIX_FLATTEN
+    static void axpy(T alpha, const T* x, T* y, size_t n) { axpyImpl<T, SimdLevel::Avx512>(alpha, x, y, n); }
+    MATRIX_TARGET("avx512f") MATRIX_FLATTEN
+    static void gemvRows(size_t m, size_t n, T alpha, const T* a, size_t lda, const T* x, T beta, T* y, size_t incy) {
+        gemvRowsImpl<T, SimdLevel::Avx512>(m, n, alpha, a, lda, x, beta, y, incy);
+    }
+    MATRIX_TARGET("avx512f") MATRIX_FLATTEN
+    static void gemvColumns(size_t m, T alpha, const T* a, size_t lda, const T* x, T beta, T* y, size_t c0, size_t c1) {
+        gemvColumnsImpl<T, SimdLevel::Avx512>(m, alpha, a, lda, x, beta, y, c0, c1);
+    }
+};
+#endif
+
+///  f     
+template<typename T, typename F>
+decltype(auto) withBlasKernels(F&& f) {
+    switch (simdLevel()) {
+    case SimdLevel::Avx512:
+        return f(BlasKernels<T, SimdLevel::Avx512>());
+    case SimdLevel::Avx2:
+        return f(BlasKernels<T, SimdLevel::Avx2>());
+    default:
+        return f(BlasKernels<T, SimdLevel::Generic>());
+    }
+}
+
+template<typename T, bool Conj>
+T dotChunked(const T* x, const T* y, size_t n) {
+    const size_t chunks = std::max<size_t>(1, (n + blasChunk - 1) / blasChunk);
+    auto part = [&](size_t c) {
+        const size_t i0 = c * blasChunk;
+        const size_t len = std::min(n - std::min(n, i0), blasChunk);
+        return withBlasKernels<T>([&](auto kernels) {
+            return Conj ? kernels.dotc(x + i0, y + i0, len) : kernels.dot(x + i0, y + i0, len);
+        });
+    };
+    if (chunks == 1) {
+        return part(0);
+    }
+    std::vector<T> partial(chunks);
+    parallelFor(chunks, [&](size_t c) {
+        partial[c] = part(c);
+    });
+    T sum = T();
+    for (const T& p : partial) {
+        sum += p;
+    }
+    return sum;
+}
+
+///       NRM2
+template<typename T>
+double blasMagnitude(const T& x) {
+    return static_cast<double>(std::abs(x));
+}
+
+} // namespace detail
+
+
+/// sum x[i] * y[i] (  -  ,  ?DOTU)
+template<typename T>
+T blasDot(const T* x, const T* y, size_t n) {
+    return detail::dotChunked<T, false>(x, y, n);
+}
+
+/// sum conj(x[i]) * y[i] (    blasDot)
+template<typename T>
+T blasDotc(const T* x, const T* y, size_t n) {
+    return detail::dotChunked<T, true>(x, y, n);
+}
+
+/// y += alpha * x
+template<typename T>
+void blasAxpy(T alpha, const T* x, T* y, size_t n) {
+    const size_t chunks = std::max<size_t>(1, (n + detail::blasChunk - 1) / detail::blasChunk);
+    parallelFor(chunks, [&](size_t c) {
+        const size_t i0 = c * detail::blasChunk;
+        const size_t len = std::min(n - std::min(n, i0), detail::blasChunk);
+        detail::withBlasKernels<T>([&](auto kernels) {
+            kernels.axpy(alpha, x + i0, y + i0, len);
+        });
+    });
+}
+
+///   ||x||_2.     DOT;   
+///    , x   max |x[i]| (  ?NRM2)
+template<typename T>
+auto blasNrm2(const T* x, size_t n) {
+    using R = decltype(std::abs(T()));
+    const double sum = static_cast<double>(std::real(blasDotc(x, x, n)));
+    if (std::isfinite(sum) && sum >= std::numeric_limits<R>::min() / std::numeric_limits<R>::epsilon()) {
+        return static_cast<R>(std::sqrt(sum));
+    }
+    double scale = 0;
+    for (size_t i = 0; i < n; i++) {
+        scale = std::max(scale, detail::blasMagnitude(x[i]));
+    }
+    if (scale == 0 || !std::isfinite(scale)) {
+        return static_cast<R>(scale);
+    }
+    double scaled = 0;
+    for (size_t i = 0; i < n; i++) {
+        const double v = detail::blasMagnitude(x[i]) / scale;
+        scaled += v * v;
+    }
+    return static_cast<R>(scale * std::sqrt(scaled));
+}
+
+/// y = alpha * A * x + beta * y, A: m x n     lda;  beta == 0 y  
+template<typename T>
+void blasGemv(size_t m, size_t n, T alpha, const T* a, size_t lda, const T* x, T beta, T* y, size_t incy = 1) {
+    if (m == 0) {
+        return;
+    }
+    const size_t rowsPerTask = std::max<size_t>(4, detail::blasChunk / std::max<size_t>(n, 1) / 4 * 4);
+    const size_t tasks = (m + rowsPerTask - 1) / rowsPerTask;
+    parallelFor(tasks, [&](size_t t) {
+        const size_t r0 = t * rowsPerTask;
+        const size_t rows = std::min(m, r0 + rowsPerTask) - r0;
+        detail::withBlasKernels<T>([&](auto kernels) {
+            kernels.gemvRows(rows, n, alpha, a + r0 * lda, lda, x, beta, y + r0 * incy, incy);
+        });
+    });
+}
+
+/// y = alpha * A^T * x + beta * y, A: m x n (x - m , y - n). A   :
+///        y      A
+template<typename T>
+void blasGemvTransposed(size_t m, size_t n, T alpha, const T* a, size_t lda, const T* x, T beta, T* y) {
+    if (n == 0) {
+        return;
+    }
+    const size_t slices = (n + detail::blasColumnSlice - 1) / detail::blasColumnSlice;
+    parallelFor(slices, [&](size_t s) {
+        const size_t c0 = s * detail::blasColumnSlice;
+        const size_t c1 = std::min(n, c0 + detail::blasColumnSlice);
+        detail::withBlasKernels<T>([&](auto kernels) {
+            kernels.gemvColumns(m, alpha, a, lda, x, beta, y, c0, c1);
+        });
+    });
+}
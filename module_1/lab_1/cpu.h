@@ -0,0 +1,162 @@
+#pragma once
+
+#include <cstddef>
+
+///   SIMD-    .
+///      ( target),    CPUID.
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define MATRIX_X86_DISPATCH 1
+#define MATRIX_TARGET(isa) __attribute__((target(isa)))
+#define MATRIX_FLATTEN __attribute__((flatten))
+#include <immintrin.h>
+#else
+#define MATRIX_X86_DISPATCH 0
+#define MATRIX_TARGET(isa)
+#define MATRIX_FLATTEN
+#endif
+
+
+///   SIMD
+enum class SimdLevel {
+    Generic,  // SSE2   
+    Avx2,     // AVX2 + FMA
+    Avx512    // AVX-512F
+};
+
+inline SimdLevel detectSimdLevel() {
+#if MATRIX_X86_DISPATCH
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        return SimdLevel::Avx512;
+    }
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        return SimdLevel::Avx2;
+    }
+#endif
+    return SimdLevel::Generic;
+}
+
+///  SIMD   (  )
+inline SimdLevel simdLevel() {
+    static const SimdLevel level = detectSimdLevel();
+    return level;
+}
+
+
+///    : V - , W -    .
+///     ; ,   , 
+///     target  MATRIX_FLATTEN,      .
+///    :   (-O0)   
+///   target        .
+template<typename T, SimdLevel L>
+struct SimdOps;
+
+#if MATRIX_X86_DISPATCH && defined(__SSE2__)
+/// SSE2     x86-64,  Generic  x86  
+template<>
+struct SimdOps<double, SimdLevel::Generic> {
+    using V = __m128d;
+    static constexpr size_t W = 2;
+    static void zero(V& r) { r = _mm_setzero_pd(); }
+    static void broadcast(V& r, double x) { r = _mm_set1_pd(x); }
+    static void load(V& r, const double* p) { r = _mm_loadu_pd(p); }
+    static void store(double* p, const V& v) { _mm_storeu_pd(p, v); }
+    static void add(V& r, const V& a, const V& b) { r = _mm_add_pd(a, b); }
+    static void sub(V& r, const V& a, const V& b) { r = _mm_sub_pd(a, b); }
+    static void mul(V& r, const V& a, const V& b) { r = _mm_mul_pd(a, b); }
+    static void div(V& r, const V& a, const V& b) { r = _mm_div_pd(a, b); }
+    /// r += a * b
+    static void fma(V& r, const V& a, const V& b) { r = _mm_add_pd(r, _mm_mul_pd(a, b)); }
+    ///    (re, im) -> (im, re)
+    static void swapPairs(V& r, const V& a) { r = _mm_shuffle_pd(a, a, 1); }
+    /// r = a * b - c     a * b + c  
+    static void fmaddsub(V& r, const V& a, const V& b, const V& c) { r = _mm_add_pd(_mm_mul_pd(a, b), _mm_xor_pd(c, _mm_set_pd(0.0, -0.0))); }
+};
+
+template<>
+struct SimdOps<float, SimdLevel::Generic> {
+    using V = __m128;
+    static constexpr size_t W = 4;
+    static void zero(V& r) { r = _mm_setzero_ps(); }
+    static void broadcast(V& r, float x) { r = _mm_set1_ps(x); }
+    static void load(V& r, const float* p) { r = _mm_loadu_ps(p); }
+    static void store(float* p, const V& v) { _mm_storeu_ps(p, v); }
+    static void add(V& r, const V& a, const V& b) { r = _mm_add_ps(a, b); }
+    static void sub(V& r, const V& a, const V& b) { r = _mm_sub_ps(a, b); }
+    static void mul(V& r, const V& a, const V& b) { r = _mm_mul_ps(a, b); }
+    static void div(V& r, const V& a, const V& b) { r = _mm_div_ps(a, b); }
+    /// r += a * b
+    static void fma(V& r, const V& a, const V& b) { r = _mm_add_ps(r, _mm_mul_ps(a, b)); }
+};
+#endif
+
+#if MATRIX_X86_DISPATCH
+template<>
+struct SimdOps<double, SimdLevel::Avx2> {
+    using V = __m256d;
+    static constexpr size_t W = 4;
+    MATRIX_TARGET("avx2,fma") static void zero(V& r) { r = _mm256_setzero_pd(); }
+    MATRIX_TARGET("avx2,fma") static void broadcast(V& r, double x) { r = _mm256_set1_pd(x); }
+    MATRIX_TARGET("avx2,fma") static void load(V& r, const double* p) { r = _mm256_loadu_pd(p); }
+    MATRIX_TARGET("avx2,fma") static void store(double* p, const V& v) { _mm256_storeu_pd(p, v); }
+    MATRIX_TARGET("avx2,fma") static void add(V& r, const V& a, const V& b) { r = _mm256_add_pd(a, b); }
+    MATRIX_TARGET("avx2,fma") static void sub(V& r, const V& a, const V& b) { r = _mm256_sub_pd(a, b); }
+    MATRIX_TARGET("avx2,fma") static void mul(V& r, const V& a, const V& b) { r = _mm256_mul_pd(a, b); }
+    MATRIX_TARGET("avx2,fma") static void div(V& r, const V& a, const V& b) { r = _mm256_div_pd(a, b); }
+    /// r += a * b
+    MATRIX_TARGET("avx2,fma") static void fma(V& r, const V& a, const V& b) { r = _mm256_fmadd_pd(a, b, r); }
+    MATRIX_TARGET("avx2,fma") static void swapPairs(V& r, const V& a) { r = _mm256_permute_pd(a, 0x5); }
+    MATRIX_TARGET("avx2,fma") static void fmaddsub(V& r, const V& a, const V& b, const V& c) { r = _mm256_fmaddsub_pd(a, b, c); }
+};
+
+template<>
+struct SimdOps<float, SimdLevel::Avx2> {
+    using V = __m256;
+    static constexpr size_t W = 8;
+    MATRIX_TARGET("avx2,fma") static void zero(V& r) { r = _mm256_setzero_ps(); }
+    MATRIX_TARGET("avx2,fma") static void broadcast(V& r, float x) { r = _mm256_set1_ps(x); }
+    MATRIX_TARGET("avx2,fma") static void load(V& r, const float* p) { r = _mm256_loadu_ps(p); }
+    MATRIX_TARGET("avx2,fma") static void store(float* p, const V& v) { _mm256_storeu_ps(p, v); }
+    MATRIX_TARGET("avx2,fma") static void add(V& r, const V& a, const V& b) { r = _mm256_add_ps(a, b); }
+    MATRIX_TARGET("avx2,fma") static void sub(V& r, const V& a, const V& b) { r = _mm256_sub_ps(a, b); }
+    MATRIX_TARGET("avx2,fma") static void mul(V& r, const V& a, const V& b) { r = _mm256_mul_ps(a, b); }
+    MATRIX_TARGET("avx2,fma") static void div(V& r, const V& a, const V& b) { r = _mm256_div_ps(a, b); }
+    /// r += a * b
+    MATRIX_TARGET("avx2,fma") static void fma(V& r, const V& a, const V& b) { r = _mm256_fmadd_ps(a, b, r); }
+};
+
+template<>
+struct SimdOps<double, SimdLevel::Avx512> {
+    using V = __m512d;
+    static constexpr size_t W = 8;
+    MATRIX_TARGET("avx512f") static void zero(V& r) { r = _mm512_setzero_pd(); }
+    MATRIX_TARGET("avx512f") static void broadcast(V& r, double x) { r = _mm512_set1_pd(x); }
+    MATRIX_TARGET("avx512f") static void load(V& r, const double* p) { r = _mm512_loadu_pd(p); }
+    MATRIX_TARGET("avx512f") static void store(double* p, const V& v) { _mm512_storeu_pd(p, v); }
+    MATRIX_TARGET("avx512f") static void add(V& r, const V& a, const V& b) { r = _mm512_add_pd(a, b); }
+    MATRIX_TARGET("avx512f") static void sub(V& r, const V& a, const V& b) { r = _mm512_sub_pd(a, b); }
+    MATRIX_TARGET("avx512f") static void mul(V& r, const V& a, const V& b) { r = _mm512_mul_pd(a, b); }
+    MATRIX_TARGET("avx512f") static void div(V& r, const V& a, const V& b) { r = _mm512_div_pd(a, b); }
+    /// r += a * b
+    MATRIX_TARGET("avx512f") static void fma(V& r, const V& a, const V& b) { r = _mm512_fmadd_pd(a, b, r); }
+    MATRIX_TARGET("avx512f") static void swapPairs(V& r, const V& a) { r = _mm512_shuffle_pd(a, a, 0x55); }
+    MATRIX_TARGET("avx512f") static void fmaddsub(V& r, const V& a, const V& b, const V& c) { r = _mm512_fmaddsub_pd(a, b, c); }
+};
+
+template<>
+struct SimdOps<float, SimdLevel::Avx512> {
+    using V = __m512;
+    static constexpr size_t W = 16;
+    MATRIX_TARGET("avx512f") static void zero(V& r) { r = _mm512_setzero_ps(); }
+    MATRIX_TARGET("avx512f") static void broadcast(V& r, float x) { r = _mm512_set1_ps(x); }
+    MATRIX_TARGET("avx512f") static void load(V& r, const float* p) { r = _mm512_loadu_ps(p); }
+    MATRIX_TARGET("avx512f") static void store(float* p, const V& v) { _mm512_storeu_ps(p, v); }
+    MATRIX_TARGET("avx512f") static void add(V& r, const V& a, const V& b) { r = _mm512_add_ps(a, b); }
+    MATRIX_TARGET("avx512f") static void sub(V& r, const V& a, const V& b) { r = _mm512_sub_ps(a, b); }
+    MATRIX_TARGET("avx512f") static void mul(V& r, const V& a, const V& b) { r = _mm512_mul_ps(a, b); }
+    MATRIX_TARGET("avx512f") static void div(V& r, const V& a, const V& b) { r = _mm512_div_ps(a, b); }
+    /// r += a * b
+    MATRIX_TARGET("avx512f") static void fma(V& r, const V& a, const V& b) { r = _mm512_fmadd_ps(a, b, r); }
+};
+#endif
@@ -0,0 +1,281 @@
+#pragma once
+
+#include <cstddef>
+#include <algorithm>
+#include <complex>
+#include <cstring>
+#include <iomanip>
+#include <initializer_list>
+#include <iostream>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "blas.h"
+#include "matrix.h"
+#include "matrix_arena.h"
+
+
+///       (    ,   Matrix)
+///   BLAS  1  2  Vector  Matrix: dot, dotc, axpy, nrm2, gemv,
+/// gemvTransposed, A * x.     -  blas.h.
+template<typename T>
+class Vector {
+    static_assert(std::is_trivially_copyable_v<T>, "     ");
+
+public:
+    using value_type = T;
+
+    ///   ,   
+    struct Uninitialized {};
+
+private:
+    size_t length;
+    T* data;
+
+    static T* allocate(size_t length) {
+        if (length == 0) {
+            return nullptr;
+        }
+        if (length > SIZE_MAX / sizeof(T)) {
+            throw std::length_error("   ");
+        }
+        return static_cast<T*>(detail::matrixAllocate(length * sizeof(T)));
+    }
+
+public:
+    Vector() : length(0), data(nullptr) {}
+
+    Vector(size_t length, Uninitialized) : length(length), data(allocate(length)) {}
+
+    explicit Vector(size_t length, T value = T()) : Vector(length, Uninitialized{}) {
+        std::fill_n(data, length, value);
+    }
+
+    Vector(std::initializer_list<T> values) : Vector(values.size(), Uninitialized{}) {
+        std::copy(values.begin(), values.end(), data);
+    }
+
+    Vector(const Vector& other) : Vector(other.length, Uninitialized{}) {
+        if (length != 0) {
+            std::memcpy(data, other.data, length * sizeof(T));
+        }
+    }
+
+    Vector(Vector&& other) noexcept
+        : length(std::exchange(other.length, 0)), data(std::exchange(other.data, nullptr)) {}
+
+    ~Vector() {
+        detail::matrixDeallocate(data);
+    }
+
+    ///  :     
+    Vector& operator=(const Vector& other) {
+        if (this == &other) {
+            return *this;
+        }
+        if (length == other.length) {
+            if (length != 0) {
+                std::memcpy(data, other.data, length * sizeof(T));
+            }
+            return *this;
+        }
+        Vector copy(other);
+        swap(*this, copy);
+        return *this;
+    }
+
+    Vector& operator=(Vector&& other) noexcept {
+        if (this != &other) {
+            detail::matrixDeallocate(data);
+            length = std::exchange(other.length, 0);
+            data = std::exchange(other.data, nullptr);
+        }
+        return *this;
+    }
+
+    friend void swap(Vector& a, Vector& b) noexcept {
+        std::swap(a.length, b.length);
+        std::swap(a.data, b.data);
+    }
+
+    T& operator[](size_t i) {
+        if (i >= length) {
+            throw std::out_of_range("  ");
+        }
+        return data[i];
+    }
+
+    const T& operator[](size_t i) const {
+        if (i >= length) {
+            throw std::out_of_range("  ");
+        }
+        return data[i];
+    }
+
+    size_t size() const {
+        return length;
+    }
+
+    T* getData() {
+        return data;
+    }
+
+    const T* getData() const {
+        return data;
+    }
+
+    T* begin() {
+        return data;
+    }
+
+    T* end() {
+        return data + length;
+    }
+
+    const T* begin() const {
+        return data;
+    }
+
+    const T* end() const {
+        return data + length;
+    }
+
+    void fill(T value) {
+        std::fill_n(data, length, value);
+    }
+
+    Vector& operator+=(const Vector& other) {
+        if (length != other.length) {
+            throw std::invalid_argument("    ");
+        }
+        simdAdd(data, other.data, data, length);
+        return *this;
+    }
+
+    Vector& operator-=(const Vector& other) {
+        if (length != other.length) {
+            throw std::invalid_argument("    ");
+        }
+        simdSub(data, other.data, data, length);
+        return *this;
+    }
+
+    Vector& operator*=(T scalar) {
+        simdScale(data, scalar, data, length);
+        return *this;
+    }
+
+    Vector& operator/=(T scalar) {
+        if (scalar == T()) {
+            throw std::invalid_argument("  ");
+        }
+        simdDivide(data, scalar, data, length);
+        return *this;
+    }
+
+    friend Vector operator+(Vector left, const Vector& right) {
+        left += right;
+        return left;
+    }
+
+    friend Vector operator-(Vector left, const Vector& right) {
+        left -= right;
+        return left;
+    }
+
+    friend Vector operator*(Vector vector, T scalar) {
+        vector *= scalar;
+        return vector;
+    }
+
+    friend Vector operator*(T scalar, Vector vector) {
+        vector *= scalar;
+        return vector;
+    }
+
+    friend Vector operator/(Vector vector, T scalar) {
+        vector /= scalar;
+        return vector;
+    }
+
+    friend std::ostream& operator<<(std::ostream& os, const Vector& vector) {
+        for (size_t i = 0; i < vector.length; i++) {
+            os << std::setw(10) << vector.data[i] << ' ';
+        }
+        return os << std::endl;
+    }
+};
+
+
+namespace detail {
+
+template<typename T>
+void checkSameLength(const Vector<T>& x, const Vector<T>& y) {
+    if (x.size() != y.size()) {
+        throw std::invalid_argument("    ");
+    }
+}
+
+} // namespace detail
+
+/// sum x[i] * y[i]
+template<typename T>
+T dot(const Vector<T>& x, const Vector<T>& y) {
+    detail::checkSameLength(x, y);
+    return blasDot(x.getData(), y.getData(), x.size());
+}
+
+/// sum conj(x[i]) * y[i]
+template<typename T>
+T dotc(const Vector<T>& x, const Vector<T>& y) {
+    detail::checkSameLength(x, y);
+    return blasDotc(x.getData(), y.getData(), x.size());
+}
+
+/// y += alpha * x
+template<typename T>
+void axpy(T alpha, const Vector<T>& x, Vector<T>& y) {
+    detail::checkSameLength(x, y);
+    blasAxpy(alpha, x.getData(), y.getData(), x.size());
+}
+
+/// ||x||_2
+template<typename T>
+auto nrm2(const Vector<T>& x) {
+    return blasNrm2(x.getData(), x.size());
+}
+
+/// y = alpha * A * x + beta * y
+template<typename T>
+void gemv(T alpha, const Matrix<T>& a, const Vector<T>& x, T beta, Vector<T>& y) {
+    if (a.getCols() != x.size() || a.getRows() != y.size()) {
+        throw std::invalid_argument("     ");
+    }
+    blasGemv(a.getRows(), a.getCols(), alpha, a.getData(), a.getStride(), x.getData(), beta, y.getData());
+}
+
+/// y = alpha * A^T * x + beta * y (  A)
+template<typename T>
+void gemvTransposed(T alpha, const Matrix<T>& a, const Vector<T>& x, T beta, Vector<T>& y) {
+    if (a.getRows() != x.size() || a.getCols() != y.size()) {
+        throw std::invalid_argument("     ");
+    }
+    blasGemvTransposed(a.getRows(), a.getCols(), alpha, a.getData(), a.getStride(), x.getData(), beta, y.getData());
+}
+
+/// A * x
+template<typename T>
+Vector<T> operator*(const Matrix<T>& a, const Vector<T>& x) {
+    Vector<T> y(a.getRows(), typename Vector<T>::Uninitialized{});
+    gemv(T(1), a, x, T(), y);
+    return y;
+}
+
+/// x^T * A = A^T * x
+template<typename T>
+Vector<T> operator*(const Vector<T>& x, const Matrix<T>& a) {
+    Vector<T> y(a.getCols(), typename Vector<T>::Uninitialized{});
+    gemvTransposed(T(1), a, x, T(), y);
+    return y;
+}
@@ -0,0 +1,364 @@
+#pragma once
+
+#include <cstddef>
+#include <algorithm>
+#include <array>
+#include <complex>
+#include <initializer_list>
+#include <iostream>
+#include <iomanip>
+#include <stdexcept>
+#include <utility>
+
+#include "matrix.h"
+
+
+///    R x C:      ( ),
+///   constexpr,     2x2  3x3  .
+///       ,   Matrix<T>  .
+
+namespace detail {
+
+///     ,   constexpr (  -  )
+template<typename T>
+constexpr auto fixedMagnitude(const T& x) {
+    if constexpr (is_complex<T>::value) {
+        return std::norm(x);
+    }
+    else {
+        return x < T() ? -x : x;
+    }
+}
+
+} // namespace detail
+
+
+template<typename T, size_t R, size_t C>
+class FixedMatrix {
+    static_assert(R > 0 && C > 0, "    ");
+
+    template<typename, size_t, size_t>
+    friend class FixedMatrix;
+
+public:
+    using value_type = T;
+
+private:
+    std::array<T, R * C> data;
+
+    template<size_t K, size_t I, size_t J, size_t... P>
+    constexpr T dot(const FixedMatrix<T, C, K>& other, std::index_sequence<P...>) const {
+        return ((data[I * C + P] * other.data[P * K + J]) + ...);
+    }
+
+    template<size_t K, size_t... Idx>
+    constexpr void multiplyInto(const FixedMatrix<T, C, K>& other, FixedMatrix<T, R, K>& result, std::index_sequence<Idx...>) const {
+        ((result.data[Idx] = dot<K, Idx / K, Idx % K>(other, std::make_index_sequence<C>{})), ...);
+    }
+
+public:
+    static constexpr T epsilon = static_cast<T>(1e-5);
+
+    ///  
+    constexpr FixedMatrix() : data{} {}
+
+    /// ,  
+    constexpr explicit FixedMatrix(T value) : data{} {
+        data.fill(value);
+    }
+
+    ///   : FixedMatrix<double, 2, 2>{1, 2, 3, 4}
+    constexpr FixedMatrix(std::initializer_list<T> values) : data{} {
+        if (values.size() != R * C) {
+            throw std::invalid_argument("      ");
+        }
+        std::copy(values.begin(), values.end(), data.begin());
+    }
+
+    ///      
+    explicit FixedMatrix(const Matrix<T>& matrix) : data{} {
+        if (matrix.getRows() != R || matrix.getCols() != C) {
+            throw std::invalid_argument("     ");
+        }
+        for (size_t i = 0; i < R; i++) {
+            std::copy_n(matrix.getData() + i * matrix.getStride(), C, data.begin() + i * C);
+        }
+    }
+
+    ///    
+    Matrix<T> toMatrix() const {
+        Matrix<T> result(R, C, typename Matrix<T>::Uninitialized{});
+        for (size_t i = 0; i < R; i++) {
+            std::copy_n(data.begin() + i * C, C, result.getData() + i * result.getStride());
+        }
+        return result;
+    }
+
+    ///  
+    static constexpr FixedMatrix identity() requires (R == C) {
+        FixedMatrix result;
+        for (size_t i = 0; i < R; i++) {
+            result.data[i * C + i] = T(1);
+        }
+        return result;
+    }
+
+    ///  ()  /     
+    constexpr T& operator()(size_t row, size_t col) {
+        if (row >= R || col >= C) {
+            throw std::out_of_range("  ");
+        }
+        return data[row * C + col];
+    }
+
+    constexpr const T& operator()(size_t row, size_t col) const {
+        if (row >= R || col >= C) {
+            throw std::out_of_range("  ");
+        }
+        return data[row * C + col];
+    }
+
+    ///     ,     
+    template<size_t I, size_t J>
+    constexpr T& get() {
+        static_assert(I < R && J < C, "  ");
+        return data[I * C + J];
+    }
+
+    template<size_t I, size_t J>
+    constexpr const T& get() const {
+        static_assert(I < R && J < C, "  ");
+        return data[I * C + J];
+    }
+
+    static constexpr size_t getRows() {
+        return R;
+    }
+
+    static constexpr size_t getCols() {
+        return C;
+    }
+
+    ///      
+    constexpr bool operator==(const FixedMatrix& other) const {
+        for (size_t i = 0; i < R * C; i++) {
+            if (detail::fixedMagnitude(data[i] - other.data[i]) > detail::fixedMagnitude(epsilon)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    constexpr bool operator!=(const FixedMatrix& other) const {
+        return !(*this == other);
+    }
+
+    ///     
+    constexpr FixedMatrix operator+(const FixedMatrix& other) const {
+        FixedMatrix result;
+        for (size_t i = 0; i < R * C; i++) {
+            result.data[i] = data[i] + other.data[i];
+        }
+        return result;
+    }
+
+    constexpr FixedMatrix operator-(const FixedMatrix& other) const {
+        FixedMatrix result;
+        for (size_t i = 0; i < R * C; i++) {
+            result.data[i] = data[i] - other.data[i];
+        }
+        return result;
+    }
+
+    constexpr FixedMatrix& operator+=(const FixedMatrix& other) {
+        for (size_t i = 0; i < R * C; i++) {
+            data[i] += other.data[i];
+        }
+        return *this;
+    }
+
+    constexpr FixedMatrix& operator-=(const FixedMatrix& other) {
+        for (size_t i = 0; i < R * C; i++) {
+            data[i] -= other.data[i];
+        }
+        return *this;
+    }
+
+    ///    ( )
+    template<size_t K>
+    constexpr FixedMatrix<T, R, K> operator*(const FixedMatrix<T, C, K>& other) const {
+        FixedMatrix<T, R, K> result;
+        multiplyInto(other, result, std::make_index_sequence<R * K>{});
+        return result;
+    }
+
+    ///     
+    constexpr FixedMatrix operator*(T scalar) const {
+        FixedMatrix result;
+        for (size_t i = 0; i < R * C; i++) {
+            result.data[i] = data[i] * scalar;
+        }
+        return result;
+    }
+
+    ///     
+    constexpr FixedMatrix operator/(T scalar) const {
+        if (scalar == T()) {
+            throw std::invalid_argument("  ");
+        }
+        FixedMatrix result;
+        for (size_t i = 0; i < R * C; i++) {
+            result.data[i] = data[i] / scalar;
+        }
+        return result;
+    }
+
+    /// 
+    constexpr FixedMatrix<T, C, R> transposed() const {
+        FixedMatrix<T, C, R> result;
+        for (size_t i = 0; i < R; i++) {
+            for (size_t j = 0; j < C; j++) {
+                result.data[j * R + i] = data[i * C + j];
+            }
+        }
+        return result;
+    }
+
+    ///   
+    constexpr T trace() const requires (R == C) {
+        T trace = T();
+        for (size_t i = 0; i < R; i++) {
+            trace += data[i * C + i];
+        }
+        return trace;
+    }
+
+    ///  
+    friend std::ostream& operator<<(std::ostream& os, const FixedMatrix& matrix) {
+        for (size_t i = 0; i < R; i++) {
+            for (size_t j = 0; j < C; j++) {
+                os << std::setw(10) << matrix.data[i * C + j] << " ";
+            }
+            os << std::endl;
+        }
+        return os;
+    }
+};
+
+template<typename T, size_t R, size_t C>
+constexpr FixedMatrix<T, R, C> operator*(T scalar, const FixedMatrix<T, R, C>& matrix) {
+    return matrix * scalar;
+}
+
+
+/// :   1x1, 2x2, 3x3,       
+template<typename T, size_t N>
+constexpr T det(const FixedMatrix<T, N, N>& m) {
+    if constexpr (N == 1) {
+        return m.template get<0, 0>();
+    }
+    else if constexpr (N == 2) {
+        return m.template get<0, 0>() * m.template get<1, 1>() - m.template get<0, 1>() * m.template get<1, 0>();
+    }
+    else if constexpr (N == 3) {
+        return m.template get<0, 0>() * (m.template get<1, 1>() * m.template get<2, 2>() - m.template get<2, 1>() * m.template get<1, 2>()) -
+            m.template get<0, 1>() * (m.template get<1, 0>() * m.template get<2, 2>() - m.template get<1, 2>() * m.template get<2, 0>()) +
+            m.template get<0, 2>() * (m.template get<1, 0>() * m.template get<2, 1>() - m.template get<1, 1>() * m.template get<2, 0>());
+    }
+    else {
+        FixedMatrix<T, N, N> a = m;
+        T result = T(1);
+        for (size_t k = 0; k < N; k++) {
+            size_t p = k;
+            for (size_t i = k + 1; i < N; i++) {
+                if (detail::fixedMagnitude(a(i, k)) > detail::fixedMagnitude(a(p, k))) {
+                    p = i;
+                }
+            }
+            if (a(p, k) == T()) {
+                return T();
+            }
+            if (p != k) {
+                for (size_t j = 0; j < N; j++) {
+                    std::swap(a(k, j), a(p, j));
+                }
+                result = -result;
+            }
+            result *= a(k, k);
+            for (size_t i = k + 1; i < N; i++) {
+                const T factor = a(i, k) / a(k, k);
+                for (size_t j = k + 1; j < N; j++) {
+                    a(i, j) -= factor * a(k, j);
+                }
+            }
+        }
+        return result;
+    }
+}
+
+///   :    2x2  3x3,   -
+template<typename T, size_t N>
+constexpr FixedMatrix<T, N, N> inverse(const FixedMatrix<T, N, N>& m) {
+    if constexpr (N <= 3) {
+        const T d = det(m);
+        if (d == T()) {
+            throw std::invalid_argument("     ");
+        }
+        if constexpr (N == 1) {
+            return FixedMatrix<T, 1, 1>{T(1) / d};
+        }
+        else if constexpr (N == 2) {
+            return FixedMatrix<T, 2, 2>{m.template get<1, 1>(), -m.template get<0, 1>(), -m.template get<1, 0>(), m.template get<0, 0>()} / d;
+        }
+        else {
+            const T inv = T(1) / d;
+            return FixedMatrix<T, 3, 3>{
+                (m.template get<1, 1>() * m.template get<2, 2>() - m.template get<2, 1>() * m.template get<1, 2>()) * inv,
+                (m.template get<0, 2>() * m.template get<2, 1>() - m.template get<0, 1>() * m.template get<2, 2>()) * inv,
+                (m.template get<0, 1>() * m.template get<1, 2>() - m.template get<0, 2>() * m.template get<1, 1>()) * inv,
+                (m.template get<1, 2>() * m.template get<2, 0>() - m.template get<1, 0>() * m.template get<2, 2>()) * inv,
+                (m.template get<0, 0>() * m.template get<2, 2>() - m.template get<0, 2>() * m.template get<2, 0>()) * inv,
+                (m.template get<1, 0>() * m.template get<0, 2>() - m.template get<0, 0>() * m.template get<1, 2>()) * inv,
+                (m.template get<1, 0>() * m.template get<2, 1>() - m.template get<2, 0>() * m.template get<1, 1>()) * inv,
+                (m.template get<2, 0>() * m.template get<0, 1>() - m.template get<0, 0>() * m.template get<2, 1>()) * inv,
+                (m.template get<0, 0>() * m.template get<1, 1>() - m.template get<1, 0>() * m.template get<0, 1>()) * inv};
+        }
+    }
+    else {
+        FixedMatrix<T, N, N> a = m;
+        FixedMatrix<T, N, N> result = FixedMatrix<T, N, N>::identity();
+        for (size_t k = 0; k < N; k++) {
+            size_t p = k;
+            for (size_t i = k + 1; i < N; i++) {
+                if (detail::fixedMagnitude(a(i, k)) > detail::fixedMagnitude(a(p, k))) {
+                    p = i;
+                }
+            }
+            if (a(p, k) == T()) {
+                throw std::invalid_argument("     ");
+            }
+            if (p != k) {
+                for (size_t j = 0; j < N; j++) {
+                    std::swap(a(k, j), a(p, j));
+                    std::swap(result(k, j), result(p, j));
+                }
+            }
+            const T pivot = T(1) / a(k, k);
+            for (size_t j = 0; j < N; j++) {
+                a(k, j) *= pivot;
+                result(k, j) *= pivot;
+            }
+            for (size_t i = 0; i < N; i++) {
+                if (i == k) {
+                    continue;
+                }
+                const T factor = a(i, k);
+                for (size_t j = 0; j < N; j++) {
+                    a(i, j) -= factor * a(k, j);
+                    result(i, j) -= factor * result(k, j);
+                }
+            }
+        }
+        return result;
+    }
+}
@@ -0,0 +1,678 @@
+#pragma once
+
+#include <cstddef>
+#include <algorithm>
+#include <complex>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "blas.h"
+#include "cpu.h"
+#include "simd.h"
+#include "thread_pool.h"
+
+
+///   C = alpha * A * B + beta * C  "" .
+/// A  B        (rs, cs),  
+///      . C      ldc.
+///  float/double       ( BLIS):
+///  B (KC x NC)   L3,  A (MC x KC) -  L2,  MR x NR -  .
+
+namespace detail {
+
+///     
+template<typename T>
+class PackBuffer {
+private:
+    struct Deleter {
+        void operator()(T* ptr) const {
+            ::operator delete(ptr, std::align_val_t(64));
+        }
+    };
+    std::unique_ptr<T, Deleter> ptr;
+
+public:
+    explicit PackBuffer(size_t count)
+        : ptr(static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t(64)))) {}
+
+    T* get() const {
+        return ptr.get();
+    }
+};
+
+///      
+inline constexpr size_t packCacheBlocks = 4;
+
+///     .  gemmBlocked  
+/// MC x KC  KC x NC,        ,
+///    (   -  )    
+class PackCache {
+public:
+    struct Block {
+        void* ptr = nullptr;
+        size_t bytes = 0;
+    };
+
+private:
+    Block blocks[packCacheBlocks];
+    size_t allocations = 0;
+
+    static void free(Block block) {
+        ::operator delete(block.ptr, std::align_val_t(64));
+    }
+
+public:
+    PackCache() = default;
+    PackCache(const PackCache&) = delete;
+    PackCache& operator=(const PackCache&) = delete;
+
+    ~PackCache() {
+        for (const Block& block : blocks) {
+            if (block.ptr != nullptr) {
+                free(block);
+            }
+        }
+    }
+
+    ///      bytes    
+    Block acquire(size_t bytes) {
+        Block* best = nullptr;
+        for (Block& block : blocks) {
+            if (block.ptr != nullptr && block.bytes >= bytes && (best == nullptr || block.bytes < best->bytes)) {
+                best = &block;
+            }
+        }
+        if (best != nullptr) {
+            return std::exchange(*best, Block());
+        }
+        allocations++;
+        return Block{::operator new(bytes, std::align_val_t(64)), bytes};
+    }
+
+    ///  ;       
+    void release(Block block) {
+        Block* slot = nullptr;
+        for (Block& candidate : blocks) {
+            if (candidate.ptr == nullptr) {
+                slot = &candidate;
+                break;
+            }
+            if (slot == nullptr || candidate.bytes < slot->bytes) {
+                slot = &candidate;
+            }
+        }
+        if (slot->ptr != nullptr) {
+            if (slot->bytes >= block.bytes) {
+                free(block);
+                return;
+            }
+            free(*slot);
+        }
+        *slot = block;
+    }
+
+    ///  ,     
+    size_t heapAllocations() const {
+        return allocations;
+    }
+};
+
+inline PackCache& packCache() {
+    thread_local PackCache cache;
+    return cache;
+}
+
+///         
+template<typename T>
+class CachedPackBuffer {
+private:
+    PackCache::Block block;
+
+public:
+    explicit CachedPackBuffer(size_t count) : block(packCache().acquire(count * sizeof(T))) {}
+
+    CachedPackBuffer(const CachedPackBuffer&) = delete;
+    CachedPackBuffer& operator=(const CachedPackBuffer&) = delete;
+
+    ~CachedPackBuffer() {
+        packCache().release(block);
+    }
+
+    T* get() const {
+        return static_cast<T*>(block.ptr);
+    }
+};
+
+///   (MR x NR)    (MC, KC, NC)     SIMD
+template<typename T, SimdLevel L>
+struct GemmBlocking;
+
+template<> struct GemmBlocking<double, SimdLevel::Generic> { static constexpr size_t MR = 4, NR = 4, MC = 128, KC = 256, NC = 2048; };
+template<> struct GemmBlocking<double, SimdLevel::Avx2> { static constexpr size_t MR = 6, NR = 8, MC = 120, KC = 256, NC = 4096; };
+template<> struct GemmBlocking<double, SimdLevel::Avx512> { static constexpr size_t MR = 8, NR = 16, MC = 128, KC = 256, NC = 4096; };
+template<> struct GemmBlocking<float, SimdLevel::Generic> { static constexpr size_t MR = 4, NR = 8, MC = 128, KC = 256, NC = 4096; };
+template<> struct GemmBlocking<float, SimdLevel::Avx2> { static constexpr size_t MR = 6, NR = 16, MC = 120, KC = 384, NC = 4096; };
+template<> struct GemmBlocking<float, SimdLevel::Avx512> { static constexpr size_t MR = 8, NR = 32, MC = 128, KC = 384, NC = 4096; };
+
+///     C   beta    
+template<typename T, size_t MR, size_t NR>
+inline void storeTile(const T (&acc)[MR][NR], T* c, size_t ldc, T beta, size_t mr, size_t nr) {
+    for (size_t i = 0; i < mr; i++) {
+        T* row = c + i * ldc;
+        if (beta == T()) {
+            for (size_t j = 0; j < nr; j++) {
+                row[j] = acc[i][j];
+            }
+        }
+        else if (beta == T(1)) {
+            for (size_t j = 0; j < nr; j++) {
+                row[j] += acc[i][j];
+            }
+        }
+        else {
+            for (size_t j = 0; j < nr; j++) {
+                row[j] = beta * row[j] + acc[i][j];
+            }
+        }
+    }
+}
+
+/// :  MR x NR  C    A (kc x MR)  B (kc x NR).
+///  :     .
+template<typename T, size_t MR, size_t NR>
+inline void microKernelScalar(size_t kc, const T* __restrict a, const T* __restrict b,
+    T* __restrict c, size_t ldc, T beta, size_t mr, size_t nr) {
+    T acc[MR][NR] = {};
+    for (size_t p = 0; p < kc; p++) {
+        for (size_t i = 0; i < MR; i++) {
+            const T ai = a[p * MR + i];
+            for (size_t j = 0; j < NR; j++) {
+                acc[i][j] += ai * b[p * NR + j];
+            }
+        }
+    }
+    storeTile<T, MR, NR>(acc, c, ldc, beta, mr, nr);
+}
+
+template<typename T, SimdLevel L>
+struct MicroKernel {
+    using B = GemmBlocking<T, L>;
+    static void run(size_t kc, const T* a, const T* b, T* c, size_t ldc, T beta, size_t mr, size_t nr) {
+        microKernelScalar<T, B::MR, B::NR>(kc, a, b, c, ldc, beta, mr, nr);
+    }
+};
+
+#if MATRIX_X86_DISPATCH
+///  : MR x (NR / W)         k
+template<typename T, SimdLevel L, size_t MR, size_t NR>
+inline void microKernelSimd(size_t kc, const T* a, const T* b, T* c, size_t ldc, T beta, size_t mr, size_t nr) {
+    using Ops = SimdOps<T, L>;
+    using V = typename Ops::V;
+    constexpr size_t W = Ops::W;
+    constexpr size_t NV = NR / W;
+    static_assert(NR % W == 0, "NR     ");
+
+    V acc[MR][NV];
+#pragma GCC unroll 16
+    for (size_t i = 0; i < MR; i++) {
+#pragma GCC unroll 4
+        for (size_t v = 0; v < NV; v++) {
+            Ops::zero(acc[i][v]);
+        }
+    }
+    for (size_t p = 0; p < kc; p++) {
+        V bv[NV];
+#pragma GCC unroll 4
+        for (size_t v = 0; v < NV; v++) {
+            Ops::load(bv[v], b + p * NR + v * W);
+        }
+#pragma GCC unroll 16
+        for (size_t i = 0; i < MR; i++) {
+            V ai;
+            Ops::broadcast(ai, a[p * MR + i]);
+#pragma GCC unroll 4
+            for (size_t v = 0; v < NV; v++) {
+                Ops::fma(acc[i][v], ai, bv[v]);
+            }
+        }
+    }
+
+    //    beta 0  1    ;  -  storeTile,
+    //    ,       C
+    if (mr == MR && nr == NR && (beta == T() || beta == T(1))) {
+#pragma GCC unroll 16
+        for (size_t i = 0; i < MR; i++) {
+#pragma GCC unroll 4
+            for (size_t v = 0; v < NV; v++) {
+                T* dst = c + i * ldc + v * W;
+                if (beta == T(1)) {
+                    V old;
+                    Ops::load(old, dst);
+                    Ops::add(acc[i][v], acc[i][v], old);
+                }
+                Ops::store(dst, acc[i][v]);
+            }
+        }
+        return;
+    }
+    T tile[MR][NR];
+    for (size_t i = 0; i < MR; i++) {
+        for (size_t v = 0; v < NV; v++) {
+            Ops::store(&tile[i][v * W], acc[i][v]);
+        }
+    }
+    storeTile<T, MR, NR>(tile, c, ldc, beta, mr, nr);
+}
+
+template<typename T>
+struct MicroKernel<T, SimdLevel::Avx2> {
+    using B = GemmBlocking<T, SimdLevel::Avx2>;
+    MATRIX_TARGET("avx2,fma") MATRIX_FLATTEN
+    static void run(size_t kc, const T* a, const T* b, T* c, size_t ldc, T beta, size_t mr, size_t nr) {
+        microKernelSimd<T, SimdLevel::Avx2, B::MR, B::NR>(kc, a, b, c, ldc, beta, mr, nr);
+    }
+};
+
+template<typename T>
+struct MicroKernel<T, SimdLevel::Avx512> {
+    using B = GemmBlocking<T, SimdLevel::Avx512>;
+    MATRIX_TARGET("avx512f") MATRIX_FLATTEN
+    static void run(size_t kc, const T* a, const T* b, T* c, size_t ldc, T beta, size_t mr, size_t nr) {
+        microKernelSimd<T, SimdLevel::Avx512, B::MR, B::NR>(kc, a, b, c, ldc, beta, mr, nr);
+    }
+};
+#endif
+
+///   A (mc x kc)    MR , alpha   
+template<typename T, size_t MR>
+void packA(size_t mc, size_t kc, T alpha, const T* a, size_t rsa, size_t csa, T* dst) {
+    for (size_t ir = 0; ir < mc; ir += MR) {
+        const size_t mr = std::min(MR, mc - ir);
+        for (size_t p = 0; p < kc; p++) {
+            const T* src = a + ir * rsa + p * csa;
+            for (size_t i = 0; i < mr; i++) {
+                dst[i] = alpha * src[i * rsa];
+            }
+            for (size_t i = mr; i < MR; i++) {
+                dst[i] = T();
+            }
+            dst += MR;
+        }
+    }
+}
+
+///   B (kc x nc)    NR 
+template<typename T, size_t NR>
+void packB(size_t kc, size_t nc, const T* b, size_t rsb, size_t csb, T* dst) {
+    for (size_t jr = 0; jr < nc; jr += NR) {
+        const size_t nr = std::min(NR, nc - jr);
+        for (size_t p = 0; p < kc; p++) {
+            const T* src = b + p * rsb + jr * csb;
+            if (csb == 1 && nr == NR) {
+                std::copy(src, src + NR, dst);
+            }
+            else {
+                for (size_t j = 0; j < nr; j++) {
+                    dst[j] = src[j * csb];
+                }
+                for (size_t j = nr; j < NR; j++) {
+                    dst[j] = T();
+                }
+            }
+            dst += NR;
+        }
+    }
+}
+
+///        SIMD
+template<typename T, SimdLevel L>
+void gemmBlocked(size_t m, size_t n, size_t k, T alpha, const T* a, size_t rsa, size_t csa,
+    const T* b, size_t rsb, size_t csb, T beta, T* c, size_t ldc) {
+    using B = GemmBlocking<T, L>;
+    const size_t mcMax = (std::min(B::MC, m) + B::MR - 1) / B::MR * B::MR;
+    const size_t kcMax = std::min(B::KC, k);
+    const size_t ncMax = (std::min(B::NC, n) + B::NR - 1) / B::NR * B::NR;
+    const CachedPackBuffer<T> packedA(mcMax * kcMax);
+    const CachedPackBuffer<T> packedB(kcMax * ncMax);
+
+    for (size_t jc = 0; jc < n; jc += B::NC) {
+        const size_t nc = std::min(B::NC, n - jc);
+        for (size_t pc = 0; pc < k; pc += B::KC) {
+            const size_t kc = std::min(B::KC, k - pc);
+            const T blockBeta = pc == 0 ? beta : T(1);
+            packB<T, B::NR>(kc, nc, b + pc * rsb + jc * csb, rsb, csb, packedB.get());
+            for (size_t ic = 0; ic < m; ic += B::MC) {
+                const size_t mc = std::min(B::MC, m - ic);
+                packA<T, B::MR>(mc, kc, alpha, a + ic * rsa + pc * csa, rsa, csa, packedA.get());
+                for (size_t jr = 0; jr < nc; jr += B::NR) {
+                    const size_t nr = std::min(B::NR, nc - jr);
+                    for (size_t ir = 0; ir < mc; ir += B::MR) {
+                        const size_t mr = std::min(B::MR, mc - ir);
+                        MicroKernel<T, L>::run(kc, packedA.get() + ir * kc, packedB.get() + jr * kc,
+                            c + (ic + ir) * ldc + jc + jr, ldc, blockBeta, mr, nr);
+                    }
+                }
+            }
+        }
+    }
+}
+
+///   i-k-j        
+template<typename T>
+void gemmSimple(size_t m, size_t n, size_t k, T alpha, const T* a, size_t rsa, size_t csa,
+    const T* b, size_t rsb, size_t csb, T beta, T* c, size_t ldc) {
+    for (size_t i = 0; i < m; i++) {
+        T* row = c + i * ldc;
+        for (size_t j = 0; j < n; j++) {
+            row[j] = beta == T() ? T() : beta * row[j];
+        }
+        for (size_t p = 0; p < k; p++) {
+            const T aip = alpha * a[i * rsa + p * csa];
+            const T* brow = b + p * rsb;
+            if (csb == 1) {
+                for (size_t j = 0; j < n; j++) {
+                    row[j] += aip * brow[j];
+                }
+            }
+            else {
+                for (size_t j = 0; j < n; j++) {
+                    row[j] += aip * brow[j * csb];
+                }
+            }
+        }
+    }
+}
+
+///     (C: m x 1).  A  -  GEMV (. blas.h),  B
+///      ;  -     .
+///        NR     A.
+template<typename T>
+void gemmColumn(size_t m, size_t k, T alpha, const T* a, size_t rsa, size_t csa,
+    const T* b, size_t rsb, T beta, T* c, size_t ldc) {
+    if (csa == 1) {
+        const T* x = b;
+        std::vector<T> packed;
+        if (rsb != 1) {
+            packed.resize(k);
+            for (size_t p = 0; p < k; p++) {
+                packed[p] = b[p * rsb];
+            }
+            x = packed.data();
+        }
+        withBlasKernels<T>([&](auto kernels) {
+            kernels.gemvRows(m, k, alpha, a, rsa, x, beta, c, ldc);
+        });
+        return;
+    }
+    for (size_t i = 0; i < m; i++) {
+        const T* row = a + i * rsa;
+        T s0 = T(), s1 = T(), s2 = T(), s3 = T();
+        size_t p = 0;
+        for (; p + 4 <= k; p += 4) {
+            s0 += row[p * csa] * b[p * rsb];
+            s1 += row[(p + 1) * csa] * b[(p + 1) * rsb];
+            s2 += row[(p + 2) * csa] * b[(p + 2) * rsb];
+            s3 += row[(p + 3) * csa] * b[(p + 3) * rsb];
+        }
+        for (; p < k; p++) {
+            s0 += row[p * csa] * b[p * rsb];
+        }
+        const T sum = alpha * ((s0 + s1) + (s2 + s3));
+        c[i * ldc] = beta == T() ? sum : sum + beta * c[i * ldc];
+    }
+}
+
+///  (m * n * k),     
+inline constexpr size_t gemmSmallVolume = 32 * 32 * 32;
+
+///         m x n x k
+template<typename T>
+bool gemmUsesPacking(size_t m, size_t n, size_t k) {
+    return (std::is_same_v<T, float> || std::is_same_v<T, double>) && k > 0 && m * n * k >= gemmSmallVolume;
+}
+
+///      3M:  A  B    O(mk + kn),
+///    B ( A * x)    
+inline constexpr size_t gemmComplex3mMinSide = 16;
+
+///     (packed -   ,  )
+template<typename T>
+void gemmSerial(size_t m, size_t n, size_t k, T alpha, const T* a, size_t rsa, size_t csa,
+    const T* b, size_t rsb, size_t csb, T beta, T* c, size_t ldc, bool packed) {
+    if (m == 0 || n == 0) {
+        return;
+    }
+    if constexpr (std::is_same_v<T, float> || std::is_same_v<T, double>) {
+        if (packed) {
+            switch (simdLevel()) {
+            case SimdLevel::Avx512:
+                gemmBlocked<T, SimdLevel::Avx512>(m, n, k, alpha, a, rsa, csa, b, rsb, csb, beta, c, ldc);
+                return;
+            case SimdLevel::Avx2:
+                gemmBlocked<T, SimdLevel::Avx2>(m, n, k, alpha, a, rsa, csa, b, rsb, csb, beta, c, ldc);
+                return;
+            default:
+                gemmBlocked<T, SimdLevel::Generic>(m, n, k, alpha, a, rsa, csa, b, rsb, csb, beta, c, ldc);
+                return;
+            }
+        }
+    }
+    gemmSimple(m, n, k, alpha, a, rsa, csa, b, rsb, csb, beta, c, ldc);
+}
+
+///  C     :   4   ,
+///    64 x 64,     
+inline void gemmTiles(size_t m, size_t n, size_t threads, size_t& tileRows, size_t& tileCols) {
+    tileRows = std::min<size_t>(m, 512);
+    tileCols = std::min<size_t>(n, 512);
+    while (((m + tileRows - 1) / tileRows) * ((n + tileCols - 1) / tileCols) < 4 * threads) {
+        if (tileRows >= tileCols && tileRows > 64) {
+            tileRows = (tileRows + 1) / 2;
+        }
+        else if (tileCols > 64) {
+            tileCols = (tileCols + 1) / 2;
+        }
+        else {
+            break;
+        }
+    }
+}
+
+///  (m * n * k),       
+inline constexpr size_t gemmParallelVolume = 128 * 128 * 128;
+
+///         ;  4,   
+///    GEMV  ,    
+inline constexpr size_t gemmColumnTaskRows = 256;
+
+} // namespace detail
+
+
+///   
+struct GemmSettings {
+    ///  : C     ,  
+    ///        k,    
+    ///      .         k
+    ///   k   ,       .
+    bool deterministic = true;
+};
+
+inline GemmSettings& gemmSettings() {
+    static GemmSettings settings;
+    return settings;
+}
+
+
+namespace detail {
+
+template<typename R>
+void gemmComplex3m(size_t m, size_t n, size_t k, std::complex<R> alpha, const std::complex<R>* a, size_t rsa, size_t csa,
+    const std::complex<R>* b, size_t rsb, size_t csb, std::complex<R> beta, std::complex<R>* c, size_t ldc);
+
+} // namespace detail
+
+/// C = alpha * A * B + beta * C, A: m x k, B: k x n, C: m x n.
+///  beta == 0   C  .
+///      C      .
+///   ( )     (gemm3m).
+template<typename T>
+void gemm(size_t m, size_t n, size_t k, T alpha, const T* a, size_t rsa, size_t csa,
+    const T* b, size_t rsb, size_t csb, T beta, T* c, size_t ldc) {
+    if (m == 0 || n == 0) {
+        return;
+    }
+    if constexpr (std::is_same_v<T, std::complex<float>> || std::is_same_v<T, std::complex<double>>) {
+        if (k > 0 && m * n * k >= detail::gemmSmallVolume && std::min({m, n, k}) >= detail::gemmComplex3mMinSide) {
+            detail::gemmComplex3m(m, n, k, alpha, a, rsa, csa, b, rsb, csb, beta, c, ldc);
+            return;
+        }
+    }
+    //      ,     ,   :
+    //           GEMV,    -   
+    if (n == 1) {
+        const size_t tasks = m * k < detail::gemmParallelVolume ? 1 : (m + detail::gemmColumnTaskRows - 1) / detail::gemmColumnTaskRows;
+        parallelFor(tasks, [&](size_t t) {
+            const size_t i0 = t * detail::gemmColumnTaskRows;
+            const size_t rows = tasks == 1 ? m : std::min(detail::gemmColumnTaskRows, m - i0);
+            detail::gemmColumn(rows, k, alpha, a + i0 * rsa, rsa, csa, b, rsb, beta, c + i0 * ldc, ldc);
+        });
+        return;
+    }
+    const bool packed = detail::gemmUsesPacking<T>(m, n, k);
+    if (k == 0 || m * n * k < detail::gemmParallelVolume) {
+        detail::gemmSerial(m, n, k, alpha, a, rsa, csa, b, rsb, csb, beta, c, ldc, packed);
+        return;
+    }
+    ThreadPool& pool = threadPool();
+    const size_t threads = pool.size();
+    if (threads == 1) {
+        detail::gemmSerial(m, n, k, alpha, a, rsa, csa, b, rsb, csb, beta, c, ldc, packed);
+        return;
+    }
+
+    size_t tileRows = 0;
+    size_t tileCols = 0;
+    detail::gemmTiles(m, n, threads, tileRows, tileCols);
+    const size_t tilesM = (m + tileRows - 1) / tileRows;
+    const size_t tilesN = (n + tileCols - 1) / tileCols;
+    const size_t tiles = tilesM * tilesN;
+
+    const size_t kChunk = 1024;
+    if (!gemmSettings().deterministic && tiles < threads && k >= 2 * kChunk) {
+        //   k:     ,   
+        for (size_t i = 0; i < m; i++) {
+            T* row = c + i * ldc;
+            for (size_t j = 0; j < n; j++) {
+                row[j] = beta == T() ? T() : beta * row[j];
+            }
+        }
+        std::mutex sumMutex;
+        TaskGroup group(pool);
+        for (size_t p0 = 0; p0 < k; p0 += kChunk) {
+            group.run([=, &sumMutex] {
+                const size_t kc = std::min(kChunk, k - p0);
+                std::vector<T> partial(m * n);
+                detail::gemmSerial(m, n, kc, alpha, a + p0 * csa, rsa, csa, b + p0 * rsb, rsb, csb, T(), partial.data(), n, packed);
+                std::lock_guard<std::mutex> lock(sumMutex);
+                for (size_t i = 0; i < m; i++) {
+                    T* row = c + i * ldc;
+                    const T* src = partial.data() + i * n;
+                    for (size_t j = 0; j < n; j++) {
+                        row[j] += src[j];
+                    }
+                }
+            });
+        }
+        group.wait();
+        return;
+    }
+
+    TaskGroup group(pool);
+    for (size_t t = 0; t < tiles; t++) {
+        group.run([=] {
+            const size_t i0 = (t / tilesN) * tileRows;
+            const size_t j0 = (t % tilesN) * tileCols;
+            const size_t mt = std::min(tileRows, m - i0);
+            const size_t nt = std::min(tileCols, n - j0);
+            detail::gemmSerial(mt, nt, k, alpha, a + i0 * rsa, rsa, csa, b + j0 * csb, rsb, csb, beta, c + i0 * ldc + j0, ldc, packed);
+        });
+    }
+    group.wait();
+}
+
+
+///     ()    3M:
+/// Cr = Ar * Br - Ai * Bi, Ci = (Ar + Ai) * (Br + Bi) - Ar * Br - Ai * Bi.
+///     ;     ,
+///    ,  |Ar * Br|  |Ai * Bi|   .
+///   A, B, C    lda, ldb, ldc.
+template<typename R>
+void gemm3m(size_t m, size_t n, size_t k, const R* ar, const R* ai, size_t lda, const R* br, const R* bi, size_t ldb,
+    R* cr, R* ci, size_t ldc) {
+    static_assert(std::is_same_v<R, float> || std::is_same_v<R, double>, "3M   float  double");
+    if (m == 0 || n == 0) {
+        return;
+    }
+    detail::PackBuffer<R> sumA(m * k);
+    detail::PackBuffer<R> sumB(k * n);
+    detail::PackBuffer<R> product(m * n);
+    for (size_t i = 0; i < m; i++) {
+        simdAdd(ar + i * lda, ai + i * lda, sumA.get() + i * k, k);
+    }
+    for (size_t p = 0; p < k; p++) {
+        simdAdd(br + p * ldb, bi + p * ldb, sumB.get() + p * n, n);
+    }
+    gemm<R>(m, n, k, R(1), ar, lda, 1, br, ldb, 1, R(), cr, ldc);
+    gemm<R>(m, n, k, R(1), sumA.get(), k, 1, sumB.get(), n, 1, R(), ci, ldc);
+    gemm<R>(m, n, k, R(1), ai, lda, 1, bi, ldb, 1, R(), product.get(), n);
+    for (size_t i = 0; i < m; i++) {
+        R* re = cr + i * ldc;
+        R* im = ci + i * ldc;
+        const R* t = product.get() + i * n;
+        simdSub(im, re, im, n);
+        simdSub(im, t, im, n);
+        simdSub(re, t, re, n);
+    }
+}
+
+namespace detail {
+
+///   gemm  3M: A  B   ,   
+template<typename R>
+void gemmComplex3m(size_t m, size_t n, size_t k, std::complex<R> alpha, const std::complex<R>* a, size_t rsa, size_t csa,
+    const std::complex<R>* b, size_t rsb, size_t csb, std::complex<R> beta, std::complex<R>* c, size_t ldc) {
+    PackBuffer<R> ar(m * k);
+    PackBuffer<R> ai(m * k);
+    PackBuffer<R> br(k * n);
+    PackBuffer<R> bi(k * n);
+    PackBuffer<R> cr(m * n);
+    PackBuffer<R> ci(m * n);
+    for (size_t i = 0; i < m; i++) {
+        for (size_t p = 0; p < k; p++) {
+            const std::complex<R> x = a[i * rsa + p * csa];
+            ar.get()[i * k + p] = x.real();
+            ai.get()[i * k + p] = x.imag();
+        }
+    }
+    for (size_t p = 0; p < k; p++) {
+        for (size_t j = 0; j < n; j++) {
+            const std::complex<R> x = b[p * rsb + j * csb];
+            br.get()[p * n + j] = x.real();
+            bi.get()[p * n + j] = x.imag();
+        }
+    }
+    gemm3m<R>(m, n, k, ar.get(), ai.get(), k, br.get(), bi.get(), n, cr.get(), ci.get(), n);
+    for (size_t i = 0; i < m; i++) {
+        std::complex<R>* row = c + i * ldc;
+        for (size_t j = 0; j < n; j++) {
+            const std::complex<R> x = alpha * std::complex<R>(cr.get()[i * n + j], ci.get()[i * n + j]);
+            row[j] = beta == std::complex<R>() ? x : x + beta * row[j];
+        }
+    }
+}
+
+} // namespace detail
@@ -0,0 +1,326 @@
+#pragma once
+
+#include <cstddef>
+#include <algorithm>
+#include <complex>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "matrix.h"
+#include "gemm.h"
+
+
+/// LU-     : P * A = L * U.
+///   -   (right-looking):   nb  
+///  (  ),      
+///   gemm,      O(n^3).
+
+namespace detail {
+
+///    
+inline constexpr size_t luBlock = 128;
+
+/// ,         
+inline constexpr size_t luLeaf = 8;
+
+///      (|re| + |im|   -  sqrt)
+template<typename T>
+auto pivotMagnitude(const T& x) {
+    if constexpr (is_complex<T>::value) {
+        return std::abs(x.real()) + std::abs(x.imag());
+    }
+    else {
+        return std::abs(x);
+    }
+}
+
+///     n x n
+template<typename T>
+auto maxMagnitude(size_t n, const T* a, size_t ld) {
+    using Real = decltype(pivotMagnitude(T()));
+    Real largest = 0;
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = 0; j < n; j++) {
+            largest = std::max(largest, pivotMagnitude(a[i * ld + j]));
+        }
+    }
+    return largest;
+}
+
+/// y[j] -= s * x[j]
+template<typename T>
+inline void rowAxpy(T* y, const T* x, T s, size_t n) {
+    for (size_t j = 0; j < n; j++) {
+        y[j] -= s * x[j];
+    }
+}
+
+///   k  piv[k]  k  [k0, k1)    cols 
+template<typename T>
+void applySwaps(T* a, size_t ld, size_t cols, const size_t* piv, size_t k0, size_t k1) {
+    if (cols == 0) {
+        return;
+    }
+    for (size_t k = k0; k < k1; k++) {
+        if (piv[k] != k) {
+            std::swap_ranges(a + k * ld, a + k * ld + cols, a + piv[k] * ld);
+        }
+    }
+}
+
+///  L * X = B   (L - n x n  , B - n x m)
+template<typename T>
+void trsmLowerUnit(size_t n, size_t m, const T* l, size_t ldl, T* b, size_t ldb) {
+    if (n == 0 || m == 0) {
+        return;
+    }
+    if (n <= luLeaf) {
+        for (size_t i = 1; i < n; i++) {
+            for (size_t k = 0; k < i; k++) {
+                rowAxpy(b + i * ldb, b + k * ldb, l[i * ldl + k], m);
+            }
+        }
+        return;
+    }
+    const size_t n1 = n / 2;
+    trsmLowerUnit(n1, m, l, ldl, b, ldb);
+    gemm<T>(n - n1, m, n1, T(-1), l + n1 * ldl, ldl, 1, b, ldb, 1, T(1), b + n1 * ldb, ldb);
+    trsmLowerUnit(n - n1, m, l + n1 * ldl + n1, ldl, b + n1 * ldb, ldb);
+}
+
+///  U * X = B   (U - n x n  , B - n x m)
+template<typename T>
+void trsmUpper(size_t n, size_t m, const T* u, size_t ldu, T* b, size_t ldb) {
+    if (n == 0 || m == 0) {
+        return;
+    }
+    if (n <= luLeaf) {
+        for (size_t i = n; i-- > 0;) {
+            T* row = b + i * ldb;
+            for (size_t k = i + 1; k < n; k++) {
+                rowAxpy(row, b + k * ldb, u[i * ldu + k], m);
+            }
+            const T diag = u[i * ldu + i];
+            for (size_t j = 0; j < m; j++) {
+                row[j] /= diag;
+            }
+        }
+        return;
+    }
+    const size_t n1 = n / 2;
+    trsmUpper(n - n1, m, u + n1 * ldu + n1, ldu, b + n1 * ldb, ldb);
+    gemm<T>(n1, m, n - n1, T(-1), u + n1, ldu, 1, b + n1 * ldb, ldb, 1, T(1), b, ldb);
+    trsmUpper(n1, m, u, ldu, b, ldb);
+}
+
+///    m x n (m >= n)  .
+/// piv[k] -    ,   k-.  false    .
+template<typename T>
+bool luPanel(size_t m, size_t n, T* a, size_t ld, size_t* piv) {
+    bool regular = true;
+    if (n <= luLeaf) {
+        for (size_t k = 0; k < n; k++) {
+            size_t p = k;
+            for (size_t i = k + 1; i < m; i++) {
+                if (pivotMagnitude(a[i * ld + k]) > pivotMagnitude(a[p * ld + k])) {
+                    p = i;
+                }
+            }
+            piv[k] = p;
+            if (p != k) {
+                std::swap_ranges(a + k * ld, a + k * ld + n, a + p * ld);
+            }
+            const T diag = a[k * ld + k];
+            if (diag == T()) {
+                regular = false;
+                continue;
+            }
+            const T inv = T(1) / diag;
+            for (size_t i = k + 1; i < m; i++) {
+                T* row = a + i * ld;
+                row[k] *= inv;
+                rowAxpy(row + k + 1, a + k * ld + k + 1, row[k], n - k - 1);
+            }
+        }
+        return regular;
+    }
+
+    const size_t n1 = n / 2;
+    const size_t n2 = n - n1;
+    regular = luPanel(m, n1, a, ld, piv) && regular;
+    applySwaps(a + n1, ld, n2, piv, 0, n1);
+    trsmLowerUnit(n1, n2, a, ld, a + n1, ld);
+    gemm<T>(m - n1, n2, n1, T(-1), a + n1 * ld, ld, 1, a + n1, ld, 1, T(1), a + n1 * ld + n1, ld);
+    regular = luPanel(m - n1, n2, a + n1 * ld + n1, ld, piv + n1) && regular;
+    for (size_t k = n1; k < n; k++) {
+        piv[k] += n1;
+    }
+    applySwaps(a, ld, n1, piv, n1, n);
+    return regular;
+}
+
+///     n x n  
+template<typename T>
+bool luFactor(size_t n, T* a, size_t ld, size_t* piv) {
+    bool regular = true;
+    for (size_t j = 0; j < n; j += luBlock) {
+        const size_t jb = std::min(luBlock, n - j);
+        T* panel = a + j * ld + j;
+        regular = luPanel(n - j, jb, panel, ld, piv + j) && regular;
+        for (size_t k = j; k < j + jb; k++) {
+            piv[k] += j;
+        }
+        //          
+        applySwaps(a, ld, j, piv, j, j + jb);
+        const size_t rest = n - j - jb;
+        if (rest == 0) {
+            continue;
+        }
+        applySwaps(a + j + jb, ld, rest, piv, j, j + jb);
+        trsmLowerUnit(jb, rest, panel, ld, panel + jb, ld);
+        gemm<T>(rest, rest, jb, T(-1), panel + jb * ld, ld, 1, panel + jb, ld, 1, T(1), panel + jb * ld + jb, ld);
+    }
+    return regular;
+}
+
+} // namespace detail
+
+
+///  P * A = L * U  .
+/// L (    )  U     factors.
+template<typename T>
+class LUDecomposition {
+    static_assert(std::is_floating_point_v<T> || is_complex<T>::value, "LU-      ");
+
+public:
+    ///     (float  complex<float>)
+    using Real = decltype(detail::pivotMagnitude(T()));
+
+private:
+    Matrix<T> factors;
+    std::vector<size_t> pivots;
+    bool singular;
+    /// max |a_ij|    min |u_ii|
+    Real largestElement;
+    Real smallestPivot;
+
+    void factorize() {
+        if (factors.getRows() != factors.getCols()) {
+            throw std::invalid_argument("   ");
+        }
+        const size_t n = factors.getRows();
+        largestElement = detail::maxMagnitude(n, factors.getData(), factors.getStride());
+        pivots.resize(n);
+        singular = !detail::luFactor(n, factors.getData(), factors.getStride(), pivots.data());
+        smallestPivot = std::numeric_limits<Real>::infinity();
+        for (size_t i = 0; i < n; i++) {
+            smallestPivot = std::min(smallestPivot, detail::pivotMagnitude(factors(i, i)));
+        }
+    }
+
+public:
+    explicit LUDecomposition(const Matrix<T>& matrix) : factors(matrix) {
+        factorize();
+    }
+
+    ///     ,  
+    explicit LUDecomposition(Matrix<T>&& matrix) : factors(std::move(matrix)) {
+        factorize();
+    }
+
+    ///       ( INFO > 0  LAPACK getrf).   ,
+    ///     ;     - . pivotRatio()
+    bool isSingular() const {
+        return singular;
+    }
+
+    /// min |u_ii| / max |a_ij| -    :   
+    /// |l_ij| <= 1,  cond_inf(A) >= 1 / (n * pivotRatio()).  : 
+    ///     . 0   
+    Real pivotRatio() const {
+        if (factors.getRows() == 0) {
+            return Real(1);
+        }
+        return largestElement == Real(0) ? Real(0) : smallestPivot / largestElement;
+    }
+
+    ///     n * eps * max |a_ij|,     ,   
+    ///  :        
+    bool isNearlySingular() const {
+        return pivotRatio() <= Real(factors.getRows()) * std::numeric_limits<Real>::epsilon();
+    }
+
+    ///  A * X = B    B 
+    Matrix<T> solve(const Matrix<T>& b) const {
+        const size_t n = factors.getRows();
+        if (b.getRows() != n) {
+            throw std::invalid_argument("        ");
+        }
+        if (singular) {
+            throw std::invalid_argument(" ,     ");
+        }
+        Matrix<T> x(b);
+        detail::applySwaps(x.getData(), x.getStride(), x.getCols(), pivots.data(), 0, n);
+        detail::trsmLowerUnit(n, x.getCols(), factors.getData(), factors.getStride(), x.getData(), x.getStride());
+        detail::trsmUpper(n, x.getCols(), factors.getData(), factors.getStride(), x.getData(), x.getStride());
+        return x;
+    }
+
+    ///   ( A * X = E)
+    Matrix<T> inverse() const {
+        if (singular) {
+            throw std::invalid_argument("     ");
+        }
+        const size_t n = factors.getRows();
+        Matrix<T> identity(n, n);
+        for (size_t i = 0; i < n; i++) {
+            identity(i, i) = T(1);
+        }
+        return solve(identity);
+    }
+
+    /// :   U   
+    T det() const {
+        T result = T(1);
+        const size_t n = factors.getRows();
+        for (size_t i = 0; i < n; i++) {
+            result *= factors(i, i);
+            if (pivots[i] != i) {
+                result = -result;
+            }
+        }
+        return result;
+    }
+
+    ///   L    U    
+    const Matrix<T>& getFactors() const {
+        return factors;
+    }
+
+    /// pivots[k] - ,   k-   k
+    const std::vector<size_t>& getPivots() const {
+        return pivots;
+    }
+};
+
+
+///   A * X = B
+template<typename T>
+Matrix<T> solve(const Matrix<T>& a, const Matrix<T>& b) {
+    return LUDecomposition<T>(a).solve(b);
+}
+
+///   
+template<typename T>
+Matrix<T> inverse(const Matrix<T>& mat) {
+    return LUDecomposition<T>(mat).inverse();
+}
+
+/// 
+template<typename T>
+T det(const Matrix<T>& mat) {
+    return LUDecomposition<T>(mat).det();
+}
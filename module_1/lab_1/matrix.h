@@ -0,0 +1,470 @@
+#pragma once
+
+#include <iostream>
+#include <iomanip>
+#include <stdexcept>
+#include <complex>
+#include <new>
+#include <cstring>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+#include <type_traits>
+
+#include "gemm.h"
+#include "simd.h"
+#include "strassen.h"
+#include "transpose.h"
+#include "matrix_expr.h"
+#include "matrix_arena.h"
+#include "matrix_random.h"
+#include "matrix_view.h"
+
+
+///    
+template<typename T>
+struct is_complex : std::false_type {};
+
+template<typename T>
+struct is_complex<std::complex<T>> : std::true_type {};
+
+
+///         .
+///       ,    - stride .
+///   (+, -,     ) , . matrix_expr.h.
+/// , ,      , . matrix_view.h.
+///         , . matrix_arena.h.
+template<typename T>
+class Matrix : public MatrixExpr<Matrix<T>> {
+    static_assert(std::is_trivially_copyable_v<T>, "     ");
+
+public:
+    using value_type = T;
+
+    ///        
+    static constexpr size_t alignment = detail::matrixBlockAlignment;
+
+    ///   ,   
+    struct Uninitialized {};
+
+private:
+    size_t rows;
+    size_t cols;
+    size_t stride;
+    T* data;
+
+    ///  :  ,      
+    static size_t alignedStride(size_t cols) {
+        if (alignment % sizeof(T) != 0) {
+            return cols;
+        }
+        const size_t lane = alignment / sizeof(T);
+        return (cols + lane - 1) / lane * lane;
+    }
+
+    static T* allocate(size_t rows, size_t stride) {
+        if (rows == 0 || stride == 0) {
+            return nullptr;
+        }
+        if (stride > SIZE_MAX / sizeof(T) / rows) {
+            throw std::length_error("   ");
+        }
+        return static_cast<T*>(detail::matrixAllocate(rows * stride * sizeof(T)));
+    }
+
+    static void deallocate(T* ptr) {
+        detail::matrixDeallocate(ptr);
+    }
+
+    T* rowPtr(size_t row) {
+        return data + row * stride;
+    }
+
+    const T* rowPtr(size_t row) const {
+        return data + row * stride;
+    }
+
+public:
+    static const T epsilon;
+
+    ///     (  )
+    Matrix(size_t rows, size_t cols, Uninitialized)
+        : rows(rows), cols(cols), stride(alignedStride(cols)), data(allocate(rows, stride)) {
+        for (size_t i = 0; i < rows; i++) {
+            std::fill(rowPtr(i) + cols, rowPtr(i) + stride, T());
+        }
+    }
+
+    ///   
+    Matrix(size_t rows, size_t cols, T value = T()) : Matrix(rows, cols, Uninitialized{}) {
+        for (size_t i = 0; i < rows; i++) {
+            std::fill_n(rowPtr(i), cols, value);
+        }
+    }
+
+    ///    :   [lower_bound, upper_bound), seed    
+    Matrix(size_t rows, size_t cols, T lower_bound, T upper_bound)
+        : Matrix(rows, cols, lower_bound, upper_bound, randomSeed()) {}
+
+    ///  :  seed       
+    Matrix(size_t rows, size_t cols, T lower_bound, T upper_bound, uint64_t seed) : Matrix(rows, cols, Uninitialized{}) {
+        fillRandom(lower_bound, upper_bound, seed);
+    }
+
+    ///  
+    Matrix(const Matrix& other) : rows(other.rows), cols(other.cols), stride(other.stride), data(allocate(rows, stride)) {
+        if (data != nullptr) {
+            std::memcpy(data, other.data, rows * stride * sizeof(T));
+        }
+    }
+
+    ///   :     
+    template<typename E>
+    Matrix(const MatrixExpr<E>& expr) : Matrix(expr.getRows(), expr.getCols(), Uninitialized{}) {
+        detail::evaluateExpr<detail::AssignSet>(expr.self(), data, stride);
+    }
+
+    ///     -  (. transpose.h)
+    Matrix(const TransposedView<T>& view) : Matrix(view.getRows(), view.getCols(), Uninitialized{}) {
+        transpose<T>(cols, rows, view.getData(), view.getStride(), data, stride);
+    }
+
+    ///  
+    Matrix(Matrix&& other) noexcept
+        : rows(std::exchange(other.rows, 0)), cols(std::exchange(other.cols, 0)),
+          stride(std::exchange(other.stride, 0)), data(std::exchange(other.data, nullptr)) {}
+
+    /// 
+    ~Matrix() {
+        deallocate(data);
+    }
+
+    ///  :     
+    Matrix& operator=(const Matrix& other) {
+        if (this == &other) {
+            return *this;
+        }
+        if (rows == other.rows && cols == other.cols) {
+            if (data != nullptr) {
+                std::memcpy(data, other.data, rows * stride * sizeof(T));
+            }
+            return *this;
+        }
+        Matrix copy(other);
+        swap(*this, copy);
+        return *this;
+    }
+
+    ///  
+    Matrix& operator=(Matrix&& other) noexcept {
+        if (this != &other) {
+            deallocate(data);
+            rows = std::exchange(other.rows, 0);
+            cols = std::exchange(other.cols, 0);
+            stride = std::exchange(other.stride, 0);
+            data = std::exchange(other.data, nullptr);
+        }
+        return *this;
+    }
+
+    ///  :        .
+    ///        (A = A * 2 + B);    
+    ///   (A = A.transposed()),      .
+    template<typename E>
+    Matrix& operator=(const MatrixExpr<E>& expr) {
+        if (rows == expr.getRows() && cols == expr.getCols() && !expr.self().exprAliases(data, data + rows * stride, stride)) {
+            detail::evaluateExpr<detail::AssignSet>(expr.self(), data, stride);
+            return *this;
+        }
+        Matrix result(expr);
+        swap(*this, result);
+        return *this;
+    }
+
+    ///   ; A = A.transposed()   
+    Matrix& operator=(const TransposedView<T>& view) {
+        if (view.getData() == data && view.getRows() == cols && view.getCols() == rows) {
+            transposeInPlace();
+            return *this;
+        }
+        Matrix result(view);
+        swap(*this, result);
+        return *this;
+    }
+
+    friend void swap(Matrix& a, Matrix& b) noexcept {
+        std::swap(a.rows, b.rows);
+        std::swap(a.cols, b.cols);
+        std::swap(a.stride, b.stride);
+        std::swap(a.data, b.data);
+    }
+
+    ///      [lower, upper), . matrix_random.h
+    void fillRandom(T lower, T upper, uint64_t seed) {
+        uniformFill(data, rows, cols, stride, lower, upper, seed);
+    }
+
+    ///  ()  /     
+    T& operator()(size_t row, size_t col) {
+        if (row >= rows || col >= cols) {
+            throw std::out_of_range("  ");
+        }
+        return data[row * stride + col];
+    }
+
+    const T& operator()(size_t row, size_t col) const {
+        if (row >= rows || col >= cols) {
+            throw std::out_of_range("  ");
+        }
+        return data[row * stride + col];
+    }
+
+    ///      
+    bool operator==(const Matrix& other) const {
+        if (rows != other.rows || cols != other.cols) {
+            return false;
+        }
+        for (size_t i = 0; i < rows; i++) {
+            const T* a = rowPtr(i);
+            const T* b = other.rowPtr(i);
+            for (size_t j = 0; j < cols; j++) {
+                if (std::abs(a[j] - b[j]) > std::abs(epsilon)) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    bool operator!=(const Matrix& other) const {
+        return !(*this == other);
+    }
+
+    ///   
+    Matrix operator*(const Matrix& other) const {
+        if (cols != other.rows) {
+            throw std::invalid_argument("        ");
+        }
+        Matrix result(rows, other.cols, Uninitialized{});
+        detail::stridedProduct<T>(rows, other.cols, cols, data, stride, 1, other.data, other.stride, 1, result.data, result.stride);
+        return result;
+    }
+
+    ///   :         
+    Matrix& operator+=(const Matrix& other) {
+        if (rows != other.rows || cols != other.cols) {
+            throw std::invalid_argument("      ");
+        }
+        for (size_t i = 0; i < rows; i++) {
+            simdAdd(rowPtr(i), other.rowPtr(i), rowPtr(i), cols);
+        }
+        return *this;
+    }
+
+    Matrix& operator-=(const Matrix& other) {
+        if (rows != other.rows || cols != other.cols) {
+            throw std::invalid_argument("      ");
+        }
+        for (size_t i = 0; i < rows; i++) {
+            simdSub(rowPtr(i), other.rowPtr(i), rowPtr(i), cols);
+        }
+        return *this;
+    }
+
+    template<typename E>
+    Matrix& operator+=(const MatrixExpr<E>& expr) {
+        if (rows != expr.getRows() || cols != expr.getCols()) {
+            throw std::invalid_argument("      ");
+        }
+        if (expr.self().exprAliases(data, data + rows * stride, stride)) {
+            const Matrix temp(expr);
+            detail::evaluateExpr<detail::AssignAdd>(temp, data, stride);
+            return *this;
+        }
+        detail::evaluateExpr<detail::AssignAdd>(expr.self(), data, stride);
+        return *this;
+    }
+
+    template<typename E>
+    Matrix& operator-=(const MatrixExpr<E>& expr) {
+        if (rows != expr.getRows() || cols != expr.getCols()) {
+            throw std::invalid_argument("      ");
+        }
+        if (expr.self().exprAliases(data, data + rows * stride, stride)) {
+            const Matrix temp(expr);
+            detail::evaluateExpr<detail::AssignSub>(temp, data, stride);
+            return *this;
+        }
+        detail::evaluateExpr<detail::AssignSub>(expr.self(), data, stride);
+        return *this;
+    }
+
+    Matrix& operator*=(T scalar) {
+        for (size_t i = 0; i < rows; i++) {
+            simdScale(rowPtr(i), scalar, rowPtr(i), cols);
+        }
+        return *this;
+    }
+
+    Matrix& operator/=(T scalar) {
+        if (scalar == T()) {
+            throw std::invalid_argument("  ");
+        }
+        for (size_t i = 0; i < rows; i++) {
+            simdDivide(rowPtr(i), scalar, rowPtr(i), cols);
+        }
+        return *this;
+    }
+
+    ///   .   -   .
+    ///     ,     
+    ///     ;       ,  .
+    void transposeInPlace() {
+        if (rows == cols) {
+            transposeSquareInPlace(rows, data, stride);
+            return;
+        }
+        const size_t newStride = alignedStride(rows);
+        if (data == nullptr || cols * newStride > rows * stride) {
+            Matrix result(transposed());
+            swap(*this, result);
+            return;
+        }
+        for (size_t i = 1; i < rows; i++) {
+            std::memmove(data + i * cols, rowPtr(i), cols * sizeof(T));
+        }
+        ::transposeInPlace(rows, cols, data);
+        std::swap(rows, cols);
+        stride = newStride;
+        for (size_t i = rows; i-- > 0;) {
+            std::memmove(rowPtr(i), data + i * cols, cols * sizeof(T));
+            std::fill(rowPtr(i) + cols, rowPtr(i) + stride, T());
+        }
+    }
+
+    ///   
+    T trace() const {
+        if (rows != cols) {
+            throw std::invalid_argument("      ");
+        }
+        T trace = T();
+        for (size_t i = 0; i < rows; i++) {
+            trace += data[i * stride + i];
+        }
+        return trace;
+    }
+
+    ///  
+    friend std::ostream& operator<<(std::ostream& os, const Matrix& matrix) {
+        for (size_t i = 0; i < matrix.rows; i++) {
+            const T* row = matrix.rowPtr(i);
+            for (size_t j = 0; j < matrix.cols; j++) {
+                os << std::setw(10) << row[j] << " ";
+            }
+            os << std::endl;
+        }
+        return os;
+    }
+
+    ///   
+    size_t getRows() const {
+        return rows;
+    }
+
+    ///   
+    size_t getCols() const {
+        return cols;
+    }
+
+    ///      ( )
+    size_t getStride() const {
+        return stride;
+    }
+
+    ///     ( i   getData() + i * getStride())
+    T* getData() {
+        return data;
+    }
+
+    const T* getData() const {
+        return data;
+    }
+
+    ///  i   
+    const T* exprRow(size_t i) const {
+        return rowPtr(i);
+    }
+
+    bool exprAliases(const T* begin, const T* end, size_t outStride) const {
+        return data != nullptr && detail::bufferAliases<T>(data, data + rows * stride, stride, true, begin, end, outStride);
+    }
+
+    ///  blockRows x blockCols     (row, col)  
+    MatrixView<T> block(size_t row, size_t col, size_t blockRows, size_t blockCols) {
+        return MatrixView<T>(*this).block(row, col, blockRows, blockCols);
+    }
+
+    MatrixView<const T> block(size_t row, size_t col, size_t blockRows, size_t blockCols) const {
+        return MatrixView<const T>(*this).block(row, col, blockRows, blockCols);
+    }
+
+    ///  i (1 x cols)   j (rows x 1)
+    MatrixView<T> row(size_t i) {
+        return block(i, 0, 1, cols);
+    }
+
+    MatrixView<const T> row(size_t i) const {
+        return block(i, 0, 1, cols);
+    }
+
+    MatrixView<T> col(size_t j) {
+        return block(0, j, rows, 1);
+    }
+
+    MatrixView<const T> col(size_t j) const {
+        return block(0, j, rows, 1);
+    }
+
+    ///     ( )
+    TransposedView<T> transposed() const {
+        return TransposedView<T>(*this);
+    }
+};
+
+///  ,    
+template<typename E>
+Matrix(const MatrixExpr<E>&) -> Matrix<typename E::value_type>;
+
+
+template<typename T>
+const T Matrix<T>::epsilon = static_cast<T>(1e-5);
+
+
+namespace detail {
+
+///  :    ,     
+template<typename T>
+const Matrix<T>& materialize(const Matrix<T>& matrix) {
+    return matrix;
+}
+
+template<typename E>
+Matrix<typename E::value_type> materialize(const MatrixExpr<E>& expr) {
+    return Matrix<typename E::value_type>(expr);
+}
+
+} // namespace detail
+
+///  : -  ,   gemm
+template<typename L, typename R>
+Matrix<typename L::value_type> operator*(const MatrixExpr<L>& left, const MatrixExpr<R>& right) {
+    const auto& a = detail::materialize(left.self());
+    const auto& b = detail::materialize(right.self());
+    return a * b;
+}
+
+///  
+template<typename E>
+std::ostream& operator<<(std::ostream& os, const MatrixExpr<E>& expr) {
+    return os << Matrix<typename E::value_type>(expr);
+}
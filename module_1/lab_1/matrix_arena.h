@@ -0,0 +1,268 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+
+///    Matrix:      ,  
+///           .  
+/// for (...) { C = A + B * 2; D = C * E; }         
+/// ,     (   , . PackCache  gemm.h).
+///
+///     MatrixArena arena;
+///     {
+///         MatrixArenaScope scope(arena);    //       
+///         for (...) { ... }
+///     }
+///     arena.stats().hitRate();
+///
+///     .         ,
+///            .
+///    ,      ,   :
+///        .
+
+///  
+struct MatrixArenaStats {
+    ///    
+    size_t hits = 0;
+    ///    (      )
+    size_t misses = 0;
+    ///    
+    size_t recycled = 0;
+    ///    -  
+    size_t evicted = 0;
+    ///  ,   
+    size_t liveBlocks = 0;
+    ///        
+    size_t cachedBlocks = 0;
+    size_t cachedBytes = 0;
+
+    double hitRate() const {
+        const size_t total = hits + misses;
+        return total == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(total);
+    }
+};
+
+
+namespace detail {
+
+///   ;      
+inline constexpr size_t matrixBlockAlignment = 64;
+
+struct ArenaState;
+
+///    :  (nullptr - )   
+struct alignas(matrixBlockAlignment) MatrixBlockHeader {
+    ArenaState* arena;
+    size_t bytes;
+};
+
+static_assert(sizeof(MatrixBlockHeader) == matrixBlockAlignment);
+
+inline std::atomic<size_t>& matrixHeapCounter() {
+    static std::atomic<size_t> counter{0};
+    return counter;
+}
+
+inline MatrixBlockHeader* heapBlock(size_t bytes) {
+    if (bytes > SIZE_MAX - sizeof(MatrixBlockHeader)) {
+        throw std::length_error("   ");
+    }
+    void* raw = ::operator new(sizeof(MatrixBlockHeader) + bytes, std::align_val_t(matrixBlockAlignment));
+    matrixHeapCounter().fetch_add(1, std::memory_order_relaxed);
+    return new (raw) MatrixBlockHeader{nullptr, bytes};
+}
+
+inline void freeBlock(MatrixBlockHeader* block) {
+    ::operator delete(static_cast<void*>(block), std::align_val_t(matrixBlockAlignment));
+}
+
+///   . ,         .
+struct ArenaState {
+    std::mutex mutex;
+    std::unordered_map<size_t, std::vector<MatrixBlockHeader*>> free;
+    size_t maxCachedBytes;
+    bool closed = false;
+    MatrixArenaStats stats;
+    ///   +  
+    std::atomic<size_t> refs{1};
+
+    explicit ArenaState(size_t maxCachedBytes) : maxCachedBytes(maxCachedBytes) {}
+
+    ///  ;   mutex
+    void dropCached() {
+        for (auto& [bytes, blocks] : free) {
+            for (MatrixBlockHeader* block : blocks) {
+                freeBlock(block);
+            }
+            blocks.clear();
+        }
+        stats.cachedBlocks = 0;
+        stats.cachedBytes = 0;
+    }
+
+    MatrixBlockHeader* acquire(size_t bytes) {
+        MatrixBlockHeader* block = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto it = free.find(bytes);
+            if (it != free.end() && !it->second.empty()) {
+                block = it->second.back();
+                it->second.pop_back();
+                stats.hits++;
+                stats.cachedBlocks--;
+                stats.cachedBytes -= bytes;
+            }
+            else {
+                stats.misses++;
+            }
+            stats.liveBlocks++;
+        }
+        if (block == nullptr) {
+            try {
+                block = heapBlock(bytes);
+            }
+            catch (...) {
+                std::lock_guard<std::mutex> lock(mutex);
+                stats.liveBlocks--;
+                throw;
+            }
+            block->arena = this;
+        }
+        refs.fetch_add(1, std::memory_order_relaxed);
+        return block;
+    }
+
+    void release(MatrixBlockHeader* block) {
+        bool cached = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stats.liveBlocks--;
+            if (!closed && block->bytes <= maxCachedBytes - stats.cachedBytes) {
+                //         
+                free[block->bytes].push_back(block);
+                stats.recycled++;
+                stats.cachedBlocks++;
+                stats.cachedBytes += block->bytes;
+                cached = true;
+            }
+            else if (!closed) {
+                stats.evicted++;
+            }
+        }
+        if (!cached) {
+            freeBlock(block);
+        }
+        unref();
+    }
+
+    void unref() {
+        if (refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            delete this;
+        }
+    }
+};
+
+/// ,     (nullptr - )
+inline ArenaState*& currentArena() {
+    thread_local ArenaState* arena = nullptr;
+    return arena;
+}
+
+///     bytes,   matrixBlockAlignment
+inline void* matrixAllocate(size_t bytes) {
+    ArenaState* arena = currentArena();
+    MatrixBlockHeader* block = arena != nullptr ? arena->acquire(bytes) : heapBlock(bytes);
+    return block + 1;
+}
+
+inline void matrixDeallocate(void* ptr) {
+    if (ptr == nullptr) {
+        return;
+    }
+    MatrixBlockHeader* block = static_cast<MatrixBlockHeader*>(ptr) - 1;
+    if (block->arena != nullptr) {
+        block->arena->release(block);
+    }
+    else {
+        freeBlock(block);
+    }
+}
+
+} // namespace detail
+
+
+///   ,        (   ).
+///   gemm       
+inline size_t matrixHeapAllocations() {
+    return detail::matrixHeapCounter().load(std::memory_order_relaxed);
+}
+
+///     . maxCachedBytes    
+/// ;    .
+class MatrixArena {
+private:
+    detail::ArenaState* state;
+
+    friend class MatrixArenaScope;
+
+public:
+    explicit MatrixArena(size_t maxCachedBytes = SIZE_MAX) : state(new detail::ArenaState(maxCachedBytes)) {}
+
+    MatrixArena(const MatrixArena&) = delete;
+    MatrixArena& operator=(const MatrixArena&) = delete;
+
+    ///  ;         
+    ~MatrixArena() {
+        {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            state->closed = true;
+            state->dropCached();
+        }
+        state->unref();
+    }
+
+    MatrixArenaStats stats() const {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        return state->stats;
+    }
+
+    ///    (hits, misses, recycled, evicted)
+    void resetStats() {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        state->stats.hits = 0;
+        state->stats.misses = 0;
+        state->stats.recycled = 0;
+        state->stats.evicted = 0;
+    }
+
+    ///      
+    void trim() {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        state->dropCached();
+    }
+};
+
+///         ;    
+class MatrixArenaScope {
+private:
+    detail::ArenaState* previous;
+
+public:
+    explicit MatrixArenaScope(MatrixArena& arena) : previous(detail::currentArena()) {
+        detail::currentArena() = arena.state;
+    }
+
+    MatrixArenaScope(const MatrixArenaScope&) = delete;
+    MatrixArenaScope& operator=(const MatrixArenaScope&) = delete;
+
+    ~MatrixArenaScope() {
+        detail::currentArena() = previous;
+    }
+};
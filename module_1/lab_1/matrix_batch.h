@@ -0,0 +1,483 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "cpu.h"
+#include "gemm.h"
+#include "thread_pool.h"
+#include "fixed_matrix.h"
+
+
+///   count  N x N   " " (SoA):  (i, j) 
+///       ().      ,
+///      4-16   (  SIMD  ).
+///       ,   .
+
+namespace detail {
+
+///  C = A * B   [l0, l1);  e    base + e * capacity
+template<typename T, size_t N>
+inline void batchMultiplyLanes(const T* __restrict a, const T* __restrict b, T* __restrict c,
+    size_t capacity, size_t l0, size_t l1) {
+    for (size_t l = l0; l < l1; l++) {
+        for (size_t i = 0; i < N; i++) {
+            for (size_t j = 0; j < N; j++) {
+                T sum = T();
+                for (size_t k = 0; k < N; k++) {
+                    sum += a[(i * N + k) * capacity + l] * b[(k * N + j) * capacity + l];
+                }
+                c[(i * N + j) * capacity + l] = sum;
+            }
+        }
+    }
+}
+
+///   [l0, l1)
+template<typename T, size_t N>
+inline void batchDetLanes(const T* __restrict a, T* __restrict det, size_t capacity, size_t l0, size_t l1) {
+    const T* p[N * N];
+    for (size_t e = 0; e < N * N; e++) {
+        p[e] = a + e * capacity;
+    }
+    for (size_t l = l0; l < l1; l++) {
+        if constexpr (N == 2) {
+            det[l] = p[0][l] * p[3][l] - p[1][l] * p[2][l];
+        }
+        else {
+            det[l] = p[0][l] * (p[4][l] * p[8][l] - p[7][l] * p[5][l]) -
+                p[1][l] * (p[3][l] * p[8][l] - p[5][l] * p[6][l]) +
+                p[2][l] * (p[3][l] * p[7][l] - p[4][l] * p[6][l]);
+        }
+    }
+}
+
+///   [l0, l1)  ;   -   singular[l] = 1
+template<typename T, size_t N>
+inline void batchInverseLanes(const T* __restrict a, T* __restrict inv, uint8_t* __restrict singular,
+    size_t capacity, size_t l0, size_t l1) {
+    const T* p[N * N];
+    T* q[N * N];
+    for (size_t e = 0; e < N * N; e++) {
+        p[e] = a + e * capacity;
+        q[e] = inv + e * capacity;
+    }
+    for (size_t l = l0; l < l1; l++) {
+        if constexpr (N == 2) {
+            const T d = p[0][l] * p[3][l] - p[1][l] * p[2][l];
+            const bool zero = d == T();
+            const T s = zero ? T() : T(1) / d;
+            q[0][l] = p[3][l] * s;
+            q[1][l] = -p[1][l] * s;
+            q[2][l] = -p[2][l] * s;
+            q[3][l] = p[0][l] * s;
+            singular[l] = zero;
+        }
+        else {
+            const T a00 = p[0][l], a01 = p[1][l], a02 = p[2][l];
+            const T a10 = p[3][l], a11 = p[4][l], a12 = p[5][l];
+            const T a20 = p[6][l], a21 = p[7][l], a22 = p[8][l];
+            const T c00 = a11 * a22 - a21 * a12;
+            const T c10 = a12 * a20 - a10 * a22;
+            const T c20 = a10 * a21 - a20 * a11;
+            const T d = a00 * c00 + a01 * c10 + a02 * c20;
+            const bool zero = d == T();
+            const T s = zero ? T() : T(1) / d;
+            q[0][l] = c00 * s;
+            q[1][l] = (a02 * a21 - a01 * a22) * s;
+            q[2][l] = (a01 * a12 - a02 * a11) * s;
+            q[3][l] = c10 * s;
+            q[4][l] = (a00 * a22 - a02 * a20) * s;
+            q[5][l] = (a10 * a02 - a00 * a12) * s;
+            q[6][l] = c20 * s;
+            q[7][l] = (a20 * a01 - a00 * a21) * s;
+            q[8][l] = (a00 * a11 - a10 * a01) * s;
+            singular[l] = zero;
+        }
+    }
+}
+
+#if MATRIX_X86_DISPATCH
+/// r = a * b - c * d
+template<typename Ops, typename V>
+inline void batchCross(V& r, const V& a, const V& b, const V& c, const V& d) {
+    V t;
+    Ops::mul(r, a, b);
+    Ops::mul(t, c, d);
+    Ops::sub(r, r, t);
+}
+
+///  : W   ,  -  
+template<typename T, size_t N, SimdLevel L>
+inline void batchMultiplySimd(const T* a, const T* b, T* c, size_t capacity, size_t l0, size_t l1) {
+    using Ops = SimdOps<T, L>;
+    using V = typename Ops::V;
+    constexpr size_t W = Ops::W;
+    size_t l = l0;
+    for (; l + W <= l1; l += W) {
+        for (size_t i = 0; i < N; i++) {
+            for (size_t j = 0; j < N; j++) {
+                V acc;
+                Ops::zero(acc);
+                for (size_t k = 0; k < N; k++) {
+                    V x, y;
+                    Ops::load(x, a + (i * N + k) * capacity + l);
+                    Ops::load(y, b + (k * N + j) * capacity + l);
+                    Ops::fma(acc, x, y);
+                }
+                Ops::store(c + (i * N + j) * capacity + l, acc);
+            }
+        }
+    }
+    batchMultiplyLanes<T, N>(a, b, c, capacity, l, l1);
+}
+
+template<typename T, size_t N, SimdLevel L>
+inline void batchDetSimd(const T* a, T* det, size_t capacity, size_t l0, size_t l1) {
+    using Ops = SimdOps<T, L>;
+    using V = typename Ops::V;
+    constexpr size_t W = Ops::W;
+    size_t l = l0;
+    for (; l + W <= l1; l += W) {
+        V m[N * N];
+        for (size_t e = 0; e < N * N; e++) {
+            Ops::load(m[e], a + e * capacity + l);
+        }
+        V d;
+        if constexpr (N == 2) {
+            batchCross<Ops>(d, m[0], m[3], m[1], m[2]);
+        }
+        else {
+            V c00, c10, c20;
+            batchCross<Ops>(c00, m[4], m[8], m[7], m[5]);
+            batchCross<Ops>(c10, m[5], m[6], m[3], m[8]);
+            batchCross<Ops>(c20, m[3], m[7], m[6], m[4]);
+            Ops::mul(d, m[0], c00);
+            Ops::fma(d, m[1], c10);
+            Ops::fma(d, m[2], c20);
+        }
+        Ops::store(det + l, d);
+    }
+    batchDetLanes<T, N>(a, det, capacity, l, l1);
+}
+
+template<typename T, size_t N, SimdLevel L>
+inline void batchInverseSimd(const T* a, T* inv, uint8_t* singular, size_t capacity, size_t l0, size_t l1) {
+    using Ops = SimdOps<T, L>;
+    using V = typename Ops::V;
+    constexpr size_t W = Ops::W;
+    V one;
+    Ops::broadcast(one, T(1));
+    size_t l = l0;
+    for (; l + W <= l1; l += W) {
+        V m[N * N];
+        V r[N * N];
+        for (size_t e = 0; e < N * N; e++) {
+            Ops::load(m[e], a + e * capacity + l);
+        }
+        V d;
+        if constexpr (N == 2) {
+            batchCross<Ops>(d, m[0], m[3], m[1], m[2]);
+            V zero;
+            Ops::zero(zero);
+            r[0] = m[3];
+            Ops::sub(r[1], zero, m[1]);
+            Ops::sub(r[2], zero, m[2]);
+            r[3] = m[0];
+        }
+        else {
+            batchCross<Ops>(r[0], m[4], m[8], m[7], m[5]);
+            batchCross<Ops>(r[1], m[2], m[7], m[1], m[8]);
+            batchCross<Ops>(r[2], m[1], m[5], m[2], m[4]);
+            batchCross<Ops>(r[3], m[5], m[6], m[3], m[8]);
+            batchCross<Ops>(r[4], m[0], m[8], m[2], m[6]);
+            batchCross<Ops>(r[5], m[3], m[2], m[0], m[5]);
+            batchCross<Ops>(r[6], m[3], m[7], m[6], m[4]);
+            batchCross<Ops>(r[7], m[6], m[1], m[0], m[7]);
+            batchCross<Ops>(r[8], m[0], m[4], m[3], m[1]);
+            Ops::mul(d, m[0], r[0]);
+            Ops::fma(d, m[1], r[3]);
+            Ops::fma(d, m[2], r[6]);
+        }
+        //   :     ,
+        //     1,    
+        T dv[W];
+        Ops::store(dv, d);
+        bool any = false;
+        for (size_t w = 0; w < W; w++) {
+            const bool zero = dv[w] == T();
+            singular[l + w] = zero;
+            if (zero) {
+                dv[w] = T(1);
+                any = true;
+            }
+        }
+        if (any) {
+            Ops::load(d, dv);
+        }
+        V s;
+        Ops::div(s, one, d);
+        for (size_t e = 0; e < N * N; e++) {
+            Ops::mul(r[e], r[e], s);
+            Ops::store(inv + e * capacity + l, r[e]);
+        }
+        if (any) {
+            for (size_t w = 0; w < W; w++) {
+                if (singular[l + w]) {
+                    for (size_t e = 0; e < N * N; e++) {
+                        inv[e * capacity + l + w] = T();
+                    }
+                }
+            }
+        }
+    }
+    batchInverseLanes<T, N>(a, inv, singular, capacity, l, l1);
+}
+#endif
+
+template<typename T, size_t N, SimdLevel L>
+struct BatchKernels {
+    static void multiply(const T* a, const T* b, T* c, size_t capacity, size_t l0, size_t l1) {
+#if MATRIX_X86_DISPATCH && defined(__SSE2__)
+        batchMultiplySimd<T, N, SimdLevel::Generic>(a, b, c, capacity, l0, l1);
+#else
+        batchMultiplyLanes<T, N>(a, b, c, capacity, l0, l1);
+#endif
+    }
+
+    static void det(const T* a, T* d, size_t capacity, size_t l0, size_t l1) {
+#if MATRIX_X86_DISPATCH && defined(__SSE2__)
+        batchDetSimd<T, N, SimdLevel::Generic>(a, d, capacity, l0, l1);
+#else
+        batchDetLanes<T, N>(a, d, capacity, l0, l1);
+#endif
+    }
+
+    static void inverse(const T* a, T* inv, uint8_t* singular, size_t capacity, size_t l0, size_t l1) {
+#if MATRIX_X86_DISPATCH && defined(__SSE2__)
+        batchInverseSimd<T, N, SimdLevel::Generic>(a, inv, singular, capacity, l0, l1);
+#else
+        batchInverseLanes<T, N>(a, inv, singular, capacity, l0, l1);
+#endif
+    }
+};
+
+#if MATRIX_X86_DISPATCH
+template<typename T, size_t N>
+struct BatchKernels<T, N, SimdLevel::Avx2> {
+    MATRIX_TARGET("avx2,fma") MATRIX_FLATTEN
+    static void multiply(const T* a, const T* b, T* c, size_t capacity, size_t l0, size_t l1) {
+        batchMultiplySimd<T, N, SimdLevel::Avx2>(a, b, c, capacity, l0, l1);
+    }
+
+    MATRIX_TARGET("avx2,fma") MATRIX_FLATTEN
+    static void det(const T* a, T* d, size_t capacity, size_t l0, size_t l1) {
+        batchDetSimd<T, N, SimdLevel::Avx2>(a, d, capacity, l0, l1);
+    }
+
+    MATRIX_TARGET("avx2,fma") MATRIX_FLATTEN
+    static void inverse(const T* a, T* inv, uint8_t* singular, size_t capacity, size_t l0, size_t l1) {
+        batchInverseSimd<T, N, SimdLevel::Avx2>(a, inv, singular, capacity, l0, l1);
+    }
+};
+
+template<typename T, size_t N>
+struct BatchKernels<T, N, SimdLevel::Avx512> {
+    MATRIX_TARGET("avx512f") MATRIX_FLATTEN
+    static void multiply(const T* a, const T* b, T* c, size_t capacity, size_t l0, size_t l1) {
+        batchMultiplySimd<T, N, SimdLevel::Avx512>(a, b, c, capacity, l0, l1);
+    }
+
+    MATRIX_TARGET("avx512f") MATRIX_FLATTEN
+    static void det(const T* a, T* d, size_t capacity, size_t l0, size_t l1) {
+        batchDetSimd<T, N, SimdLevel::Avx512>(a, d, capacity, l0, l1);
+    }
+
+    MATRIX_TARGET("avx512f") MATRIX_FLATTEN
+    static void inverse(const T* a, T* inv, uint8_t* singular, size_t capacity, size_t l0, size_t l1) {
+        batchInverseSimd<T, N, SimdLevel::Avx512>(a, inv, singular, capacity, l0, l1);
+    }
+};
+#endif
+
+///      
+inline constexpr size_t batchChunk = 1 << 14;
+
+///    SIMD    ,   -  
+template<typename T, size_t N, typename F>
+void batchRun(size_t count, F kernel) {
+    const size_t chunks = (count + batchChunk - 1) / batchChunk;
+    parallelFor(chunks, [&](size_t t) {
+        const size_t l0 = t * batchChunk;
+        const size_t l1 = std::min(count, l0 + batchChunk);
+        switch (simdLevel()) {
+        case SimdLevel::Avx512:
+            kernel(BatchKernels<T, N, SimdLevel::Avx512>{}, l0, l1);
+            return;
+        case SimdLevel::Avx2:
+            kernel(BatchKernels<T, N, SimdLevel::Avx2>{}, l0, l1);
+            return;
+        default:
+            kernel(BatchKernels<T, N, SimdLevel::Generic>{}, l0, l1);
+            return;
+        }
+    });
+}
+
+} // namespace detail
+
+
+template<typename T, size_t N>
+class MatrixBatch {
+    static_assert(std::is_same_v<T, float> || std::is_same_v<T, double>, "    float  double");
+    static_assert(N >= 1 && N <= 8, "    ");
+
+private:
+    size_t count;
+    size_t capacity;  //  : count,    
+    detail::PackBuffer<T> buffer;
+
+    ///   :  ,    
+    struct Uninitialized {};
+
+    MatrixBatch(size_t count, Uninitialized)
+        : count(count), capacity((count + 15) / 16 * 16), buffer(N * N * capacity) {}
+
+public:
+    ///   count  
+    explicit MatrixBatch(size_t count) : MatrixBatch(count, Uninitialized{}) {
+        std::fill_n(buffer.get(), N * N * capacity, T());
+    }
+
+    MatrixBatch(const MatrixBatch& other) : MatrixBatch(other.count, Uninitialized{}) {
+        std::copy_n(other.buffer.get(), N * N * capacity, buffer.get());
+    }
+
+    MatrixBatch(MatrixBatch&& other) noexcept
+        : count(std::exchange(other.count, 0)), capacity(std::exchange(other.capacity, 0)), buffer(std::move(other.buffer)) {}
+
+    MatrixBatch& operator=(MatrixBatch&& other) noexcept {
+        count = std::exchange(other.count, 0);
+        capacity = std::exchange(other.capacity, 0);
+        buffer = std::move(other.buffer);
+        return *this;
+    }
+
+    MatrixBatch& operator=(const MatrixBatch& other) {
+        MatrixBatch copy(other);
+        return *this = std::move(copy);
+    }
+
+    ///  
+    size_t size() const {
+        return count;
+    }
+
+    ///   (row, col): plane(row, col)[k] -  k- 
+    T* plane(size_t row, size_t col) {
+        if (row >= N || col >= N) {
+            throw std::out_of_range("  ");
+        }
+        return buffer.get() + (row * N + col) * capacity;
+    }
+
+    const T* plane(size_t row, size_t col) const {
+        if (row >= N || col >= N) {
+            throw std::out_of_range("  ");
+        }
+        return buffer.get() + (row * N + col) * capacity;
+    }
+
+    ///  k- 
+    FixedMatrix<T, N, N> get(size_t index) const {
+        if (index >= count) {
+            throw std::out_of_range("  ");
+        }
+        FixedMatrix<T, N, N> result;
+        for (size_t e = 0; e < N * N; e++) {
+            result(e / N, e % N) = buffer.get()[e * capacity + index];
+        }
+        return result;
+    }
+
+    ///  k- 
+    void set(size_t index, const FixedMatrix<T, N, N>& matrix) {
+        if (index >= count) {
+            throw std::out_of_range("  ");
+        }
+        for (size_t e = 0; e < N * N; e++) {
+            buffer.get()[e * capacity + index] = matrix(e / N, e % N);
+        }
+    }
+
+    ///      result (  ).
+    /// result     .
+    void multiply(const MatrixBatch& other, MatrixBatch& result) const {
+        if (count != other.count) {
+            throw std::invalid_argument("     ");
+        }
+        if (result.count != count) {
+            result = MatrixBatch(count, Uninitialized{});
+        }
+        const T* a = buffer.get();
+        const T* b = other.buffer.get();
+        T* c = result.buffer.get();
+        const size_t cap = capacity;
+        detail::batchRun<T, N>(count, [=](auto kernels, size_t l0, size_t l1) {
+            kernels.multiply(a, b, c, cap, l0, l1);
+        });
+    }
+
+    ///     
+    MatrixBatch operator*(const MatrixBatch& other) const {
+        MatrixBatch result(count, Uninitialized{});
+        multiply(other, result);
+        return result;
+    }
+
+    ///    (N = 2  3)
+    void det(std::vector<T>& result) const {
+        static_assert(N == 2 || N == 3, "    2x2  3x3");
+        result.resize(count);
+        const T* a = buffer.get();
+        T* d = result.data();
+        const size_t cap = capacity;
+        detail::batchRun<T, N>(count, [=](auto kernels, size_t l0, size_t l1) {
+            kernels.det(a, d, cap, l0, l1);
+        });
+    }
+
+    std::vector<T> det() const {
+        std::vector<T> result;
+        det(result);
+        return result;
+    }
+
+    ///   (N = 2  3)    result.
+    /// singular[k] = 1,  k-   (  - )
+    void inverse(MatrixBatch& result, std::vector<uint8_t>& singular) const {
+        static_assert(N == 2 || N == 3, "    2x2  3x3");
+        if (result.count != count) {
+            result = MatrixBatch(count, Uninitialized{});
+        }
+        singular.resize(count);
+        const T* a = buffer.get();
+        T* inv = result.buffer.get();
+        uint8_t* flags = singular.data();
+        const size_t cap = capacity;
+        detail::batchRun<T, N>(count, [=](auto kernels, size_t l0, size_t l1) {
+            kernels.inverse(a, inv, flags, cap, l0, l1);
+        });
+    }
+
+    MatrixBatch inverse(std::vector<uint8_t>& singular) const {
+        MatrixBatch result(count, Uninitialized{});
+        inverse(result, singular);
+        return result;
+    }
+};
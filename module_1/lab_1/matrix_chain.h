@@ -0,0 +1,177 @@
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "matrix.h"
+#include "thread_pool.h"
+
+
+///   A0 * A1 * ... * An-1   .
+///         
+/// (O(n^3)   ):     (1000 x 2)(2 x 1000)(1000 x 2)
+///       .    
+///    :  - ,  -   ;  
+///  gemm      .
+
+///    ; dims[i] x dims[i + 1] -  i- 
+class ChainOrder {
+private:
+    size_t count;
+    std::vector<double> costs;
+    std::vector<size_t> splits;
+
+    size_t at(size_t i, size_t j) const {
+        return i * count + j;
+    }
+
+    void describe(size_t i, size_t j, std::string& out) const {
+        if (i == j) {
+            out += 'A';
+            out += std::to_string(i);
+            return;
+        }
+        const size_t k = split(i, j);
+        out += '(';
+        describe(i, k, out);
+        out += " * ";
+        describe(k + 1, j, out);
+        out += ')';
+    }
+
+public:
+    explicit ChainOrder(const std::vector<size_t>& dims)
+        : count(dims.size() < 2 ? 0 : dims.size() - 1), costs(count * count, 0.0), splits(count * count, 0) {
+        if (count == 0) {
+            throw std::invalid_argument("  ");
+        }
+        // costs(i, j) -    Ai..Aj;     
+        for (size_t length = 2; length <= count; length++) {
+            for (size_t i = 0; i + length <= count; i++) {
+                const size_t j = i + length - 1;
+                double best = std::numeric_limits<double>::infinity();
+                size_t bestSplit = i;
+                for (size_t k = i; k < j; k++) {
+                    const double cost = costs[at(i, k)] + costs[at(k + 1, j)] + double(dims[i]) * dims[k + 1] * dims[j + 1];
+                    if (cost < best) {
+                        best = cost;
+                        bestSplit = k;
+                    }
+                }
+                costs[at(i, j)] = best;
+                splits[at(i, j)] = bestSplit;
+            }
+        }
+    }
+
+    ///    
+    size_t size() const {
+        return count;
+    }
+
+    ///     Ai..Aj    (  -  )
+    double cost(size_t i, size_t j) const {
+        if (i > j || j >= count) {
+            throw std::out_of_range("  ");
+        }
+        return costs[at(i, j)];
+    }
+
+    double cost() const {
+        return cost(0, count - 1);
+    }
+
+    ///    Ai..Aj (i < j): (Ai..Ak) * (Ak+1..Aj)
+    size_t split(size_t i, size_t j) const {
+        if (i >= j || j >= count) {
+            throw std::out_of_range("  ");
+        }
+        return splits[at(i, j)];
+    }
+
+    ///  ,  "((A0 * A1) * A2)"
+    std::string toString() const {
+        std::string out;
+        describe(0, count - 1, out);
+        return out;
+    }
+};
+
+
+namespace detail {
+
+///          
+inline constexpr double chainTaskMinCost = 1 << 18;
+
+template<typename T>
+std::vector<size_t> chainDims(const std::vector<const Matrix<T>*>& matrices) {
+    if (matrices.empty()) {
+        throw std::invalid_argument("  ");
+    }
+    std::vector<size_t> dims;
+    dims.reserve(matrices.size() + 1);
+    dims.push_back(matrices.front()->getRows());
+    for (const Matrix<T>* m : matrices) {
+        if (m->getRows() != dims.back()) {
+            throw std::invalid_argument("        ");
+        }
+        dims.push_back(m->getCols());
+    }
+    return dims;
+}
+
+///  Ai..Aj (i < j)   order
+template<typename T>
+Matrix<T> chainProduct(const std::vector<const Matrix<T>*>& matrices, const ChainOrder& order, size_t i, size_t j) {
+    const size_t k = order.split(i, j);
+    const bool leftLeaf = k == i;
+    const bool rightLeaf = k + 1 == j;
+    std::optional<Matrix<T>> left, right;
+    if (!leftLeaf && !rightLeaf && threadPool().size() > 1 &&
+        order.cost(i, k) >= chainTaskMinCost && order.cost(k + 1, j) >= chainTaskMinCost) {
+        TaskGroup group(threadPool());
+        group.run([&] { left.emplace(chainProduct(matrices, order, i, k)); });
+        right.emplace(chainProduct(matrices, order, k + 1, j));
+        group.wait();
+    }
+    else {
+        if (!leftLeaf) {
+            left.emplace(chainProduct(matrices, order, i, k));
+        }
+        if (!rightLeaf) {
+            right.emplace(chainProduct(matrices, order, k + 1, j));
+        }
+    }
+    const Matrix<T>& a = leftLeaf ? *matrices[i] : *left;
+    const Matrix<T>& b = rightLeaf ? *matrices[j] : *right;
+    return a * b;
+}
+
+} // namespace detail
+
+
+///     
+template<typename T>
+ChainOrder chainOrder(const std::vector<const Matrix<T>*>& matrices) {
+    return ChainOrder(detail::chainDims(matrices));
+}
+
+///      
+template<typename T>
+Matrix<T> multiplyChain(const std::vector<const Matrix<T>*>& matrices) {
+    const ChainOrder order = chainOrder(matrices);
+    if (order.size() == 1) {
+        return *matrices.front();
+    }
+    return detail::chainProduct(matrices, order, 0, order.size() - 1);
+}
+
+/// multiplyChain(a, b, c, d) == a * b * c * d    
+template<typename T, typename... Rest>
+Matrix<T> multiplyChain(const Matrix<T>& first, const Rest&... rest) {
+    return multiplyChain(std::vector<const Matrix<T>*>{&first, &rest...});
+}
@@ -0,0 +1,330 @@
+#pragma once
+
+#include <cstddef>
+#include <algorithm>
+#include <complex>
+#include <functional>
+#include <iostream>
+#include <stdexcept>
+#include <type_traits>
+
+#include "cpu.h"
+#include "thread_pool.h"
+
+
+///     (expression templates).
+/// A + B, A - B, A * s, s * A, A / s   ,    ; 
+///       Matrix,   .
+///   -  ,      auto
+///    -     .
+
+template<typename T>
+class Matrix;
+
+template<typename T>
+class MatrixView;
+
+template<typename T>
+class TransposedView;
+
+///    (CRTP).   value_type, getRows(), getCols(),
+/// exprRow(i) - ,   operator[](j)   (i, j), 
+/// exprAliases(begin, end, stride) -       [begin, end)
+///    stride      .
+template<typename E>
+struct MatrixExpr {
+    const E& self() const {
+        return static_cast<const E&>(*this);
+    }
+
+    size_t getRows() const {
+        return self().getRows();
+    }
+
+    size_t getCols() const {
+        return self().getCols();
+    }
+};
+
+namespace detail {
+
+///      ,   -  
+template<typename E>
+struct ExprOperand {
+    using type = const E;
+};
+
+template<typename T>
+struct ExprOperand<Matrix<T>> {
+    using type = const Matrix<T>&;
+};
+
+struct ExprAdd {
+    template<typename T>
+    static T apply(const T& a, const T& b) { return a + b; }
+};
+
+struct ExprSub {
+    template<typename T>
+    static T apply(const T& a, const T& b) { return a - b; }
+};
+
+///   ;  -      inf/NaN,   
+struct ExprScale {
+    template<typename T>
+    static T apply(const T& a, const T& s) {
+        if constexpr (std::is_same_v<T, std::complex<float>> || std::is_same_v<T, std::complex<double>>) {
+            return T(a.real() * s.real() - a.imag() * s.imag(), a.real() * s.imag() + a.imag() * s.real());
+        }
+        else {
+            return a * s;
+        }
+    }
+};
+
+struct ExprDivide {
+    template<typename T>
+    static T apply(const T& a, const T& s) { return a / s; }
+};
+
+template<typename Op, typename LRow, typename RRow>
+struct BinaryRow {
+    LRow l;
+    RRow r;
+    auto operator[](size_t j) const {
+        return Op::apply(l[j], r[j]);
+    }
+};
+
+///      (  )
+template<typename T>
+struct StridedRow {
+    const T* data;
+    size_t step;
+    const T& operator[](size_t j) const {
+        return data[j * step];
+    }
+};
+
+///  [first, last)    readStride    [begin, end)    stride.
+/// ,            ,
+///     (  ,   ,    ).
+template<typename T>
+bool bufferAliases(const T* first, const T* last, size_t readStride, bool unitColumns,
+    const T* begin, const T* end, size_t stride) {
+    const std::less<const T*> less;
+    if (!less(begin, last) || !less(first, end)) {
+        return false;
+    }
+    return !(unitColumns && first == begin && readStride == stride);
+}
+
+template<typename Op, typename Row, typename T>
+struct ScalarRow {
+    Row row;
+    T scalar;
+    T operator[](size_t j) const {
+        return Op::apply(T(row[j]), scalar);
+    }
+};
+
+} // namespace detail
+
+
+///  L op R        
+template<typename Op, typename L, typename R>
+class BinaryExpr : public MatrixExpr<BinaryExpr<Op, L, R>> {
+private:
+    typename detail::ExprOperand<L>::type left;
+    typename detail::ExprOperand<R>::type right;
+
+public:
+    using value_type = typename L::value_type;
+    static_assert(std::is_same_v<value_type, typename R::value_type>, "    ");
+
+    BinaryExpr(const L& left, const R& right) : left(left), right(right) {
+        if (left.getRows() != right.getRows() || left.getCols() != right.getCols()) {
+            throw std::invalid_argument("      ");
+        }
+    }
+
+    size_t getRows() const {
+        return left.getRows();
+    }
+
+    size_t getCols() const {
+        return left.getCols();
+    }
+
+    auto exprRow(size_t i) const {
+        using LRow = decltype(left.exprRow(i));
+        using RRow = decltype(right.exprRow(i));
+        return detail::BinaryRow<Op, LRow, RRow>{left.exprRow(i), right.exprRow(i)};
+    }
+
+    bool exprAliases(const value_type* begin, const value_type* end, size_t stride) const {
+        return left.exprAliases(begin, end, stride) || right.exprAliases(begin, end, stride);
+    }
+};
+
+///  E op s      
+template<typename Op, typename E>
+class ScalarExpr : public MatrixExpr<ScalarExpr<Op, E>> {
+public:
+    using value_type = typename E::value_type;
+
+private:
+    typename detail::ExprOperand<E>::type expr;
+    value_type scalar;
+
+public:
+    ScalarExpr(const E& expr, value_type scalar) : expr(expr), scalar(scalar) {}
+
+    size_t getRows() const {
+        return expr.getRows();
+    }
+
+    size_t getCols() const {
+        return expr.getCols();
+    }
+
+    auto exprRow(size_t i) const {
+        using Row = decltype(expr.exprRow(i));
+        return detail::ScalarRow<Op, Row, value_type>{expr.exprRow(i), scalar};
+    }
+
+    bool exprAliases(const value_type* begin, const value_type* end, size_t stride) const {
+        return expr.exprAliases(begin, end, stride);
+    }
+};
+
+
+template<typename L, typename R>
+BinaryExpr<detail::ExprAdd, L, R> operator+(const MatrixExpr<L>& left, const MatrixExpr<R>& right) {
+    return BinaryExpr<detail::ExprAdd, L, R>(left.self(), right.self());
+}
+
+template<typename L, typename R>
+BinaryExpr<detail::ExprSub, L, R> operator-(const MatrixExpr<L>& left, const MatrixExpr<R>& right) {
+    return BinaryExpr<detail::ExprSub, L, R>(left.self(), right.self());
+}
+
+template<typename E>
+ScalarExpr<detail::ExprScale, E> operator*(const MatrixExpr<E>& expr, typename E::value_type scalar) {
+    return ScalarExpr<detail::ExprScale, E>(expr.self(), scalar);
+}
+
+template<typename E>
+ScalarExpr<detail::ExprScale, E> operator*(typename E::value_type scalar, const MatrixExpr<E>& expr) {
+    return ScalarExpr<detail::ExprScale, E>(expr.self(), scalar);
+}
+
+///   ;       1 / s
+template<typename E>
+auto operator/(const MatrixExpr<E>& expr, typename E::value_type scalar) {
+    using T = typename E::value_type;
+    if (scalar == T()) {
+        throw std::invalid_argument("  ");
+    }
+    if constexpr (std::is_same_v<T, std::complex<float>> || std::is_same_v<T, std::complex<double>>) {
+        return ScalarExpr<detail::ExprScale, E>(expr.self(), T(1) / scalar);
+    }
+    else {
+        return ScalarExpr<detail::ExprDivide, E>(expr.self(), scalar);
+    }
+}
+
+
+namespace detail {
+
+struct AssignSet {
+    template<typename T, typename V>
+    static void apply(T& dst, const V& v) { dst = v; }
+};
+
+struct AssignAdd {
+    template<typename T, typename V>
+    static void apply(T& dst, const V& v) { dst += v; }
+};
+
+struct AssignSub {
+    template<typename T, typename V>
+    static void apply(T& dst, const V& v) { dst -= v; }
+};
+
+///    [r0, r1):      ,
+///       
+template<typename Assign, typename E, typename T>
+inline void evalRows(const E& expr, T* out, size_t stride, size_t r0, size_t r1) {
+    const size_t cols = expr.getCols();
+    for (size_t i = r0; i < r1; i++) {
+        const auto row = expr.exprRow(i);
+        T* dst = out + i * stride;
+        for (size_t j = 0; j < cols; j++) {
+            Assign::apply(dst[j], row[j]);
+        }
+    }
+}
+
+template<typename Assign, typename E, typename T, SimdLevel L>
+struct ExprKernel {
+    static void run(const E& expr, T* out, size_t stride, size_t r0, size_t r1) {
+        evalRows<Assign>(expr, out, stride, r0, r1);
+    }
+};
+
+#if MATRIX_X86_DISPATCH
+template<typename Assign, typename E, typename T>
+struct ExprKernel<Assign, E, T, SimdLevel::Avx2> {
+    MATRIX_TARGET("avx2,fma") MATRIX_FLATTEN
+    static void run(const E& expr, T* out, size_t stride, size_t r0, size_t r1) {
+        evalRows<Assign>(expr, out, stride, r0, r1);
+    }
+};
+
+template<typename Assign, typename E, typename T>
+struct ExprKernel<Assign, E, T, SimdLevel::Avx512> {
+    MATRIX_TARGET("avx512f") MATRIX_FLATTEN
+    static void run(const E& expr, T* out, size_t stride, size_t r0, size_t r1) {
+        evalRows<Assign>(expr, out, stride, r0, r1);
+    }
+};
+#endif
+
+template<typename Assign, typename E, typename T>
+void evalRowsDispatch(const E& expr, T* out, size_t stride, size_t r0, size_t r1) {
+    switch (simdLevel()) {
+    case SimdLevel::Avx512:
+        ExprKernel<Assign, E, T, SimdLevel::Avx512>::run(expr, out, stride, r0, r1);
+        return;
+    case SimdLevel::Avx2:
+        ExprKernel<Assign, E, T, SimdLevel::Avx2>::run(expr, out, stride, r0, r1);
+        return;
+    default:
+        ExprKernel<Assign, E, T, SimdLevel::Generic>::run(expr, out, stride, r0, r1);
+        return;
+    }
+}
+
+///   ,      
+inline constexpr size_t exprParallelElements = 1 << 18;
+
+///     out (   stride)  .
+///     -:  (i, j)    (i, j) .
+template<typename Assign, typename E, typename T>
+void evaluateExpr(const E& expr, T* out, size_t stride) {
+    const size_t rows = expr.getRows();
+    const size_t cols = expr.getCols();
+    if (rows * cols < exprParallelElements || threadPool().size() == 1) {
+        evalRowsDispatch<Assign>(expr, out, stride, 0, rows);
+        return;
+    }
+    const size_t rowsPerTask = std::max<size_t>(1, (exprParallelElements / 4) / std::max<size_t>(cols, 1));
+    const size_t tasks = (rows + rowsPerTask - 1) / rowsPerTask;
+    parallelFor(tasks, [&](size_t t) {
+        const size_t r0 = t * rowsPerTask;
+        evalRowsDispatch<Assign>(expr, out, stride, r0, std::min(rows, r0 + rowsPerTask));
+    });
+}
+
+} // namespace detail
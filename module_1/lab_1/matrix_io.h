@@ -0,0 +1,449 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <complex>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "matrix.h"
+
+
+///     .
+/// :  MatrixFileHeader,    dataOffset (4096 -  ),
+///      ,      Matrix<T>: rows   stride ,
+///     64 .   -   write ,
+///  -  read    ,   mmap    ,   .
+///   -   ;        .
+
+///     
+enum class MatrixElementType : uint32_t {
+    Float32 = 1,
+    Float64 = 2,
+    Complex64 = 3,
+    Complex128 = 4,
+    Int32 = 5,
+    Int64 = 6
+};
+
+///   (64 )
+struct MatrixFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint32_t elementType;
+    uint32_t elementSize;
+    uint32_t alignment;
+    uint32_t reserved;
+    uint64_t rows;
+    uint64_t cols;
+    uint64_t stride;
+    uint64_t dataOffset;
+};
+
+static_assert(sizeof(MatrixFileHeader) == 64, "     64 ");
+
+namespace detail {
+
+inline constexpr char matrixFileMagic[8] = {'L', 'A', 'B', 'M', 'T', 'R', 'X', '\0'};
+inline constexpr uint32_t matrixFileVersion = 1;
+inline constexpr uint32_t matrixFileByteOrder = 0x01020304;
+inline constexpr uint64_t matrixFileDataOffset = 4096;
+///    /:        
+inline constexpr size_t matrixFileChunk = size_t(64) << 20;
+
+template<typename T>
+constexpr MatrixElementType matrixElementType() {
+    if constexpr (std::is_same_v<T, float>) {
+        return MatrixElementType::Float32;
+    }
+    else if constexpr (std::is_same_v<T, double>) {
+        return MatrixElementType::Float64;
+    }
+    else if constexpr (std::is_same_v<T, std::complex<float>>) {
+        return MatrixElementType::Complex64;
+    }
+    else if constexpr (std::is_same_v<T, std::complex<double>>) {
+        return MatrixElementType::Complex128;
+    }
+    else if constexpr (std::is_same_v<T, int32_t>) {
+        return MatrixElementType::Int32;
+    }
+    else {
+        static_assert(std::is_same_v<T, int64_t>, "     ");
+        return MatrixElementType::Int64;
+    }
+}
+
+///  : , ,  ,     
+template<typename T>
+void checkMatrixHeader(const MatrixFileHeader& header, uint64_t fileSize, const std::string& path) {
+    if (std::memcmp(header.magic, matrixFileMagic, sizeof(header.magic)) != 0) {
+        throw std::runtime_error(" " + path + "    ");
+    }
+    if (header.byteOrder != matrixFileByteOrder) {
+        throw std::runtime_error(" " + path + "     ");
+    }
+    if (header.version != matrixFileVersion) {
+        throw std::runtime_error("    " + std::to_string(header.version));
+    }
+    if (header.elementType != uint32_t(matrixElementType<T>()) || header.elementSize != sizeof(T)) {
+        throw std::invalid_argument("    " + path + "     ");
+    }
+    if (header.stride < header.cols || header.dataOffset < sizeof(MatrixFileHeader)
+        || (header.rows != 0 && header.stride > (UINT64_MAX - header.dataOffset) / sizeof(T) / header.rows)
+        || header.dataOffset + header.rows * header.stride * sizeof(T) > fileSize) {
+        throw std::runtime_error(" " + path + " :     ");
+    }
+}
+
+///       
+class FileMapping {
+private:
+    const unsigned char* address = nullptr;
+    size_t length = 0;
+#if defined(_WIN32)
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#endif
+
+    void release() noexcept {
+#if defined(_WIN32)
+        if (address != nullptr) {
+            UnmapViewOfFile(address);
+        }
+        if (mapping != nullptr) {
+            CloseHandle(mapping);
+        }
+        if (file != INVALID_HANDLE_VALUE) {
+            CloseHandle(file);
+        }
+        mapping = nullptr;
+        file = INVALID_HANDLE_VALUE;
+#else
+        if (address != nullptr) {
+            munmap(const_cast<unsigned char*>(address), length);
+        }
+#endif
+        address = nullptr;
+        length = 0;
+    }
+
+public:
+    FileMapping() = default;
+
+    explicit FileMapping(const std::string& path) {
+#if defined(_WIN32)
+        file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+            FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            throw std::runtime_error("    " + path);
+        }
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size)) {
+            release();
+            throw std::runtime_error("     " + path);
+        }
+        length = size_t(size.QuadPart);
+        if (length != 0) {
+            mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            address = mapping != nullptr
+                ? static_cast<const unsigned char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0)) : nullptr;
+            if (address == nullptr) {
+                release();
+                throw std::runtime_error("    " + path + "  ");
+            }
+        }
+#else
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("    " + path);
+        }
+        struct stat info;
+        if (::fstat(fd, &info) != 0) {
+            ::close(fd);
+            throw std::runtime_error("     " + path);
+        }
+        length = size_t(info.st_size);
+        if (length != 0) {
+            void* mapped = ::mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+            if (mapped == MAP_FAILED) {
+                ::close(fd);
+                length = 0;
+                throw std::runtime_error("    " + path + "  ");
+            }
+            address = static_cast<const unsigned char*>(mapped);
+        }
+        //       
+        ::close(fd);
+#endif
+    }
+
+    FileMapping(const FileMapping&) = delete;
+    FileMapping& operator=(const FileMapping&) = delete;
+
+    FileMapping(FileMapping&& other) noexcept
+        : address(std::exchange(other.address, nullptr)), length(std::exchange(other.length, 0))
+#if defined(_WIN32)
+        , file(std::exchange(other.file, INVALID_HANDLE_VALUE)), mapping(std::exchange(other.mapping, nullptr))
+#endif
+    {}
+
+    FileMapping& operator=(FileMapping&& other) noexcept {
+        if (this != &other) {
+            release();
+            address = std::exchange(other.address, nullptr);
+            length = std::exchange(other.length, 0);
+#if defined(_WIN32)
+            file = std::exchange(other.file, INVALID_HANDLE_VALUE);
+            mapping = std::exchange(other.mapping, nullptr);
+#endif
+        }
+        return *this;
+    }
+
+    ~FileMapping() {
+        release();
+    }
+
+    ///  :    ,     
+    void prefetch(size_t offset, size_t count) const {
+#if !defined(_WIN32) && defined(MADV_WILLNEED)
+        if (address != nullptr && count != 0) {
+            const size_t page = size_t(::sysconf(_SC_PAGESIZE));
+            const size_t begin = offset / page * page;
+            ::madvise(const_cast<unsigned char*>(address) + begin, offset + count - begin, MADV_WILLNEED);
+        }
+#else
+        (void)offset;
+        (void)count;
+#endif
+    }
+
+    const unsigned char* data() const {
+        return address;
+    }
+
+    size_t size() const {
+        return length;
+    }
+};
+
+} // namespace detail
+
+
+///     
+template<typename T>
+void saveMatrix(const Matrix<T>& matrix, const std::string& path) {
+    MatrixFileHeader header = {};
+    std::memcpy(header.magic, detail::matrixFileMagic, sizeof(header.magic));
+    header.version = detail::matrixFileVersion;
+    header.byteOrder = detail::matrixFileByteOrder;
+    header.elementType = uint32_t(detail::matrixElementType<T>());
+    header.elementSize = sizeof(T);
+    header.alignment = Matrix<T>::alignment;
+    header.rows = matrix.getRows();
+    header.cols = matrix.getCols();
+    header.stride = matrix.getStride();
+    header.dataOffset = detail::matrixFileDataOffset;
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        throw std::runtime_error("    " + path + "  ");
+    }
+    char padding[detail::matrixFileDataOffset] = {};
+    std::memcpy(padding, &header, sizeof(header));
+    file.write(padding, sizeof(padding));
+
+    //    Matrix ,    ,    
+    const char* bytes = reinterpret_cast<const char*>(matrix.getData());
+    size_t remaining = matrix.getRows() * matrix.getStride() * sizeof(T);
+    while (remaining != 0 && file) {
+        const size_t chunk = std::min(remaining, detail::matrixFileChunk);
+        file.write(bytes, std::streamsize(chunk));
+        bytes += chunk;
+        remaining -= chunk;
+    }
+    file.flush();
+    if (!file) {
+        throw std::runtime_error("    " + path);
+    }
+}
+
+///       
+template<typename T>
+Matrix<T> loadMatrix(const std::string& path) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) {
+        throw std::runtime_error("    " + path);
+    }
+    const uint64_t fileSize = uint64_t(file.tellg());
+    file.seekg(0);
+    MatrixFileHeader header = {};
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+        throw std::runtime_error(" " + path + "    ");
+    }
+    detail::checkMatrixHeader<T>(header, fileSize, path);
+
+    Matrix<T> result(header.rows, header.cols, typename Matrix<T>::Uninitialized{});
+    file.seekg(std::streamoff(header.dataOffset));
+    if (header.stride == result.getStride()) {
+        char* bytes = reinterpret_cast<char*>(result.getData());
+        size_t remaining = result.getRows() * result.getStride() * sizeof(T);
+        while (remaining != 0 && file) {
+            const size_t chunk = std::min(remaining, detail::matrixFileChunk);
+            file.read(bytes, std::streamsize(chunk));
+            bytes += chunk;
+            remaining -= chunk;
+        }
+    }
+    else {
+        //      :   ,  
+        for (size_t i = 0; i < result.getRows() && file; i++) {
+            file.read(reinterpret_cast<char*>(result.getData() + i * result.getStride()), std::streamsize(header.cols * sizeof(T)));
+            file.seekg(std::streamoff((header.stride - header.cols) * sizeof(T)), std::ios::cur);
+        }
+    }
+    if (!file) {
+        throw std::runtime_error("   " + path);
+    }
+    return result;
+}
+
+
+///    ,      (mmap)  .
+///        :  
+///     .       Matrix
+/// (Matrix<T> c = mapped + b),   gemm    .
+template<typename T>
+class MappedMatrix : public MatrixExpr<MappedMatrix<T>> {
+public:
+    using value_type = T;
+
+private:
+    detail::FileMapping mapping;
+    size_t rows = 0;
+    size_t cols = 0;
+    size_t stride = 0;
+    size_t offset = 0;
+    const T* data = nullptr;
+
+public:
+    explicit MappedMatrix(const std::string& path) : mapping(path) {
+        if (mapping.size() < sizeof(MatrixFileHeader)) {
+            throw std::runtime_error(" " + path + "    ");
+        }
+        MatrixFileHeader header;
+        std::memcpy(&header, mapping.data(), sizeof(header));
+        detail::checkMatrixHeader<T>(header, mapping.size(), path);
+        if (header.dataOffset % alignof(T) != 0) {
+            throw std::runtime_error("   " + path + "      ");
+        }
+        rows = header.rows;
+        cols = header.cols;
+        stride = header.stride;
+        offset = header.dataOffset;
+        data = rows != 0 ? reinterpret_cast<const T*>(mapping.data() + header.dataOffset) : nullptr;
+    }
+
+    /// :     (0 x 0,  )
+    MappedMatrix(MappedMatrix&& other) noexcept
+        : mapping(std::move(other.mapping)), rows(std::exchange(other.rows, 0)), cols(std::exchange(other.cols, 0)),
+          stride(std::exchange(other.stride, 0)), offset(std::exchange(other.offset, 0)), data(std::exchange(other.data, nullptr)) {}
+
+    MappedMatrix& operator=(MappedMatrix&& other) noexcept {
+        if (this != &other) {
+            mapping = std::move(other.mapping);
+            rows = std::exchange(other.rows, 0);
+            cols = std::exchange(other.cols, 0);
+            stride = std::exchange(other.stride, 0);
+            offset = std::exchange(other.offset, 0);
+            data = std::exchange(other.data, nullptr);
+        }
+        return *this;
+    }
+
+    ///    ( )
+    const T& operator()(size_t row, size_t col) const {
+        if (row >= rows || col >= cols) {
+            throw std::out_of_range("  ");
+        }
+        return data[row * stride + col];
+    }
+
+    ///      ( )
+    MatrixView<const T> block(size_t row, size_t col, size_t blockRows, size_t blockCols) const {
+        return MatrixView<const T>(data, rows, cols, stride).block(row, col, blockRows, blockCols);
+    }
+
+    TransposedView<T> transposed() const {
+        return TransposedView<T>(data, cols, rows, stride);
+    }
+
+    ///   [row0, row0 + count)   
+    void prefetchRows(size_t row0, size_t count) const {
+        if (row0 < rows) {
+            count = std::min(count, rows - row0);
+            mapping.prefetch(offset + row0 * stride * sizeof(T), count * stride * sizeof(T));
+        }
+    }
+
+    size_t getRows() const {
+        return rows;
+    }
+
+    size_t getCols() const {
+        return cols;
+    }
+
+    size_t getStride() const {
+        return stride;
+    }
+
+    const T* getData() const {
+        return data;
+    }
+
+    const T* exprRow(size_t i) const {
+        return data + i * stride;
+    }
+
+    ///         
+    bool exprAliases(const T*, const T*, size_t) const {
+        return false;
+    }
+};
+
+namespace detail {
+
+///    ,       
+template<typename T>
+struct ExprOperand<MappedMatrix<T>> {
+    using type = const MappedMatrix<T>&;
+};
+
+///       gemm   
+template<typename T>
+struct StridedOperand<MappedMatrix<T>> {
+    static constexpr bool value = true;
+    static const T* data(const MappedMatrix<T>& m) { return m.getData(); }
+    static size_t rowStride(const MappedMatrix<T>& m) { return m.getStride(); }
+    static size_t colStride(const MappedMatrix<T>&) { return 1; }
+};
+
+} // namespace detail
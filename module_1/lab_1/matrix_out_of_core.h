@@ -0,0 +1,403 @@
+#pragma once
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <future>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "matrix.h"
+#include "matrix_io.h"
+#include "gemm.h"
+
+
+///  ,    : C = A * B     matrix_io.h.
+/// C    tileRows x tileCols,   -   tileDepth;   
+///     A (tileRows x tileDepth)   B (tileDepth x tileCols),  gemm
+///      C.     (pread)  
+///  :  gemm   ,      
+///  .   C      ,   .
+/// ,     (,  A,  tileDepth   k),  .
+
+///   
+struct OutOfCoreOptions {
+    ///        (   A, B  C)
+    size_t memoryBudget = size_t(256) << 20;
+    ///  ; 0 -    ( ,    )
+    size_t tileRows = 0;
+    size_t tileCols = 0;
+    size_t tileDepth = 0;
+};
+
+///   
+struct OutOfCoreStats {
+    size_t tileRows = 0;
+    size_t tileCols = 0;
+    size_t tileDepth = 0;
+    uint64_t bytesRead = 0;
+    uint64_t bytesWritten = 0;
+    /// ,        
+    double ioWaitSeconds = 0;
+    double totalSeconds = 0;
+};
+
+
+namespace detail {
+
+///       (     )
+class MatrixFile {
+private:
+#if defined(_WIN32)
+    HANDLE file = INVALID_HANDLE_VALUE;
+#else
+    int fd = -1;
+#endif
+    std::string path;
+
+public:
+    MatrixFile(const std::string& path, bool writable) : path(path) {
+#if defined(_WIN32)
+        file = CreateFileA(path.c_str(), writable ? GENERIC_READ | GENERIC_WRITE : GENERIC_READ, FILE_SHARE_READ,
+            nullptr, writable ? CREATE_ALWAYS : OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            throw std::runtime_error("    " + path);
+        }
+#else
+        fd = writable ? ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644) : ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("    " + path);
+        }
+#endif
+    }
+
+    MatrixFile(const MatrixFile&) = delete;
+    MatrixFile& operator=(const MatrixFile&) = delete;
+
+    ~MatrixFile() {
+#if defined(_WIN32)
+        CloseHandle(file);
+#else
+        ::close(fd);
+#endif
+    }
+
+    const std::string& getPath() const {
+        return path;
+    }
+
+    uint64_t size() const {
+#if defined(_WIN32)
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size)) {
+            throw std::runtime_error("     " + path);
+        }
+        return uint64_t(size.QuadPart);
+#else
+        struct stat info;
+        if (::fstat(fd, &info) != 0) {
+            throw std::runtime_error("     " + path);
+        }
+        return uint64_t(info.st_size);
+#endif
+    }
+
+    ///  ;     
+    void resize(uint64_t length) {
+#if defined(_WIN32)
+        LARGE_INTEGER position;
+        position.QuadPart = LONGLONG(length);
+        if (!SetFilePointerEx(file, position, nullptr, FILE_BEGIN) || !SetEndOfFile(file)) {
+            throw std::runtime_error("    " + path);
+        }
+#else
+        if (::ftruncate(fd, off_t(length)) != 0) {
+            throw std::runtime_error("    " + path);
+        }
+#endif
+    }
+
+    void readAt(void* buffer, size_t count, uint64_t offset) const {
+        char* bytes = static_cast<char*>(buffer);
+        while (count != 0) {
+            const size_t chunk = std::min(count, matrixFileChunk);
+#if defined(_WIN32)
+            OVERLAPPED position = {};
+            position.Offset = DWORD(offset);
+            position.OffsetHigh = DWORD(offset >> 32);
+            DWORD done = 0;
+            if (!ReadFile(file, bytes, DWORD(chunk), &done, &position) || done == 0) {
+                throw std::runtime_error("   " + path);
+            }
+#else
+            const ssize_t done = ::pread(fd, bytes, chunk, off_t(offset));
+            if (done < 0 && errno == EINTR) {
+                continue;
+            }
+            if (done <= 0) {
+                throw std::runtime_error("   " + path);
+            }
+#endif
+            bytes += done;
+            count -= size_t(done);
+            offset += uint64_t(done);
+        }
+    }
+
+    void writeAt(const void* buffer, size_t count, uint64_t offset) {
+        const char* bytes = static_cast<const char*>(buffer);
+        while (count != 0) {
+            const size_t chunk = std::min(count, matrixFileChunk);
+#if defined(_WIN32)
+            OVERLAPPED position = {};
+            position.Offset = DWORD(offset);
+            position.OffsetHigh = DWORD(offset >> 32);
+            DWORD done = 0;
+            if (!WriteFile(file, bytes, DWORD(chunk), &done, &position) || done == 0) {
+                throw std::runtime_error("    " + path);
+            }
+#else
+            const ssize_t done = ::pwrite(fd, bytes, chunk, off_t(offset));
+            if (done < 0 && errno == EINTR) {
+                continue;
+            }
+            if (done <= 0) {
+                throw std::runtime_error("    " + path);
+            }
+#endif
+            bytes += done;
+            count -= size_t(done);
+            offset += uint64_t(done);
+        }
+    }
+};
+
+template<typename T>
+MatrixFileHeader readMatrixHeader(const MatrixFile& file) {
+    const uint64_t fileSize = file.size();
+    if (fileSize < sizeof(MatrixFileHeader)) {
+        throw std::runtime_error(" " + file.getPath() + "    ");
+    }
+    MatrixFileHeader header;
+    file.readAt(&header, sizeof(header), 0);
+    checkMatrixHeader<T>(header, fileSize, file.getPath());
+    return header;
+}
+
+///  ()  rows x cols  ;    ,   Matrix<T>
+template<typename T>
+MatrixFileHeader createMatrixFile(MatrixFile& file, size_t rows, size_t cols) {
+    const size_t lane = Matrix<T>::alignment % sizeof(T) == 0 ? Matrix<T>::alignment / sizeof(T) : 1;
+    MatrixFileHeader header = {};
+    std::memcpy(header.magic, matrixFileMagic, sizeof(header.magic));
+    header.version = matrixFileVersion;
+    header.byteOrder = matrixFileByteOrder;
+    header.elementType = uint32_t(matrixElementType<T>());
+    header.elementSize = sizeof(T);
+    header.alignment = Matrix<T>::alignment;
+    header.rows = rows;
+    header.cols = cols;
+    header.stride = (cols + lane - 1) / lane * lane;
+    header.dataOffset = matrixFileDataOffset;
+    char padding[matrixFileDataOffset] = {};
+    std::memcpy(padding, &header, sizeof(header));
+    file.writeAt(padding, sizeof(padding), 0);
+    file.resize(header.dataOffset + header.rows * header.stride * sizeof(T));
+    return header;
+}
+
+///   [r0, r0 + rows) x [c0, c0 + cols)     ld;   
+template<typename T>
+uint64_t readFileBlock(const MatrixFile& file, const MatrixFileHeader& header,
+    size_t r0, size_t c0, size_t rows, size_t cols, T* dst, size_t ld) {
+    const uint64_t base = header.dataOffset + (uint64_t(r0) * header.stride + c0) * sizeof(T);
+    if (c0 == 0 && cols == header.cols && ld == header.stride) {
+        //       -     
+        file.readAt(dst, rows * ld * sizeof(T), base);
+        return rows * ld * sizeof(T);
+    }
+    for (size_t i = 0; i < rows; i++) {
+        file.readAt(dst + i * ld, cols * sizeof(T), base + uint64_t(i) * header.stride * sizeof(T));
+    }
+    return uint64_t(rows) * cols * sizeof(T);
+}
+
+template<typename T>
+uint64_t writeFileBlock(MatrixFile& file, const MatrixFileHeader& header,
+    size_t r0, size_t c0, size_t rows, size_t cols, const T* src, size_t ld) {
+    const uint64_t base = header.dataOffset + (uint64_t(r0) * header.stride + c0) * sizeof(T);
+    if (c0 == 0 && cols == header.cols && ld == header.stride) {
+        file.writeAt(src, rows * ld * sizeof(T), base);
+        return rows * ld * sizeof(T);
+    }
+    for (size_t i = 0; i < rows; i++) {
+        file.writeAt(src + i * ld, cols * sizeof(T), base + uint64_t(i) * header.stride * sizeof(T));
+    }
+    return uint64_t(rows) * cols * sizeof(T);
+}
+
+///      tm x tn   tk (   A, B  C)
+template<typename T>
+double outOfCoreBytes(size_t tm, size_t tn, size_t tk) {
+    return 2.0 * sizeof(T) * (double(tm) * tk + double(tk) * tn + double(tm) * tn);
+}
+
+///  :   options    ,    
+template<typename T>
+void outOfCoreTiles(const OutOfCoreOptions& options, size_t m, size_t n, size_t k,
+    size_t& tm, size_t& tn, size_t& tk) {
+    //   t: 6 t^2 ; t  64,      
+    size_t t = size_t(std::sqrt(double(options.memoryBudget) / (6.0 * sizeof(T)))) / 64 * 64;
+    t = std::max<size_t>(t, 64);
+    tm = std::max<size_t>(1, std::min(options.tileRows != 0 ? options.tileRows : t, m));
+    tn = std::max<size_t>(1, std::min(options.tileCols != 0 ? options.tileCols : t, n));
+    tk = std::max<size_t>(1, std::min(options.tileDepth != 0 ? options.tileDepth : t, k));
+    if (outOfCoreBytes<T>(tm, tn, tk) > double(options.memoryBudget)) {
+        throw std::invalid_argument("      ");
+    }
+}
+
+} // namespace detail
+
+
+/// C = A * B     pathA  pathB;     pathC ().
+///        (options.memoryBudget ).
+template<typename T>
+OutOfCoreStats multiplyOutOfCore(const std::string& pathA, const std::string& pathB, const std::string& pathC,
+    const OutOfCoreOptions& options = OutOfCoreOptions()) {
+    using Clock = std::chrono::steady_clock;
+    const Clock::time_point start = Clock::now();
+
+    const detail::MatrixFile fileA(pathA, false);
+    const detail::MatrixFile fileB(pathB, false);
+    const MatrixFileHeader headerA = detail::readMatrixHeader<T>(fileA);
+    const MatrixFileHeader headerB = detail::readMatrixHeader<T>(fileB);
+    if (headerA.cols != headerB.rows) {
+        throw std::invalid_argument("        ");
+    }
+    const size_t m = headerA.rows;
+    const size_t n = headerB.cols;
+    const size_t k = headerA.cols;
+
+    OutOfCoreStats stats;
+    detail::outOfCoreTiles<T>(options, m, n, k, stats.tileRows, stats.tileCols, stats.tileDepth);
+    const size_t tm = stats.tileRows;
+    const size_t tn = stats.tileCols;
+    const size_t tk = stats.tileDepth;
+
+    detail::MatrixFile fileC(pathC, true);
+    const MatrixFileHeader headerC = detail::createMatrixFile<T>(fileC, m, n);
+
+    //   :  C  ,   -   k.
+    //     ,           
+    struct Step {
+        size_t i0, j0, p0;
+        size_t slotA, slotB;
+        bool loadA, loadB;
+    };
+    std::vector<Step> steps;
+    if (k != 0) {
+        size_t slotA = 1, slotB = 1;
+        size_t keyA = SIZE_MAX, keyB = SIZE_MAX;
+        for (size_t i0 = 0; i0 < m; i0 += tm) {
+            for (size_t j0 = 0; j0 < n; j0 += tn) {
+                for (size_t p0 = 0; p0 < k; p0 += tk) {
+                    Step step{i0, j0, p0, slotA, slotB, false, false};
+                    const size_t nextA = i0 / tm * ((k + tk - 1) / tk) + p0 / tk;
+                    const size_t nextB = p0 / tk * ((n + tn - 1) / tn) + j0 / tn;
+                    if (nextA != keyA) {
+                        step.slotA = slotA = 1 - slotA;
+                        step.loadA = true;
+                        keyA = nextA;
+                    }
+                    if (nextB != keyB) {
+                        step.slotB = slotB = 1 - slotB;
+                        step.loadB = true;
+                        keyB = nextB;
+                    }
+                    steps.push_back(step);
+                }
+            }
+        }
+    }
+
+    Matrix<T> blocksA[2] = {Matrix<T>(tm, tk, typename Matrix<T>::Uninitialized{}), Matrix<T>(tm, tk, typename Matrix<T>::Uninitialized{})};
+    Matrix<T> blocksB[2] = {Matrix<T>(tk, tn, typename Matrix<T>::Uninitialized{}), Matrix<T>(tk, tn, typename Matrix<T>::Uninitialized{})};
+    Matrix<T> tilesC[2] = {Matrix<T>(tm, tn, typename Matrix<T>::Uninitialized{}), Matrix<T>(tm, tn, typename Matrix<T>::Uninitialized{})};
+    std::atomic<uint64_t> bytesRead{0};
+    std::atomic<uint64_t> bytesWritten{0};
+
+    auto load = [&](size_t s) {
+        const Step& step = steps[s];
+        const size_t rows = std::min(tm, m - step.i0);
+        const size_t cols = std::min(tn, n - step.j0);
+        const size_t depth = std::min(tk, k - step.p0);
+        if (step.loadA) {
+            Matrix<T>& block = blocksA[step.slotA];
+            bytesRead += detail::readFileBlock(fileA, headerA, step.i0, step.p0, rows, depth, block.getData(), block.getStride());
+        }
+        if (step.loadB) {
+            Matrix<T>& block = blocksB[step.slotB];
+            bytesRead += detail::readFileBlock(fileB, headerB, step.p0, step.j0, depth, cols, block.getData(), block.getStride());
+        }
+    };
+
+    //    :       future
+    std::future<void> pendingLoad;
+    std::future<void> pendingWrite[2];
+    double ioWait = 0;
+    auto wait = [&](std::future<void>& task) {
+        if (task.valid()) {
+            const Clock::time_point begin = Clock::now();
+            task.get();
+            ioWait += std::chrono::duration<double>(Clock::now() - begin).count();
+        }
+    };
+
+    if (!steps.empty()) {
+        pendingLoad = std::async(std::launch::async, load, size_t(0));
+    }
+    size_t tile = 0;
+    for (size_t s = 0; s < steps.size(); s++) {
+        const Step& step = steps[s];
+        wait(pendingLoad);
+        if (s + 1 < steps.size()) {
+            pendingLoad = std::async(std::launch::async, load, s + 1);
+        }
+
+        Matrix<T>& c = tilesC[tile % 2];
+        if (step.p0 == 0) {
+            //        :    
+            wait(pendingWrite[tile % 2]);
+        }
+        const size_t rows = std::min(tm, m - step.i0);
+        const size_t cols = std::min(tn, n - step.j0);
+        const size_t depth = std::min(tk, k - step.p0);
+        const Matrix<T>& a = blocksA[step.slotA];
+        const Matrix<T>& b = blocksB[step.slotB];
+        gemm<T>(rows, cols, depth, T(1), a.getData(), a.getStride(), 1, b.getData(), b.getStride(), 1,
+            step.p0 == 0 ? T() : T(1), c.getData(), c.getStride());
+
+        if (step.p0 + tk >= k) {
+            pendingWrite[tile % 2] = std::async(std::launch::async, [&fileC, &headerC, &bytesWritten, &c, step, rows, cols] {
+                bytesWritten += detail::writeFileBlock(fileC, headerC, step.i0, step.j0, rows, cols, c.getData(), c.getStride());
+            });
+            tile++;
+        }
+    }
+    wait(pendingWrite[0]);
+    wait(pendingWrite[1]);
+
+    stats.bytesRead = bytesRead;
+    stats.bytesWritten = bytesWritten;
+    stats.ioWaitSeconds = ioWait;
+    stats.totalSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+    return stats;
+}
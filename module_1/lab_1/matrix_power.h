@@ -0,0 +1,192 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <bit>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include "matrix.h"
+#include "gemm.h"
+#include "mod_int.h"
+#include "thread_pool.h"
+
+
+///     .
+/// pow(A, k) -    : floor(log2 k)      
+///     k - 1.        
+/// (,  , ),     .
+/// applyPower(A, k, V) - A^k * V    V :      -
+/// k  A * V   A^(2^i),   V    k.
+///  ModInt    :    uint64_t  
+///        ,     .
+
+namespace detail {
+
+///  C      
+inline constexpr size_t modGemmTaskRows = 16;
+
+///    (  (Mod - 1)^2)      Mod   uint64_t
+template<uint32_t Mod>
+inline constexpr uint64_t modLazyTerms = (std::numeric_limits<uint64_t>::max() - Mod) / (uint64_t(Mod - 1) * (Mod - 1));
+
+/// C = A * B   (C    A  B)
+template<uint32_t Mod>
+void modGemm(size_t m, size_t n, size_t k, const ModInt<Mod>* a, size_t lda,
+    const ModInt<Mod>* b, size_t ldb, ModInt<Mod>* c, size_t ldc) {
+    const size_t chunk = static_cast<size_t>(std::min<uint64_t>(modLazyTerms<Mod>, std::max<size_t>(k, 1)));
+    //   : size_t        uint64_t,    
+    parallelFor((m + modGemmTaskRows - 1) / modGemmTaskRows, [=](size_t task) {
+        const size_t i0 = task * modGemmTaskRows;
+        const size_t i1 = std::min(m, i0 + modGemmTaskRows);
+        std::vector<uint64_t> sums(n);
+        uint64_t* acc = sums.data();
+        for (size_t i = i0; i < i1; i++) {
+            std::fill(acc, acc + n, 0);
+            const ModInt<Mod>* row = a + i * lda;
+            for (size_t t0 = 0; t0 < k; t0 += chunk) {
+                const size_t t1 = std::min(k, t0 + chunk);
+                for (size_t t = t0; t < t1; t++) {
+                    const uint64_t s = row[t].get();
+                    if (s == 0) {
+                        continue;
+                    }
+                    const ModInt<Mod>* bt = b + t * ldb;
+                    for (size_t j = 0; j < n; j++) {
+                        acc[j] += s * bt[j].get();
+                    }
+                }
+                for (size_t j = 0; j < n; j++) {
+                    acc[j] %= Mod;
+                }
+            }
+            ModInt<Mod>* out = c + i * ldc;
+            for (size_t j = 0; j < n; j++) {
+                out[j] = ModInt<Mod>(acc[j]);
+            }
+        }
+    });
+}
+
+/// C = A * B     C (   A  B)
+template<typename T>
+void powerMultiply(const Matrix<T>& a, const Matrix<T>& b, Matrix<T>& c) {
+    if constexpr (is_mod_int<T>::value) {
+        modGemm(a.getRows(), b.getCols(), a.getCols(), a.getData(), a.getStride(), b.getData(), b.getStride(), c.getData(), c.getStride());
+    }
+    else {
+        gemm<T>(a.getRows(), b.getCols(), a.getCols(), T(1), a.getData(), a.getStride(), 1,
+            b.getData(), b.getStride(), 1, T(), c.getData(), c.getStride());
+    }
+}
+
+} // namespace detail
+
+
+/// A^k    (A^0 - )
+template<typename T>
+Matrix<T> pow(const Matrix<T>& a, uint64_t k) {
+    if (a.getRows() != a.getCols()) {
+        throw std::invalid_argument("   ");
+    }
+    const size_t n = a.getRows();
+    if (k == 0) {
+        Matrix<T> identity(n, n);
+        for (size_t i = 0; i < n; i++) {
+            identity(i, i) = T(1);
+        }
+        return identity;
+    }
+    Matrix<T> base(a);
+    Matrix<T> temp(n, n, typename Matrix<T>::Uninitialized{});
+    //    -  ;    ,      
+    while ((k & 1) == 0) {
+        detail::powerMultiply(base, base, temp);
+        swap(base, temp);
+        k >>= 1;
+    }
+    Matrix<T> result(base);
+    while ((k >>= 1) != 0) {
+        detail::powerMultiply(base, base, temp);
+        swap(base, temp);
+        if (k & 1) {
+            detail::powerMultiply(result, base, temp);
+            swap(result, temp);
+        }
+    }
+    return result;
+}
+
+/// A^k * V:   V -  .     - p
+/// (p A^k)   A ,  p - 
+template<typename T>
+Matrix<T> applyPower(const Matrix<T>& a, uint64_t k, const Matrix<T>& v) {
+    if (a.getRows() != a.getCols()) {
+        throw std::invalid_argument("   ");
+    }
+    if (v.getRows() != a.getRows()) {
+        throw std::invalid_argument("        ");
+    }
+    const size_t n = a.getRows();
+    const size_t m = v.getCols();
+    Matrix<T> x(v);
+    if (k == 0 || n == 0 || m == 0) {
+        return x;
+    }
+    Matrix<T> y(n, m, typename Matrix<T>::Uninitialized{});
+
+    //    n^2 : k  A * V  floor(log2 k)  n x n  popcount(k)  A^(2^i) * V
+    const double repeated = double(k) * m;
+    const double squaring = double(std::bit_width(k) - 1) * n + double(std::popcount(k)) * m;
+    if (repeated <= squaring) {
+        for (uint64_t step = 0; step < k; step++) {
+            detail::powerMultiply(a, x, y);
+            swap(x, y);
+        }
+        return x;
+    }
+    //  A ,   A^(2^i)   V    i
+    Matrix<T> base(a);
+    Matrix<T> temp(n, n, typename Matrix<T>::Uninitialized{});
+    while (true) {
+        if (k & 1) {
+            detail::powerMultiply(base, x, y);
+            swap(x, y);
+        }
+        k >>= 1;
+        if (k == 0) {
+            break;
+        }
+        detail::powerMultiply(base, base, temp);
+        swap(base, temp);
+    }
+    return x;
+}
+
+///  x_k  x_t = c_0 x_{t-1} + c_1 x_{t-2} + ... + c_{d-1} x_{t-d}
+///    x_0, ..., x_{d-1}:   d x d   k - d + 1
+template<typename T>
+T linearRecurrence(const std::vector<T>& coefficients, const std::vector<T>& initial, uint64_t k) {
+    const size_t d = coefficients.size();
+    if (d == 0 || initial.size() != d) {
+        throw std::invalid_argument("          ");
+    }
+    if (k < d) {
+        return initial[k];
+    }
+    //  s_t = (x_{t+d-1}, ..., x_t):   - ,  - 
+    Matrix<T> companion(d, d);
+    for (size_t j = 0; j < d; j++) {
+        companion(0, j) = coefficients[j];
+    }
+    for (size_t i = 1; i < d; i++) {
+        companion(i, i - 1) = T(1);
+    }
+    Matrix<T> state(d, 1);
+    for (size_t i = 0; i < d; i++) {
+        state(i, 0) = initial[d - 1 - i];
+    }
+    return applyPower(companion, k - d + 1, state)(0, 0);
+}
@@ -0,0 +1,328 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <atomic>
+#include <complex>
+#include <random>
+#include <type_traits>
+
+#include "cpu.h"
+#include "thread_pool.h"
+
+
+///      Philox4x32-10 (Salmon et al., 2011).
+///   -   (, ),    
+///   ,      seed   ,    
+///    .    i * cols + j   : float - 
+/// 32-   , double - ;   -  re,  im.
+///  Philox    16     AVX2/AVX-512.
+
+namespace detail {
+
+inline constexpr uint32_t philoxM0 = 0xD2511F53;
+inline constexpr uint32_t philoxM1 = 0xCD9E8D57;
+inline constexpr uint32_t philoxW0 = 0x9E3779B9;
+inline constexpr uint32_t philoxW1 = 0xBB67AE85;
+
+///     ;  - 64 :   0  16 ,
+///   1  . . (      )
+inline constexpr size_t philoxLanes = 16;
+inline constexpr size_t philoxGroupWords = philoxLanes * 4;
+
+///   [first, first + groups * philoxLanes)  out (groups * philoxGroupWords )
+inline void philoxBlocks(uint64_t seed, uint64_t first, size_t groups, uint32_t* out) {
+    for (size_t g = 0; g < groups; g++) {
+        uint32_t* c = out + g * philoxGroupWords;
+        for (size_t l = 0; l < philoxLanes; l++) {
+            const uint64_t counter = first + g * philoxLanes + l;
+            uint32_t c0 = static_cast<uint32_t>(counter);
+            uint32_t c1 = static_cast<uint32_t>(counter >> 32);
+            uint32_t c2 = 0;
+            uint32_t c3 = 0;
+            uint32_t k0 = static_cast<uint32_t>(seed);
+            uint32_t k1 = static_cast<uint32_t>(seed >> 32);
+            for (int round = 0; round < 10; round++) {
+                const uint64_t p0 = uint64_t(philoxM0) * c0;
+                const uint64_t p1 = uint64_t(philoxM1) * c2;
+                c0 = static_cast<uint32_t>(p1 >> 32) ^ c1 ^ k0;
+                c2 = static_cast<uint32_t>(p0 >> 32) ^ c3 ^ k1;
+                c1 = static_cast<uint32_t>(p1);
+                c3 = static_cast<uint32_t>(p0);
+                k0 += philoxW0;
+                k1 += philoxW1;
+            }
+            c[l] = c0;
+            c[philoxLanes + l] = c1;
+            c[2 * philoxLanes + l] = c2;
+            c[3 * philoxLanes + l] = c3;
+        }
+    }
+}
+
+template<SimdLevel L>
+struct PhiloxKernel {
+    static void blocks(uint64_t seed, uint64_t first, size_t groups, uint32_t* out) {
+        philoxBlocks(seed, first, groups, out);
+    }
+};
+
+#if MATRIX_X86_DISPATCH
+/// AVX2: 16      8 ;    
+///  32 x 32   _mm256_mul_epu32     
+template<>
+struct PhiloxKernel<SimdLevel::Avx2> {
+    MATRIX_TARGET("avx2,fma")
+    static void mulHiLo(__m256i a, __m256i m, __m256i& hi, __m256i& lo) {
+        const __m256i even = _mm256_mul_epu32(a, m);
+        const __m256i odd = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), m);
+        hi = _mm256_blend_epi32(_mm256_srli_epi64(even, 32), odd, 0xAA);
+        lo = _mm256_blend_epi32(even, _mm256_slli_epi64(odd, 32), 0xAA);
+    }
+
+    MATRIX_TARGET("avx2,fma")
+    static void blocks(uint64_t seed, uint64_t first, size_t groups, uint32_t* out) {
+        const __m256i m0 = _mm256_set1_epi32(int(philoxM0));
+        const __m256i m1 = _mm256_set1_epi32(int(philoxM1));
+        const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+        for (size_t g = 0; g < groups; g++) {
+            uint32_t* dst = out + g * philoxGroupWords;
+            for (size_t h = 0; h < philoxLanes; h += 8) {
+                const uint64_t base = first + g * philoxLanes + h;
+                //      2^32  : first  16
+                __m256i c0 = _mm256_add_epi32(_mm256_set1_epi32(int(uint32_t(base))), lanes);
+                __m256i c1 = _mm256_set1_epi32(int(uint32_t(base >> 32)));
+                __m256i c2 = _mm256_setzero_si256();
+                __m256i c3 = _mm256_setzero_si256();
+                uint32_t k0 = static_cast<uint32_t>(seed);
+                uint32_t k1 = static_cast<uint32_t>(seed >> 32);
+                for (int round = 0; round < 10; round++) {
+                    __m256i hi0, lo0, hi1, lo1;
+                    mulHiLo(c0, m0, hi0, lo0);
+                    mulHiLo(c2, m1, hi1, lo1);
+                    c0 = _mm256_xor_si256(_mm256_xor_si256(hi1, c1), _mm256_set1_epi32(int(k0)));
+                    c2 = _mm256_xor_si256(_mm256_xor_si256(hi0, c3), _mm256_set1_epi32(int(k1)));
+                    c1 = lo1;
+                    c3 = lo0;
+                    k0 += philoxW0;
+                    k1 += philoxW1;
+                }
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + h), c0);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + philoxLanes + h), c1);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + 2 * philoxLanes + h), c2);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + 3 * philoxLanes + h), c3);
+            }
+        }
+    }
+};
+
+/// AVX-512:    16      
+template<>
+struct PhiloxKernel<SimdLevel::Avx512> {
+    MATRIX_TARGET("avx512f")
+    static void mulHiLo(__m512i a, __m512i m, __m512i& hi, __m512i& lo) {
+        const __m512i even = _mm512_mul_epu32(a, m);
+        const __m512i odd = _mm512_mul_epu32(_mm512_srli_epi64(a, 32), m);
+        hi = _mm512_mask_blend_epi32(0xAAAA, _mm512_srli_epi64(even, 32), odd);
+        lo = _mm512_mask_blend_epi32(0xAAAA, even, _mm512_slli_epi64(odd, 32));
+    }
+
+    MATRIX_TARGET("avx512f")
+    static void blocks(uint64_t seed, uint64_t first, size_t groups, uint32_t* out) {
+        const __m512i m0 = _mm512_set1_epi32(int(philoxM0));
+        const __m512i m1 = _mm512_set1_epi32(int(philoxM1));
+        const __m512i lanes = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+        for (size_t g = 0; g < groups; g++) {
+            const uint64_t base = first + g * philoxLanes;
+            __m512i c0 = _mm512_add_epi32(_mm512_set1_epi32(int(uint32_t(base))), lanes);
+            __m512i c1 = _mm512_set1_epi32(int(uint32_t(base >> 32)));
+            __m512i c2 = _mm512_setzero_si512();
+            __m512i c3 = _mm512_setzero_si512();
+            uint32_t k0 = static_cast<uint32_t>(seed);
+            uint32_t k1 = static_cast<uint32_t>(seed >> 32);
+            for (int round = 0; round < 10; round++) {
+                __m512i hi0, lo0, hi1, lo1;
+                mulHiLo(c0, m0, hi0, lo0);
+                mulHiLo(c2, m1, hi1, lo1);
+                c0 = _mm512_ternarylogic_epi32(hi1, c1, _mm512_set1_epi32(int(k0)), 0x96);
+                c2 = _mm512_ternarylogic_epi32(hi0, c3, _mm512_set1_epi32(int(k1)), 0x96);
+                c1 = lo1;
+                c3 = lo0;
+                k0 += philoxW0;
+                k1 += philoxW1;
+            }
+            uint32_t* dst = out + g * philoxGroupWords;
+            _mm512_storeu_si512(dst, c0);
+            _mm512_storeu_si512(dst + philoxLanes, c1);
+            _mm512_storeu_si512(dst + 2 * philoxLanes, c2);
+            _mm512_storeu_si512(dst + 3 * philoxLanes, c3);
+        }
+    }
+};
+#endif
+
+///        
+template<typename T>
+struct RandomTraits {
+    using Component = T;
+    static constexpr size_t components = 1;
+};
+
+template<typename T>
+struct RandomTraits<std::complex<T>> {
+    using Component = T;
+    static constexpr size_t components = 2;
+};
+
+///   : 24   float, double  53    
+template<typename C>
+inline constexpr size_t randomWords = std::is_same_v<C, float> ? 1 : 2;
+
+template<typename C>
+inline C unitFromWords(const uint32_t* w) {
+    if constexpr (randomWords<C> == 1) {
+        return static_cast<C>(w[0] >> 8) * C(1.0f / 16777216.0f);
+    }
+    else {
+        const uint64_t bits = (uint64_t(w[0]) << 32 | w[1]) >> 11;
+        return static_cast<C>(static_cast<double>(bits) * (1.0 / 9007199254740992.0));
+    }
+}
+
+///   [r0, r1)  lower + (upper - lower) * u, u  [0, 1)
+template<SimdLevel L, typename T>
+void uniformRows(T* data, size_t cols, size_t stride, const T& lower, const T& upper, uint64_t seed, size_t r0, size_t r1) {
+    using Traits = RandomTraits<T>;
+    using C = typename Traits::Component;
+    using U = std::conditional_t<std::is_same_v<C, float>, float, double>;
+    constexpr size_t words = randomWords<C>;
+    constexpr size_t chunkGroups = 16;
+
+    U lo0, lo1 = U(), span0, span1 = U();
+    if constexpr (Traits::components == 2) {
+        lo0 = static_cast<U>(lower.real());
+        lo1 = static_cast<U>(lower.imag());
+        span0 = static_cast<U>(upper.real()) - lo0;
+        span1 = static_cast<U>(upper.imag()) - lo1;
+    }
+    else {
+        lo0 = static_cast<U>(lower);
+        span0 = static_cast<U>(upper) - lo0;
+    }
+
+    alignas(64) uint32_t buffer[chunkGroups * philoxGroupWords];
+    C* out = reinterpret_cast<C*>(data);
+    const size_t values = cols * Traits::components;
+    for (size_t i = r0; i < r1; i++) {
+        //   [word, lastWord);     philoxGroupWords ,
+        //      (re, im)     
+        uint64_t word = uint64_t(i) * values * words;
+        const uint64_t lastWord = word + values * words;
+        C* dst = out + i * stride * Traits::components;
+        while (word < lastWord) {
+            const uint64_t firstGroup = word / philoxGroupWords;
+            const size_t skip = static_cast<size_t>(word - firstGroup * philoxGroupWords);
+            const size_t groups = static_cast<size_t>(std::min<uint64_t>(chunkGroups,
+                (lastWord - firstGroup * philoxGroupWords + philoxGroupWords - 1) / philoxGroupWords));
+            PhiloxKernel<L>::blocks(seed, firstGroup * philoxLanes, groups, buffer);
+            const size_t count = static_cast<size_t>(std::min<uint64_t>((groups * philoxGroupWords - skip) / words, (lastWord - word) / words));
+            const uint32_t* src = buffer + skip;
+            if constexpr (Traits::components == 2) {
+                for (size_t k = 0; k < count; k += 2) {
+                    dst[k] = static_cast<C>(lo0 + span0 * unitFromWords<U>(src + k * words));
+                    dst[k + 1] = static_cast<C>(lo1 + span1 * unitFromWords<U>(src + (k + 1) * words));
+                }
+            }
+            else {
+                for (size_t k = 0; k < count; k++) {
+                    dst[k] = static_cast<C>(lo0 + span0 * unitFromWords<U>(src + k * words));
+                }
+            }
+            dst += count;
+            word += count * words;
+        }
+    }
+}
+
+template<typename T, SimdLevel L>
+struct RandomKernel {
+    static void run(T* data, size_t cols, size_t stride, const T& lower, const T& upper, uint64_t seed, size_t r0, size_t r1) {
+        uniformRows<SimdLevel::Generic>(data, cols, stride, lower, upper, seed, r0, r1);
+    }
+};
+
+#if MATRIX_X86_DISPATCH
+template<typename T>
+struct RandomKernel<T, SimdLevel::Avx2> {
+    MATRIX_TARGET("avx2,fma") MATRIX_FLATTEN
+    static void run(T* data, size_t cols, size_t stride, const T& lower, const T& upper, uint64_t seed, size_t r0, size_t r1) {
+        uniformRows<SimdLevel::Avx2>(data, cols, stride, lower, upper, seed, r0, r1);
+    }
+};
+
+template<typename T>
+struct RandomKernel<T, SimdLevel::Avx512> {
+    MATRIX_TARGET("avx512f") MATRIX_FLATTEN
+    static void run(T* data, size_t cols, size_t stride, const T& lower, const T& upper, uint64_t seed, size_t r0, size_t r1) {
+        uniformRows<SimdLevel::Avx512>(data, cols, stride, lower, upper, seed, r0, r1);
+    }
+};
+#endif
+
+template<typename T>
+void uniformRowsDispatch(T* data, size_t cols, size_t stride, const T& lower, const T& upper, uint64_t seed, size_t r0, size_t r1) {
+    switch (simdLevel()) {
+    case SimdLevel::Avx512:
+        RandomKernel<T, SimdLevel::Avx512>::run(data, cols, stride, lower, upper, seed, r0, r1);
+        return;
+    case SimdLevel::Avx2:
+        RandomKernel<T, SimdLevel::Avx2>::run(data, cols, stride, lower, upper, seed, r0, r1);
+        return;
+    default:
+        RandomKernel<T, SimdLevel::Generic>::run(data, cols, stride, lower, upper, seed, r0, r1);
+        return;
+    }
+}
+
+///  ,      
+inline constexpr size_t randomParallelElements = 1 << 16;
+
+inline uint64_t splitMix64(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+} // namespace detail
+
+
+///  seed   : random_device     ,
+///  seed-    splitmix64
+inline uint64_t randomSeed() {
+    static std::atomic<uint64_t> state{[] {
+        std::random_device rd;
+        return uint64_t(rd()) << 32 | rd();
+    }()};
+    return detail::splitMix64(state.fetch_add(0x9E3779B97F4A7C15ull, std::memory_order_relaxed));
+}
+
+///  rows x cols  (  stride)   [lower, upper);
+///           
+template<typename T>
+void uniformFill(T* data, size_t rows, size_t cols, size_t stride, const T& lower, const T& upper, uint64_t seed) {
+    if (rows == 0 || cols == 0) {
+        return;
+    }
+    if (rows * cols < detail::randomParallelElements || threadPool().size() == 1) {
+        detail::uniformRowsDispatch(data, cols, stride, lower, upper, seed, 0, rows);
+        return;
+    }
+    const size_t rowsPerTask = std::max<size_t>(1, (detail::randomParallelElements / 4) / cols);
+    const size_t tasks = (rows + rowsPerTask - 1) / rowsPerTask;
+    parallelFor(tasks, [&](size_t t) {
+        const size_t r0 = t * rowsPerTask;
+        detail::uniformRowsDispatch(data, cols, stride, lower, upper, seed, r0, std::min(rows, r0 + rowsPerTask));
+    });
+}
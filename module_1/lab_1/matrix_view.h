@@ -0,0 +1,327 @@
+#pragma once
+
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+
+#include "gemm.h"
+#include "simd.h"
+#include "strassen.h"
+#include "matrix_expr.h"
+
+
+///  (views)    : , , , .
+///         ,     
+///       .  
+///       (gemm     ).
+///     ,   -  (  
+///  Eigen): A.row(0) = B.row(1)   A.
+
+///       : ,  (1 x n),  (n x 1).
+/// T = const U -  .
+template<typename T>
+class MatrixView : public MatrixExpr<MatrixView<T>> {
+public:
+    using value_type = std::remove_const_t<T>;
+
+private:
+    T* data;
+    size_t rows;
+    size_t cols;
+    size_t stride;
+
+    using MatrixRef = std::conditional_t<std::is_const_v<T>, const Matrix<value_type>&, Matrix<value_type>&>;
+
+    T* rowPtr(size_t row) const {
+        return data + row * stride;
+    }
+
+    ///    ;     -   
+    template<typename Assign, typename E>
+    void assign(const E& expr) {
+        if (rows != expr.getRows() || cols != expr.getCols()) {
+            throw std::invalid_argument("      ");
+        }
+        if (rows == 0 || cols == 0) {
+            return;
+        }
+        if (expr.exprAliases(data, rowPtr(rows - 1) + cols, stride)) {
+            const Matrix<value_type> temp(expr);
+            detail::evaluateExpr<Assign>(temp, data, stride);
+            return;
+        }
+        detail::evaluateExpr<Assign>(expr, data, stride);
+    }
+
+public:
+    MatrixView(T* data, size_t rows, size_t cols, size_t stride) : data(data), rows(rows), cols(cols), stride(stride) {}
+
+    ///  
+    MatrixView(MatrixRef matrix)
+        : data(matrix.getData()), rows(matrix.getRows()), cols(matrix.getCols()), stride(matrix.getStride()) {}
+
+    ///        
+    template<typename U>
+    MatrixView(const MatrixView<U>& other) requires (std::is_const_v<T> && std::is_same_v<const U, T>)
+        : data(other.getData()), rows(other.getRows()), cols(other.getCols()), stride(other.getStride()) {}
+
+    MatrixView(const MatrixView&) = default;
+
+    ///   
+    MatrixView& operator=(const MatrixView& other) requires (!std::is_const_v<T>) {
+        assign<detail::AssignSet>(other);
+        return *this;
+    }
+
+    template<typename E>
+    MatrixView& operator=(const MatrixExpr<E>& expr) requires (!std::is_const_v<T>) {
+        assign<detail::AssignSet>(expr.self());
+        return *this;
+    }
+
+    template<typename E>
+    MatrixView& operator+=(const MatrixExpr<E>& expr) requires (!std::is_const_v<T>) {
+        assign<detail::AssignAdd>(expr.self());
+        return *this;
+    }
+
+    template<typename E>
+    MatrixView& operator-=(const MatrixExpr<E>& expr) requires (!std::is_const_v<T>) {
+        assign<detail::AssignSub>(expr.self());
+        return *this;
+    }
+
+    MatrixView& operator*=(value_type scalar) requires (!std::is_const_v<T>) {
+        for (size_t i = 0; i < rows; i++) {
+            simdScale(rowPtr(i), scalar, rowPtr(i), cols);
+        }
+        return *this;
+    }
+
+    MatrixView& operator/=(value_type scalar) requires (!std::is_const_v<T>) {
+        if (scalar == value_type()) {
+            throw std::invalid_argument("  ");
+        }
+        for (size_t i = 0; i < rows; i++) {
+            simdDivide(rowPtr(i), scalar, rowPtr(i), cols);
+        }
+        return *this;
+    }
+
+    T& operator()(size_t row, size_t col) const {
+        if (row >= rows || col >= cols) {
+            throw std::out_of_range("  ");
+        }
+        return data[row * stride + col];
+    }
+
+    ///   
+    MatrixView block(size_t row, size_t col, size_t blockRows, size_t blockCols) const {
+        if (row > rows || col > cols || blockRows > rows - row || blockCols > cols - col) {
+            throw std::out_of_range("    ");
+        }
+        return MatrixView(data + row * stride + col, blockRows, blockCols, stride);
+    }
+
+    MatrixView row(size_t i) const {
+        return block(i, 0, 1, cols);
+    }
+
+    MatrixView col(size_t j) const {
+        return block(0, j, rows, 1);
+    }
+
+    TransposedView<value_type> transposed() const {
+        return TransposedView<value_type>(data, cols, rows, stride);
+    }
+
+    size_t getRows() const {
+        return rows;
+    }
+
+    size_t getCols() const {
+        return cols;
+    }
+
+    size_t getStride() const {
+        return stride;
+    }
+
+    T* getData() const {
+        return data;
+    }
+
+    const value_type* exprRow(size_t i) const {
+        return rowPtr(i);
+    }
+
+    bool exprAliases(const value_type* begin, const value_type* end, size_t outStride) const {
+        return rows != 0 && cols != 0 && detail::bufferAliases<value_type>(data, rowPtr(rows - 1) + cols, stride, true, begin, end, outStride);
+    }
+};
+
+template<typename T>
+MatrixView(Matrix<T>&) -> MatrixView<T>;
+
+template<typename T>
+MatrixView(const Matrix<T>&) -> MatrixView<const T>;
+
+
+///   ( ):  (i, j) -  (j, i)  
+template<typename T>
+class TransposedView : public MatrixExpr<TransposedView<T>> {
+public:
+    using value_type = T;
+
+private:
+    const T* data;
+    size_t rows;
+    size_t cols;
+    ///     (  )
+    size_t stride;
+
+public:
+    /// rows x cols -   ,    cols x rows
+    TransposedView(const T* data, size_t rows, size_t cols, size_t stride) : data(data), rows(rows), cols(cols), stride(stride) {}
+
+    TransposedView(const Matrix<T>& matrix)
+        : data(matrix.getData()), rows(matrix.getCols()), cols(matrix.getRows()), stride(matrix.getStride()) {}
+
+    const T& operator()(size_t row, size_t col) const {
+        if (row >= rows || col >= cols) {
+            throw std::out_of_range("  ");
+        }
+        return data[col * stride + row];
+    }
+
+    TransposedView block(size_t row, size_t col, size_t blockRows, size_t blockCols) const {
+        if (row > rows || col > cols || blockRows > rows - row || blockCols > cols - col) {
+            throw std::out_of_range("    ");
+        }
+        return TransposedView(data + col * stride + row, blockRows, blockCols, stride);
+    }
+
+    MatrixView<const T> transposed() const {
+        return MatrixView<const T>(data, cols, rows, stride);
+    }
+
+    size_t getRows() const {
+        return rows;
+    }
+
+    size_t getCols() const {
+        return cols;
+    }
+
+    ///      ( )
+    size_t getStride() const {
+        return stride;
+    }
+
+    const T* getData() const {
+        return data;
+    }
+
+    detail::StridedRow<T> exprRow(size_t i) const {
+        return detail::StridedRow<T>{data + i, stride};
+    }
+
+    bool exprAliases(const T* begin, const T* end, size_t outStride) const {
+        return rows != 0 && cols != 0 && detail::bufferAliases<T>(data, data + (cols - 1) * stride + rows, stride, false, begin, end, outStride);
+    }
+};
+
+
+namespace detail {
+
+///  ,     (rs -  , cs -  )
+template<typename M>
+struct StridedOperand {
+    static constexpr bool value = false;
+};
+
+template<typename T>
+struct StridedOperand<Matrix<T>> {
+    static constexpr bool value = true;
+    static const T* data(const Matrix<T>& m) { return m.getData(); }
+    static size_t rowStride(const Matrix<T>& m) { return m.getStride(); }
+    static size_t colStride(const Matrix<T>&) { return 1; }
+};
+
+template<typename T>
+struct StridedOperand<MatrixView<T>> {
+    static constexpr bool value = true;
+    static const std::remove_const_t<T>* data(const MatrixView<T>& m) { return m.getData(); }
+    static size_t rowStride(const MatrixView<T>& m) { return m.getStride(); }
+    static size_t colStride(const MatrixView<T>&) { return 1; }
+};
+
+template<typename T>
+struct StridedOperand<TransposedView<T>> {
+    static constexpr bool value = true;
+    static const T* data(const TransposedView<T>& m) { return m.getData(); }
+    static size_t rowStride(const TransposedView<T>&) { return 1; }
+    static size_t colStride(const TransposedView<T>& m) { return m.getStride(); }
+};
+
+/// C = A * B   c (   ldc);  -        
+template<typename T>
+void stridedProduct(size_t m, size_t n, size_t k, const T* a, size_t rsa, size_t csa,
+    const T* b, size_t rsb, size_t csb, T* c, size_t ldc) {
+    if (csa == 1 && csb == 1 && strassenApplies<T>(m, n, k)) {
+        strassen<T>(m, n, k, a, rsa, b, rsb, c, ldc);
+        return;
+    }
+    gemm<T>(m, n, k, T(1), a, rsa, csa, b, rsb, csb, T(), c, ldc);
+}
+
+///  -    ,    
+template<typename T>
+MatrixView<T> materialize(const MatrixView<T>& view) {
+    return view;
+}
+
+template<typename T>
+TransposedView<T> materialize(const TransposedView<T>& view) {
+    return view;
+}
+
+} // namespace detail
+
+///          
+template<typename A, typename B>
+    requires (detail::StridedOperand<A>::value && detail::StridedOperand<B>::value)
+Matrix<typename A::value_type> operator*(const A& a, const B& b) {
+    using T = typename A::value_type;
+    static_assert(std::is_same_v<T, typename B::value_type>, "    ");
+    if (a.getCols() != b.getRows()) {
+        throw std::invalid_argument("        ");
+    }
+    Matrix<T> result(a.getRows(), b.getCols(), typename Matrix<T>::Uninitialized{});
+    detail::stridedProduct<T>(a.getRows(), b.getCols(), a.getCols(),
+        detail::StridedOperand<A>::data(a), detail::StridedOperand<A>::rowStride(a), detail::StridedOperand<A>::colStride(a),
+        detail::StridedOperand<B>::data(b), detail::StridedOperand<B>::rowStride(b), detail::StridedOperand<B>::colStride(b),
+        result.getData(), result.getStride());
+    return result;
+}
+
+/// C = alpha * A * B + beta * C    C (    ).
+/// C     A  B.
+template<typename T, typename A, typename B>
+    requires (detail::StridedOperand<A>::value && detail::StridedOperand<B>::value)
+void multiplyInto(MatrixView<T> c, const A& a, const B& b, T alpha = T(1), T beta = T()) {
+    static_assert(!std::is_const_v<T>, "       ");
+    if (a.getCols() != b.getRows() || c.getRows() != a.getRows() || c.getCols() != b.getCols()) {
+        throw std::invalid_argument("        ");
+    }
+    gemm<T>(a.getRows(), b.getCols(), a.getCols(), alpha,
+        detail::StridedOperand<A>::data(a), detail::StridedOperand<A>::rowStride(a), detail::StridedOperand<A>::colStride(a),
+        detail::StridedOperand<B>::data(b), detail::StridedOperand<B>::rowStride(b), detail::StridedOperand<B>::colStride(b),
+        beta, c.getData(), c.getStride());
+}
+
+template<typename T, typename A, typename B>
+    requires (detail::StridedOperand<A>::value && detail::StridedOperand<B>::value)
+void multiplyInto(Matrix<T>& c, const A& a, const B& b, T alpha = T(1), T beta = T()) {
+    multiplyInto(MatrixView<T>(c), a, b, alpha, beta);
+}
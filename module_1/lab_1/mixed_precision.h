@@ -0,0 +1,299 @@
+#pragma once
+
+#include <cstddef>
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "matrix.h"
+#include "lu.h"
+
+
+///  A * X = B    ( ,   LAPACK dsgesv).
+/// A   float (  SIMD    ),  
+/// :  R = B - A * X   double,  D  A * D = R - 
+///   float.    ~1e6  2-4   
+/// double.     ( A    float),  
+///  LU  double.    O(n^3);    
+///  O(n^2 m)  A (    ),   ,   LUDecomposition.
+
+///   
+struct RefinementInfo {
+    ///    (0 -   )
+    size_t iterations = 0;
+    ///   ; false -     
+    bool converged = false;
+    ///      ||r||_inf / (||A||_inf * ||x||_inf)
+    double backwardError = 0;
+};
+
+
+namespace detail {
+
+///     
+template<typename T>
+struct LowerPrecision;
+
+template<>
+struct LowerPrecision<double> {
+    using type = float;
+};
+
+template<>
+struct LowerPrecision<std::complex<double>> {
+    using type = std::complex<float>;
+};
+
+///      ; false,       To
+template<typename To, typename From>
+bool convertMatrix(const Matrix<From>& src, Matrix<To>& dst) {
+    bool finite = true;
+    for (size_t i = 0; i < src.getRows(); i++) {
+        const From* in = src.getData() + i * src.getStride();
+        To* out = dst.getData() + i * dst.getStride();
+        for (size_t j = 0; j < src.getCols(); j++) {
+            out[j] = static_cast<To>(in[j]);
+            finite &= std::isfinite(std::real(out[j])) && std::isfinite(std::imag(out[j]));
+        }
+    }
+    return finite;
+}
+
+///       (|re| + |im|  ,   zcgesv).
+/// NaN    NaN: std::max   ,    NaN    
+template<typename T>
+void columnMaxNorms(const Matrix<T>& m, double* norms) {
+    std::fill(norms, norms + m.getCols(), 0.0);
+    for (size_t i = 0; i < m.getRows(); i++) {
+        const T* row = m.getData() + i * m.getStride();
+        for (size_t j = 0; j < m.getCols(); j++) {
+            const double magnitude = static_cast<double>(pivotMagnitude(row[j]));
+            if (!(magnitude <= norms[j])) {
+                norms[j] = magnitude;
+            }
+        }
+    }
+}
+
+///    (    ,  -   columnMaxNorms)
+template<typename T>
+double normInf(const Matrix<T>& m) {
+    double result = 0;
+    for (size_t i = 0; i < m.getRows(); i++) {
+        const T* row = m.getData() + i * m.getStride();
+        double sum = 0;
+        for (size_t j = 0; j < m.getCols(); j++) {
+            sum += pivotMagnitude(row[j]);
+        }
+        result = std::max(result, sum);
+    }
+    return result;
+}
+
+///  A   ; nullptr,  A    Low    
+template<typename Low, typename T>
+std::unique_ptr<LUDecomposition<Low>> lowPrecisionFactors(const Matrix<T>& a) {
+    if (a.getRows() != a.getCols()) {
+        throw std::invalid_argument("   ");
+    }
+    Matrix<Low> low(a.getRows(), a.getCols(), typename Matrix<Low>::Uninitialized{});
+    if (!convertMatrix(a, low)) {
+        return nullptr;
+    }
+    auto factors = std::make_unique<LUDecomposition<Low>>(std::move(low));
+    if (factors->isSingular()) {
+        return nullptr;
+    }
+    return factors;
+}
+
+/// X  A * X = B     (low -    B)
+template<typename T, typename Low>
+Matrix<T> lowPrecisionSolve(const LUDecomposition<Low>& factors, const Matrix<T>& b, Matrix<Low>& low) {
+    //     Low  - ,      
+    convertMatrix(b, low);
+    const Matrix<Low> y = factors.solve(low);
+    Matrix<T> x(b.getRows(), b.getCols(), typename Matrix<T>::Uninitialized{});
+    convertMatrix(y, x);
+    return x;
+}
+
+inline constexpr const char* singularSolveMessage = " ,     ";
+inline constexpr const char* singularInverseMessage = "     ";
+
+///   A * X = B;     LU   ,
+///   fullFactors() (LUDecomposition<T>      ),
+///   A     -  invalid_argument   singularMessage
+template<typename T, typename Low, typename FullFactors>
+Matrix<T> refineSolve(const Matrix<T>& a, double normA, const LUDecomposition<Low>& factors,
+    const Matrix<T>& b, size_t maxIterations, RefinementInfo* info, FullFactors&& fullFactors, const char* singularMessage) {
+    const size_t n = a.getRows();
+    const size_t m = b.getCols();
+    if (b.getRows() != n) {
+        throw std::invalid_argument("        ");
+    }
+    //   dsgesv: ||r_j|| <= sqrt(n) * eps * ||A|| * ||x_j||   
+    const double tolerance = std::sqrt(double(n)) * std::numeric_limits<double>::epsilon();
+    std::vector<double> residualNorms(m), solutionNorms(m);
+    Matrix<Low> low(n, m, typename Matrix<Low>::Uninitialized{});
+    Matrix<T> x = lowPrecisionSolve(factors, b, low);
+    Matrix<T> r(n, m, typename Matrix<T>::Uninitialized{});
+    RefinementInfo result;
+
+    for (size_t iteration = 0; iteration <= maxIterations; iteration++) {
+        r = b;
+        multiplyInto(r, a, x, T(-1), T(1));
+        columnMaxNorms(r, residualNorms.data());
+        columnMaxNorms(x, solutionNorms.data());
+        bool done = true;
+        double worst = 0;
+        for (size_t j = 0; j < m; j++) {
+            const double scale = normA * solutionNorms[j];
+            done &= std::isfinite(residualNorms[j]) && residualNorms[j] <= tolerance * scale;
+            const double error = scale > 0 ? residualNorms[j] / scale : residualNorms[j];
+            if (!(error <= worst)) {
+                worst = error;
+            }
+        }
+        result.iterations = iteration;
+        result.backwardError = worst;
+        if (done) {
+            result.converged = true;
+            if (info != nullptr) {
+                *info = result;
+            }
+            return x;
+        }
+        if (iteration == maxIterations || !std::isfinite(worst)) {
+            break;
+        }
+        x += lowPrecisionSolve(factors, r, low);
+    }
+
+    //    (  1 / eps(float)  )
+    const auto& full = fullFactors();
+    if (full.isSingular()) {
+        throw std::invalid_argument(singularMessage);
+    }
+    x = full.solve(b);
+    if (info != nullptr) {
+        *info = result;
+    }
+    return x;
+}
+
+template<typename T>
+Matrix<T> identityMatrix(size_t n) {
+    Matrix<T> identity(n, n);
+    for (size_t i = 0; i < n; i++) {
+        identity(i, i) = T(1);
+    }
+    return identity;
+}
+
+} // namespace detail
+
+
+///  A         T (double  complex<double>)
+template<typename T>
+class MixedPrecisionSolver {
+public:
+    using Low = typename detail::LowerPrecision<T>::type;
+
+    ///   ,   dsgesv
+    static constexpr size_t maxIterations = 30;
+
+private:
+    ///    : ,  A    Low,  -  
+    ///  ;       (     )
+    struct FullFactors {
+        std::once_flag once;
+        std::unique_ptr<LUDecomposition<T>> factors;
+    };
+
+    Matrix<T> a;
+    double normA;
+    std::unique_ptr<LUDecomposition<Low>> lowFactors;
+    std::unique_ptr<FullFactors> full;
+
+    const LUDecomposition<T>& fullFactors() const {
+        std::call_once(full->once, [this] { full->factors = std::make_unique<LUDecomposition<T>>(a); });
+        return *full->factors;
+    }
+
+public:
+    explicit MixedPrecisionSolver(const Matrix<T>& matrix) : a(matrix), normA(detail::normInf(a)),
+        lowFactors(detail::lowPrecisionFactors<Low>(a)), full(std::make_unique<FullFactors>()) {
+        if (!lowFactors) {
+            fullFactors();
+        }
+    }
+
+    ///       ( -   LU)
+    bool usesLowPrecision() const {
+        return lowFactors != nullptr;
+    }
+
+    ///  A * X = B    B ; info -     
+    Matrix<T> solve(const Matrix<T>& b, RefinementInfo* info = nullptr) const {
+        if (!lowFactors) {
+            if (info != nullptr) {
+                *info = RefinementInfo();
+            }
+            return fullFactors().solve(b);
+        }
+        return detail::refineSolve(a, normA, *lowFactors, b, maxIterations, info,
+            [this]() -> const LUDecomposition<T>& { return fullFactors(); }, detail::singularSolveMessage);
+    }
+
+    ///   (A * X = E  ).
+    ///   -   n x n  double  ,     
+    ///   solve; inverse  ,    double   .
+    Matrix<T> inverse(RefinementInfo* info = nullptr) const {
+        if (!lowFactors) {
+            if (info != nullptr) {
+                *info = RefinementInfo();
+            }
+            return fullFactors().inverse();
+        }
+        return detail::refineSolve(a, normA, *lowFactors, detail::identityMatrix<T>(a.getRows()), maxIterations, info,
+            [this]() -> const LUDecomposition<T>& { return fullFactors(); }, detail::singularInverseMessage);
+    }
+};
+
+
+///   A * X = B      (A  )
+template<typename T>
+Matrix<T> solveMixed(const Matrix<T>& a, const Matrix<T>& b, RefinementInfo* info = nullptr) {
+    using Low = typename detail::LowerPrecision<T>::type;
+    const auto factors = detail::lowPrecisionFactors<Low>(a);
+    if (!factors) {
+        if (info != nullptr) {
+            *info = RefinementInfo();
+        }
+        return solve(a, b);
+    }
+    return detail::refineSolve(a, detail::normInf(a), *factors, b, MixedPrecisionSolver<T>::maxIterations, info,
+        [&a] { return LUDecomposition<T>(a); }, detail::singularSolveMessage);
+}
+
+///       
+template<typename T>
+Matrix<T> inverseMixed(const Matrix<T>& a, RefinementInfo* info = nullptr) {
+    using Low = typename detail::LowerPrecision<T>::type;
+    const auto factors = detail::lowPrecisionFactors<Low>(a);
+    if (!factors) {
+        if (info != nullptr) {
+            *info = RefinementInfo();
+        }
+        return inverse(a);
+    }
+    return detail::refineSolve(a, detail::normInf(a), *factors, detail::identityMatrix<T>(a.getRows()),
+        MixedPrecisionSolver<T>::maxIterations, info, [&a] { return LUDecomposition<T>(a); }, detail::singularInverseMessage);
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include <type_traits>
+
+
+///    Mod -        Matrix<ModInt<Mod>>.
+///     [0, Mod); Mod < 2^31,     
+///  uint32_t,   -  uint64_t.  -      ,
+///      .
+template<uint32_t Mod>
+class ModInt {
+    static_assert(Mod >= 2 && Mod < (1u << 31), "    2  2^31");
+
+private:
+    uint32_t value;
+
+public:
+    static constexpr uint32_t modulus = Mod;
+
+    constexpr ModInt() : value(0) {}
+
+    ///    (   [0, Mod))
+    template<typename I, typename = std::enable_if_t<std::is_integral_v<I>>>
+    constexpr ModInt(I x) : value(0) {
+        if constexpr (std::is_signed_v<I>) {
+            const int64_t r = static_cast<int64_t>(x) % static_cast<int64_t>(Mod);
+            value = static_cast<uint32_t>(r < 0 ? r + Mod : r);
+        }
+        else {
+            value = static_cast<uint32_t>(static_cast<uint64_t>(x) % Mod);
+        }
+    }
+
+    constexpr uint32_t get() const {
+        return value;
+    }
+
+    constexpr ModInt& operator+=(ModInt other) {
+        value += other.value;
+        if (value >= Mod) {
+            value -= Mod;
+        }
+        return *this;
+    }
+
+    constexpr ModInt& operator-=(ModInt other) {
+        value = value >= other.value ? value - other.value : value + Mod - other.value;
+        return *this;
+    }
+
+    constexpr ModInt& operator*=(ModInt other) {
+        value = static_cast<uint32_t>(static_cast<uint64_t>(value) * other.value % Mod);
+        return *this;
+    }
+
+    ModInt& operator/=(ModInt other) {
+        return *this *= other.inverse();
+    }
+
+    constexpr ModInt operator-() const {
+        return ModInt() - *this;
+    }
+
+    ///     
+    constexpr ModInt pow(uint64_t e) const {
+        ModInt result(1);
+        ModInt base = *this;
+        while (e != 0) {
+            if (e & 1) {
+                result *= base;
+            }
+            base *= base;
+            e >>= 1;
+        }
+        return result;
+    }
+
+    ///  : a^(Mod - 2) (   )
+    ModInt inverse() const {
+        if (value == 0) {
+            throw std::invalid_argument("  ");
+        }
+        return pow(Mod - 2);
+    }
+
+    friend constexpr ModInt operator+(ModInt left, ModInt right) {
+        return left += right;
+    }
+
+    friend constexpr ModInt operator-(ModInt left, ModInt right) {
+        return left -= right;
+    }
+
+    friend constexpr ModInt operator*(ModInt left, ModInt right) {
+        return left *= right;
+    }
+
+    friend ModInt operator/(ModInt left, ModInt right) {
+        return left /= right;
+    }
+
+    friend constexpr bool operator==(ModInt left, ModInt right) {
+        return left.value == right.value;
+    }
+
+    friend constexpr bool operator!=(ModInt left, ModInt right) {
+        return left.value != right.value;
+    }
+
+    friend std::ostream& operator<<(std::ostream& os, ModInt x) {
+        return os << x.value;
+    }
+};
+
+
+///   ModInt
+template<typename T>
+struct is_mod_int : std::false_type {};
+
+template<uint32_t Mod>
+struct is_mod_int<ModInt<Mod>> : std::true_type {};
@@ -0,0 +1,795 @@
+#pragma once
+
+#include <cstddef>
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <iostream>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "matrix.h"
+#include "dense_vector.h"
+#include "blas.h"
+#include "gemm.h"
+#include "lu.h"
+#include "simd.h"
+#include "thread_pool.h"
+
+
+///    n x n  :    .
+///  SymmetricMatrix -    , n (n + 1) / 2  (A = A^T);
+///  TriangularMatrix -      , n (n + 1) / 2 ;
+///  BandMatrix - kl   ku , n (kl + ku + 1) .
+///         .
+///           
+///    gemm (  -   B  ),    -  
+///  ,   - .  :   ,
+///   , LU        .
+
+///   
+enum class Triangle {
+    Upper,
+    Lower
+};
+
+namespace detail {
+
+///   ,   gemm
+inline constexpr size_t packedStripRows = 64;
+
+///   i    n x n (  )
+template<Triangle U>
+inline size_t packedRowStart(size_t n, size_t i) {
+    return U == Triangle::Upper ? i * (2 * n - i + 1) / 2 : i * (i + 1) / 2;
+}
+
+///   (i, j)   
+template<Triangle U>
+inline size_t packedIndex(size_t n, size_t i, size_t j) {
+    return U == Triangle::Upper ? packedRowStart<U>(n, i) + (j - i) : packedRowStart<U>(n, i) + j;
+}
+
+/// y[0, n) += s * x[0, n)    
+template<typename T>
+void packedAxpy(T s, const T* x, T* y, size_t n) {
+    withBlasKernels<T>([&](auto kernels) {
+        kernels.axpy(s, x, y, n);
+    });
+}
+
+///  [i0, i0 + rows)   :  [i0, n)  dst   ld,   - 
+template<typename T>
+void packedUpperStrip(size_t n, const T* u, size_t i0, size_t rows, T* dst, size_t ld) {
+    for (size_t r = 0; r < rows; r++) {
+        const T* row = u + packedRowStart<Triangle::Upper>(n, i0 + r);
+        std::fill(dst + r * ld, dst + r * ld + r, T());
+        std::copy(row, row + (n - i0 - r), dst + r * ld + r);
+    }
+}
+
+/// X = U^-1 X (transposed == false)  X = U^-T X, U -    n x n.
+///   packedStripRows :  U ,   
+/// ,   X   gemm
+template<typename T>
+void packedUpperSolve(size_t n, const T* u, T* x, size_t ldx, size_t cols, bool transposed) {
+    if (n == 0 || cols == 0) {
+        return;
+    }
+    const size_t nb = packedStripRows;
+    Matrix<T> strip(std::min(nb, n), n, typename Matrix<T>::Uninitialized{});
+    T* s = strip.getData();
+    const size_t ld = strip.getStride();
+    const size_t blocks = (n + nb - 1) / nb;
+    for (size_t b = 0; b < blocks; b++) {
+        const size_t i0 = (transposed ? b : blocks - 1 - b) * nb;
+        const size_t rows = std::min(nb, n - i0);
+        const size_t rest = n - i0 - rows;
+        T* xb = x + i0 * ldx;
+        packedUpperStrip(n, u, i0, rows, s, ld);
+        if (transposed) {
+            // U^T - :  k  ,     
+            for (size_t k = 0; k < rows; k++) {
+                const T inv = T(1) / s[k * ld + k];
+                for (size_t c = 0; c < cols; c++) {
+                    xb[k * ldx + c] *= inv;
+                }
+                for (size_t j = k + 1; j < rows; j++) {
+                    packedAxpy(-s[k * ld + j], xb + k * ldx, xb + j * ldx, cols);
+                }
+            }
+            if (rest != 0) {
+                gemm<T>(rest, cols, rows, T(-1), s + rows, 1, ld, xb, ldx, 1, T(1), xb + rows * ldx, ldx);
+            }
+            continue;
+        }
+        if (rest != 0) {
+            gemm<T>(rows, cols, rest, T(-1), s + rows, ld, 1, xb + rows * ldx, ldx, 1, T(1), xb, ldx);
+        }
+        for (size_t i = rows; i-- > 0;) {
+            for (size_t j = i + 1; j < rows; j++) {
+                packedAxpy(-s[i * ld + j], xb + j * ldx, xb + i * ldx, cols);
+            }
+            const T inv = T(1) / s[i * ld + i];
+            for (size_t c = 0; c < cols; c++) {
+                xb[i * ldx + c] *= inv;
+            }
+        }
+    }
+}
+
+/// X = L^-1 X, L -    n x n ( -   packedUpperSolve)
+template<typename T>
+void packedLowerSolve(size_t n, const T* l, T* x, size_t ldx, size_t cols) {
+    if (n == 0 || cols == 0) {
+        return;
+    }
+    const size_t nb = packedStripRows;
+    Matrix<T> strip(std::min(nb, n), n, typename Matrix<T>::Uninitialized{});
+    T* s = strip.getData();
+    const size_t ld = strip.getStride();
+    for (size_t i0 = 0; i0 < n; i0 += nb) {
+        const size_t rows = std::min(nb, n - i0);
+        for (size_t r = 0; r < rows; r++) {
+            const T* row = l + packedRowStart<Triangle::Lower>(n, i0 + r);
+            std::copy(row, row + (i0 + r + 1), s + r * ld);
+        }
+        T* xb = x + i0 * ldx;
+        if (i0 != 0) {
+            gemm<T>(rows, cols, i0, T(-1), s, ld, 1, x, ldx, 1, T(1), xb, ldx);
+        }
+        for (size_t i = 0; i < rows; i++) {
+            for (size_t j = 0; j < i; j++) {
+                packedAxpy(-s[i * ld + i0 + j], xb + j * ldx, xb + i * ldx, cols);
+            }
+            const T inv = T(1) / s[i * ld + i0 + i];
+            for (size_t c = 0; c < cols; c++) {
+                xb[i * ldx + c] *= inv;
+            }
+        }
+    }
+}
+
+inline void checkSquare(size_t rows, size_t cols) {
+    if (rows != cols) {
+        throw std::invalid_argument("   ");
+    }
+}
+
+template<typename T>
+void checkProduct(size_t n, const Matrix<T>& b) {
+    if (b.getRows() != n) {
+        throw std::invalid_argument("        ");
+    }
+}
+
+template<typename T>
+void checkRightSide(size_t n, const Matrix<T>& b) {
+    if (b.getRows() != n) {
+        throw std::invalid_argument("        ");
+    }
+}
+
+} // namespace detail
+
+
+template<typename T, Triangle U>
+class TriangularMatrix;
+
+///  :     
+template<typename T>
+class SymmetricMatrix {
+public:
+    using value_type = T;
+
+private:
+    size_t n;
+    Vector<T> packed;
+
+    SymmetricMatrix(size_t n, typename Vector<T>::Uninitialized)
+        : n(n), packed(n * (n + 1) / 2, typename Vector<T>::Uninitialized{}) {}
+
+    ///  [i0, i0 + rows)  ( n )     ld
+    void unpackRows(size_t i0, size_t rows, T* dst, size_t ld) const {
+        const T* p = packed.getData();
+        //    i -  i  :   j   (j, i0..)
+        for (size_t j = 0; j < i0 + rows; j++) {
+            const size_t first = std::max(i0, j + 1);
+            const T* row = p + detail::packedRowStart<Triangle::Upper>(n, j);
+            for (size_t i = first; i < i0 + rows; i++) {
+                dst[(i - i0) * ld + j] = row[i - j];
+            }
+        }
+        for (size_t i = i0; i < i0 + rows; i++) {
+            const T* row = p + detail::packedRowStart<Triangle::Upper>(n, i);
+            std::copy(row, row + (n - i), dst + (i - i0) * ld + i);
+        }
+    }
+
+public:
+    explicit SymmetricMatrix(size_t n, T value = T()) : n(n), packed(n * (n + 1) / 2, value) {}
+
+    ///    :    (  )
+    explicit SymmetricMatrix(const Matrix<T>& dense) : SymmetricMatrix(dense.getRows(), typename Vector<T>::Uninitialized{}) {
+        detail::checkSquare(dense.getRows(), dense.getCols());
+        for (size_t i = 0; i < n; i++) {
+            std::copy(&dense(i, 0) + i, &dense(i, 0) + n, packed.getData() + detail::packedRowStart<Triangle::Upper>(n, i));
+        }
+    }
+
+    Matrix<T> toMatrix() const {
+        Matrix<T> dense(n, n, typename Matrix<T>::Uninitialized{});
+        if (n != 0) {
+            unpackRows(0, n, dense.getData(), dense.getStride());
+        }
+        return dense;
+    }
+
+    ///  (i, j)    (j, i) -  
+    T& operator()(size_t i, size_t j) {
+        if (i >= n || j >= n) {
+            throw std::out_of_range("  ");
+        }
+        return packed.getData()[detail::packedIndex<Triangle::Upper>(n, std::min(i, j), std::max(i, j))];
+    }
+
+    const T& operator()(size_t i, size_t j) const {
+        if (i >= n || j >= n) {
+            throw std::out_of_range("  ");
+        }
+        return packed.getData()[detail::packedIndex<Triangle::Upper>(n, std::min(i, j), std::max(i, j))];
+    }
+
+    size_t getRows() const {
+        return n;
+    }
+
+    size_t getCols() const {
+        return n;
+    }
+
+    ///  :    
+    const Vector<T>& getPacked() const {
+        return packed;
+    }
+
+    SymmetricMatrix& operator+=(const SymmetricMatrix& other) {
+        if (n != other.n) {
+            throw std::invalid_argument("      ");
+        }
+        packed += other.packed;
+        return *this;
+    }
+
+    SymmetricMatrix& operator-=(const SymmetricMatrix& other) {
+        if (n != other.n) {
+            throw std::invalid_argument("      ");
+        }
+        packed -= other.packed;
+        return *this;
+    }
+
+    SymmetricMatrix& operator*=(T scalar) {
+        packed *= scalar;
+        return *this;
+    }
+
+    friend SymmetricMatrix operator+(SymmetricMatrix left, const SymmetricMatrix& right) {
+        left += right;
+        return left;
+    }
+
+    friend SymmetricMatrix operator-(SymmetricMatrix left, const SymmetricMatrix& right) {
+        left -= right;
+        return left;
+    }
+
+    friend SymmetricMatrix operator*(SymmetricMatrix matrix, T scalar) {
+        matrix *= scalar;
+        return matrix;
+    }
+
+    friend SymmetricMatrix operator*(T scalar, SymmetricMatrix matrix) {
+        matrix *= scalar;
+        return matrix;
+    }
+
+    /// A * B:   A    gemm
+    friend Matrix<T> operator*(const SymmetricMatrix& a, const Matrix<T>& b) {
+        detail::checkProduct(a.n, b);
+        Matrix<T> c(a.n, b.getCols(), typename Matrix<T>::Uninitialized{});
+        Matrix<T> strip(std::min(detail::packedStripRows, a.n), a.n, typename Matrix<T>::Uninitialized{});
+        for (size_t i0 = 0; i0 < a.n; i0 += detail::packedStripRows) {
+            const size_t rows = std::min(detail::packedStripRows, a.n - i0);
+            a.unpackRows(i0, rows, strip.getData(), strip.getStride());
+            gemm<T>(rows, b.getCols(), a.n, T(1), strip.getData(), strip.getStride(), 1,
+                b.getData(), b.getStride(), 1, T(), c.getData() + i0 * c.getStride(), c.getStride());
+        }
+        return c;
+    }
+
+    ///   A = U^T U (U -  ).   
+    ///  ,  A   ;   -    
+    TriangularMatrix<T, Triangle::Upper> cholesky() const;
+
+    ///  A * X = B   
+    Matrix<T> solve(const Matrix<T>& b) const;
+
+    friend std::ostream& operator<<(std::ostream& os, const SymmetricMatrix& matrix) {
+        return os << matrix.toMatrix();
+    }
+};
+
+
+///  :   (U = Upper)     
+template<typename T, Triangle U = Triangle::Upper>
+class TriangularMatrix {
+    template<typename>
+    friend class SymmetricMatrix;
+
+public:
+    using value_type = T;
+    static constexpr Triangle triangle = U;
+
+private:
+    size_t n;
+    Vector<T> packed;
+
+    TriangularMatrix(size_t n, typename Vector<T>::Uninitialized)
+        : n(n), packed(n * (n + 1) / 2, typename Vector<T>::Uninitialized{}) {}
+
+    bool stored(size_t i, size_t j) const {
+        return U == Triangle::Upper ? j >= i : j <= i;
+    }
+
+    ///   i,  : [first, last)
+    size_t rowFirst(size_t i) const {
+        return U == Triangle::Upper ? i : 0;
+    }
+
+    size_t rowLast(size_t i) const {
+        return U == Triangle::Upper ? n : i + 1;
+    }
+
+public:
+    explicit TriangularMatrix(size_t n, T value = T()) : n(n), packed(n * (n + 1) / 2, value) {}
+
+    ///    :   U (  )
+    explicit TriangularMatrix(const Matrix<T>& dense) : TriangularMatrix(dense.getRows(), typename Vector<T>::Uninitialized{}) {
+        detail::checkSquare(dense.getRows(), dense.getCols());
+        for (size_t i = 0; i < n; i++) {
+            std::copy(&dense(i, 0) + rowFirst(i), &dense(i, 0) + rowLast(i), packed.getData() + detail::packedRowStart<U>(n, i));
+        }
+    }
+
+    Matrix<T> toMatrix() const {
+        Matrix<T> dense(n, n);
+        for (size_t i = 0; i < n; i++) {
+            const T* row = packed.getData() + detail::packedRowStart<U>(n, i);
+            std::copy(row, row + (rowLast(i) - rowFirst(i)), &dense(i, 0) + rowFirst(i));
+        }
+        return dense;
+    }
+
+    ///   -    
+    T& operator()(size_t i, size_t j) {
+        if (i >= n || j >= n || !stored(i, j)) {
+            throw std::out_of_range("  ");
+        }
+        return packed.getData()[detail::packedIndex<U>(n, i, j)];
+    }
+
+    ///    - 
+    T operator()(size_t i, size_t j) const {
+        if (i >= n || j >= n) {
+            throw std::out_of_range("  ");
+        }
+        return stored(i, j) ? packed.getData()[detail::packedIndex<U>(n, i, j)] : T();
+    }
+
+    size_t getRows() const {
+        return n;
+    }
+
+    size_t getCols() const {
+        return n;
+    }
+
+    ///  :    
+    const Vector<T>& getPacked() const {
+        return packed;
+    }
+
+    ///  -  
+    T det() const {
+        T result = T(1);
+        for (size_t i = 0; i < n; i++) {
+            result *= packed.getData()[detail::packedIndex<U>(n, i, i)];
+        }
+        return result;
+    }
+
+    TriangularMatrix& operator+=(const TriangularMatrix& other) {
+        if (n != other.n) {
+            throw std::invalid_argument("      ");
+        }
+        packed += other.packed;
+        return *this;
+    }
+
+    TriangularMatrix& operator-=(const TriangularMatrix& other) {
+        if (n != other.n) {
+            throw std::invalid_argument("      ");
+        }
+        packed -= other.packed;
+        return *this;
+    }
+
+    TriangularMatrix& operator*=(T scalar) {
+        packed *= scalar;
+        return *this;
+    }
+
+    friend TriangularMatrix operator+(TriangularMatrix left, const TriangularMatrix& right) {
+        left += right;
+        return left;
+    }
+
+    friend TriangularMatrix operator-(TriangularMatrix left, const TriangularMatrix& right) {
+        left -= right;
+        return left;
+    }
+
+    friend TriangularMatrix operator*(TriangularMatrix matrix, T scalar) {
+        matrix *= scalar;
+        return matrix;
+    }
+
+    friend TriangularMatrix operator*(T scalar, TriangularMatrix matrix) {
+        matrix *= scalar;
+        return matrix;
+    }
+
+    /// A * B:  gemm    ,  A  
+    friend Matrix<T> operator*(const TriangularMatrix& a, const Matrix<T>& b) {
+        detail::checkProduct(a.n, b);
+        const size_t n = a.n;
+        Matrix<T> c(n, b.getCols(), typename Matrix<T>::Uninitialized{});
+        Matrix<T> strip(std::min(detail::packedStripRows, n), n, typename Matrix<T>::Uninitialized{});
+        for (size_t i0 = 0; i0 < n; i0 += detail::packedStripRows) {
+            const size_t rows = std::min(detail::packedStripRows, n - i0);
+            //   [i0, i0 + rows)   [j0, j1)
+            const size_t j0 = U == Triangle::Upper ? i0 : 0;
+            const size_t j1 = U == Triangle::Upper ? n : i0 + rows;
+            for (size_t i = i0; i < i0 + rows; i++) {
+                T* dst = strip.getData() + (i - i0) * strip.getStride();
+                const T* row = a.packed.getData() + detail::packedRowStart<U>(n, i);
+                std::fill(dst, dst + (j1 - j0), T());
+                std::copy(row, row + (a.rowLast(i) - a.rowFirst(i)), dst + (a.rowFirst(i) - j0));
+            }
+            gemm<T>(rows, b.getCols(), j1 - j0, T(1), strip.getData(), strip.getStride(), 1,
+                b.getData() + j0 * b.getStride(), b.getStride(), 1, T(), c.getData() + i0 * c.getStride(), c.getStride());
+        }
+        return c;
+    }
+
+    ///  A * X = B 
+    Matrix<T> solve(const Matrix<T>& b) const {
+        detail::checkRightSide(n, b);
+        for (size_t i = 0; i < n; i++) {
+            if (packed.getData()[detail::packedIndex<U>(n, i, i)] == T()) {
+                throw std::invalid_argument(" ,     ");
+            }
+        }
+        Matrix<T> x(b);
+        if constexpr (U == Triangle::Upper) {
+            detail::packedUpperSolve(n, packed.getData(), x.getData(), x.getStride(), x.getCols(), false);
+        }
+        else {
+            detail::packedLowerSolve(n, packed.getData(), x.getData(), x.getStride(), x.getCols());
+        }
+        return x;
+    }
+
+    friend std::ostream& operator<<(std::ostream& os, const TriangularMatrix& matrix) {
+        return os << matrix.toMatrix();
+    }
+};
+
+
+template<typename T>
+TriangularMatrix<T, Triangle::Upper> SymmetricMatrix<T>::cholesky() const {
+    TriangularMatrix<T, Triangle::Upper> factor(n, typename Vector<T>::Uninitialized{});
+    std::copy(packed.begin(), packed.end(), factor.packed.begin());
+    T* p = factor.packed.getData();
+    if (n == 0) {
+        return factor;
+    }
+    //   :   nb    ,   
+    //  P^T P (P -     ) -   nb   gemm
+    const size_t nb = detail::packedStripRows;
+    Matrix<T> strip(std::min(nb, n), n, typename Matrix<T>::Uninitialized{});
+    Matrix<T> update(std::min(nb, n), n, typename Matrix<T>::Uninitialized{});
+    T* s = strip.getData();
+    const size_t ld = strip.getStride();
+    for (size_t k0 = 0; k0 < n; k0 += nb) {
+        const size_t rows = std::min(nb, n - k0);
+        const size_t width = n - k0;
+        detail::packedUpperStrip(n, p, k0, rows, s, ld);
+        for (size_t k = 0; k < rows; k++) {
+            T* row = s + k * ld;
+            if constexpr (is_complex<T>::value) {
+                if (row[k] == T()) {
+                    throw std::invalid_argument(" ,   ");
+                }
+            }
+            else if (!(row[k] > T())) {
+                throw std::invalid_argument("   ");
+            }
+            const T diag = std::sqrt(row[k]);
+            const T inv = T(1) / diag;
+            row[k] = diag;
+            for (size_t j = k + 1; j < width; j++) {
+                row[j] *= inv;
+            }
+            for (size_t i = k + 1; i < rows; i++) {
+                detail::packedAxpy(-row[i], row + i, s + i * ld + i, width - i);
+            }
+        }
+        for (size_t r = 0; r < rows; r++) {
+            std::copy(s + r * ld + r, s + r * ld + width, p + detail::packedRowStart<Triangle::Upper>(n, k0 + r));
+        }
+        const size_t rest = width - rows;
+        const T* panel = s + rows;
+        for (size_t j0 = 0; j0 < rest; j0 += nb) {
+            const size_t jb = std::min(nb, rest - j0);
+            gemm<T>(jb, rest - j0, rows, T(1), panel + j0, 1, ld, panel + j0, ld, 1, T(), update.getData(), update.getStride());
+            for (size_t r = 0; r < jb; r++) {
+                T* dst = p + detail::packedRowStart<Triangle::Upper>(n, k0 + rows + j0 + r);
+                detail::elementwise<detail::SubOp>(dst, update.getData() + r * update.getStride() + r, dst, rest - j0 - r);
+            }
+        }
+    }
+    return factor;
+}
+
+template<typename T>
+Matrix<T> SymmetricMatrix<T>::solve(const Matrix<T>& b) const {
+    detail::checkRightSide(n, b);
+    const TriangularMatrix<T, Triangle::Upper> factor = cholesky();
+    Matrix<T> x(b);
+    detail::packedUpperSolve(n, factor.getPacked().getData(), x.getData(), x.getStride(), x.getCols(), true);
+    detail::packedUpperSolve(n, factor.getPacked().getData(), x.getData(), x.getStride(), x.getCols(), false);
+    return x;
+}
+
+
+///   n x n: kl   ku .
+///  i   [i - kl, i + ku]  kl + ku + 1  ;     - 
+template<typename T>
+class BandMatrix {
+public:
+    using value_type = T;
+
+private:
+    size_t n;
+    size_t kl;
+    size_t ku;
+    Vector<T> band;
+
+    size_t width() const {
+        return kl + ku + 1;
+    }
+
+    bool stored(size_t i, size_t j) const {
+        return j + kl >= i && j <= i + ku;
+    }
+
+    ///   i  : [first, last)
+    size_t rowFirst(size_t i) const {
+        return i > kl ? i - kl : 0;
+    }
+
+    size_t rowLast(size_t i) const {
+        return std::min(n, i + ku + 1);
+    }
+
+    const T* rowPtr(size_t i) const {
+        return band.getData() + i * width() + kl - i;
+    }
+
+    T* rowPtr(size_t i) {
+        return band.getData() + i * width() + kl - i;
+    }
+
+    ///    :     -  
+    template<typename Op>
+    BandMatrix combine(const BandMatrix& other) const {
+        if (n != other.n) {
+            throw std::invalid_argument("      ");
+        }
+        if (kl == other.kl && ku == other.ku) {
+            BandMatrix result(*this);
+            detail::elementwise<Op>(band.getData(), other.band.getData(), result.band.getData(), band.size());
+            return result;
+        }
+        BandMatrix result(n, std::max(kl, other.kl), std::max(ku, other.ku));
+        for (size_t i = 0; i < n; i++) {
+            for (size_t j = rowFirst(i); j < rowLast(i); j++) {
+                result.rowPtr(i)[j] = rowPtr(i)[j];
+            }
+            for (size_t j = other.rowFirst(i); j < other.rowLast(i); j++) {
+                result.rowPtr(i)[j] = Op::scalar(result.rowPtr(i)[j], other.rowPtr(i)[j]);
+            }
+        }
+        return result;
+    }
+
+public:
+    BandMatrix(size_t n, size_t kl, size_t ku) : n(n), kl(kl), ku(ku), band(n * (kl + ku + 1)) {}
+
+    ///    :   (    )
+    BandMatrix(const Matrix<T>& dense, size_t kl, size_t ku) : BandMatrix(dense.getRows(), kl, ku) {
+        detail::checkSquare(dense.getRows(), dense.getCols());
+        for (size_t i = 0; i < n; i++) {
+            for (size_t j = rowFirst(i); j < rowLast(i); j++) {
+                rowPtr(i)[j] = dense(i, j);
+            }
+        }
+    }
+
+    Matrix<T> toMatrix() const {
+        Matrix<T> dense(n, n);
+        for (size_t i = 0; i < n; i++) {
+            std::copy(rowPtr(i) + rowFirst(i), rowPtr(i) + rowLast(i), &dense(i, 0) + rowFirst(i));
+        }
+        return dense;
+    }
+
+    ///   -    
+    T& operator()(size_t i, size_t j) {
+        if (i >= n || j >= n || !stored(i, j)) {
+            throw std::out_of_range("  ");
+        }
+        return rowPtr(i)[j];
+    }
+
+    ///    - 
+    T operator()(size_t i, size_t j) const {
+        if (i >= n || j >= n) {
+            throw std::out_of_range("  ");
+        }
+        return stored(i, j) ? rowPtr(i)[j] : T();
+    }
+
+    size_t getRows() const {
+        return n;
+    }
+
+    size_t getCols() const {
+        return n;
+    }
+
+    size_t getLowerBandwidth() const {
+        return kl;
+    }
+
+    size_t getUpperBandwidth() const {
+        return ku;
+    }
+
+    BandMatrix& operator*=(T scalar) {
+        band *= scalar;
+        return *this;
+    }
+
+    friend BandMatrix operator+(const BandMatrix& left, const BandMatrix& right) {
+        return left.template combine<detail::AddOp>(right);
+    }
+
+    friend BandMatrix operator-(const BandMatrix& left, const BandMatrix& right) {
+        return left.template combine<detail::SubOp>(right);
+    }
+
+    friend BandMatrix operator*(BandMatrix matrix, T scalar) {
+        matrix *= scalar;
+        return matrix;
+    }
+
+    friend BandMatrix operator*(T scalar, BandMatrix matrix) {
+        matrix *= scalar;
+        return matrix;
+    }
+
+    /// A * B:  C -    kl + ku + 1  B    
+    friend Matrix<T> operator*(const BandMatrix& a, const Matrix<T>& b) {
+        detail::checkProduct(a.n, b);
+        const size_t cols = b.getCols();
+        Matrix<T> c(a.n, cols);
+        const size_t rowsPerTask = std::max<size_t>(1, detail::blasChunk / std::max<size_t>(1, a.width() * cols));
+        parallelFor((a.n + rowsPerTask - 1) / rowsPerTask, [&](size_t t) {
+            const size_t r0 = t * rowsPerTask;
+            const size_t r1 = std::min(a.n, r0 + rowsPerTask);
+            detail::withBlasKernels<T>([&](auto kernels) {
+                for (size_t i = r0; i < r1; i++) {
+                    T* out = c.getData() + i * c.getStride();
+                    for (size_t j = a.rowFirst(i); j < a.rowLast(i); j++) {
+                        kernels.axpy(a.rowPtr(i)[j], b.getData() + j * b.getStride(), out, cols);
+                    }
+                }
+            });
+        });
+        return c;
+    }
+
+    ///  A * X = B: LU      kl   .
+    ///     U  ku + kl,       2 kl + ku + 1
+    Matrix<T> solve(const Matrix<T>& b) const {
+        detail::checkRightSide(n, b);
+        const size_t w = 2 * kl + ku + 1;
+        //  i     [i - kl, i + ku + kl]
+        std::vector<T> lu(n * w, T());
+        auto at = [&](size_t i, size_t j) -> T& {
+            return lu[i * w + kl + j - i];
+        };
+        for (size_t i = 0; i < n; i++) {
+            for (size_t j = rowFirst(i); j < rowLast(i); j++) {
+                at(i, j) = rowPtr(i)[j];
+            }
+        }
+        std::vector<size_t> pivots(n);
+        for (size_t k = 0; k < n; k++) {
+            const size_t last = std::min(n, k + kl + 1);
+            const size_t right = std::min(n, k + ku + kl + 1);
+            size_t p = k;
+            for (size_t i = k + 1; i < last; i++) {
+                if (detail::pivotMagnitude(at(i, k)) > detail::pivotMagnitude(at(p, k))) {
+                    p = i;
+                }
+            }
+            pivots[k] = p;
+            if (at(p, k) == T()) {
+                throw std::invalid_argument(" ,     ");
+            }
+            if (p != k) {
+                std::swap_ranges(&at(k, k), &at(k, k) + (right - k), &at(p, k));
+            }
+            const T inv = T(1) / at(k, k);
+            for (size_t i = k + 1; i < last; i++) {
+                T& l = at(i, k);
+                l *= inv;
+                detail::rowAxpy(&at(i, k) + 1, &at(k, k) + 1, l, right - k - 1);
+            }
+        }
+
+        Matrix<T> x(b);
+        const size_t cols = x.getCols();
+        auto xrow = [&](size_t i) {
+            return x.getData() + i * x.getStride();
+        };
+        for (size_t k = 0; k < n; k++) {
+            if (pivots[k] != k) {
+                std::swap_ranges(xrow(k), xrow(k) + cols, xrow(pivots[k]));
+            }
+            for (size_t i = k + 1; i < std::min(n, k + kl + 1); i++) {
+                detail::packedAxpy(-at(i, k), xrow(k), xrow(i), cols);
+            }
+        }
+        for (size_t i = n; i-- > 0;) {
+            for (size_t j = i + 1; j < std::min(n, i + ku + kl + 1); j++) {
+                detail::packedAxpy(-at(i, j), xrow(j), xrow(i), cols);
+            }
+            const T inv = T(1) / at(i, i);
+            for (size_t c = 0; c < cols; c++) {
+                xrow(i)[c] *= inv;
+            }
+        }
+        return x;
+    }
+
+    friend std::ostream& operator<<(std::ostream& os, const BandMatrix& matrix) {
+        return os << matrix.toMatrix();
+    }
+};
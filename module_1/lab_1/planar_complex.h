@@ -0,0 +1,175 @@
+#pragma once
+
+#include <cstddef>
+#include <complex>
+#include <iostream>
+#include <iomanip>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "matrix.h"
+#include "gemm.h"
+
+
+///     () :    
+///     Matrix<R>.      
+///     (re, im),  -   3M (  gemm).
+template<typename R>
+class PlanarComplexMatrix {
+    static_assert(std::is_same_v<R, float> || std::is_same_v<R, double>, "    float  double");
+
+public:
+    using value_type = std::complex<R>;
+
+private:
+    Matrix<R> re;
+    Matrix<R> im;
+
+public:
+    ///   
+    PlanarComplexMatrix(size_t rows, size_t cols, value_type value = value_type())
+        : re(rows, cols, value.real()), im(rows, cols, value.imag()) {}
+
+    ///   
+    PlanarComplexMatrix(Matrix<R> re, Matrix<R> im) : re(std::move(re)), im(std::move(im)) {
+        if (this->re.getRows() != this->im.getRows() || this->re.getCols() != this->im.getCols()) {
+            throw std::invalid_argument("       ");
+        }
+    }
+
+    ///      
+    explicit PlanarComplexMatrix(const Matrix<value_type>& matrix)
+        : re(matrix.getRows(), matrix.getCols(), typename Matrix<R>::Uninitialized{}),
+          im(matrix.getRows(), matrix.getCols(), typename Matrix<R>::Uninitialized{}) {
+        for (size_t i = 0; i < matrix.getRows(); i++) {
+            const value_type* src = matrix.getData() + i * matrix.getStride();
+            R* dstRe = re.getData() + i * re.getStride();
+            R* dstIm = im.getData() + i * im.getStride();
+            for (size_t j = 0; j < matrix.getCols(); j++) {
+                dstRe[j] = src[j].real();
+                dstIm[j] = src[j].imag();
+            }
+        }
+    }
+
+    ///    
+    Matrix<value_type> toInterleaved() const {
+        Matrix<value_type> result(getRows(), getCols(), typename Matrix<value_type>::Uninitialized{});
+        for (size_t i = 0; i < getRows(); i++) {
+            const R* srcRe = re.getData() + i * re.getStride();
+            const R* srcIm = im.getData() + i * im.getStride();
+            value_type* dst = result.getData() + i * result.getStride();
+            for (size_t j = 0; j < getCols(); j++) {
+                dst[j] = value_type(srcRe[j], srcIm[j]);
+            }
+        }
+        return result;
+    }
+
+    ///   (      -   )
+    value_type operator()(size_t row, size_t col) const {
+        return value_type(re(row, col), im(row, col));
+    }
+
+    ///  
+    void set(size_t row, size_t col, value_type value) {
+        re(row, col) = value.real();
+        im(row, col) = value.imag();
+    }
+
+    Matrix<R>& real() {
+        return re;
+    }
+
+    const Matrix<R>& real() const {
+        return re;
+    }
+
+    Matrix<R>& imag() {
+        return im;
+    }
+
+    const Matrix<R>& imag() const {
+        return im;
+    }
+
+    size_t getRows() const {
+        return re.getRows();
+    }
+
+    size_t getCols() const {
+        return re.getCols();
+    }
+
+    bool operator==(const PlanarComplexMatrix& other) const {
+        return re == other.re && im == other.im;
+    }
+
+    bool operator!=(const PlanarComplexMatrix& other) const {
+        return !(*this == other);
+    }
+
+    ///     
+    PlanarComplexMatrix operator+(const PlanarComplexMatrix& other) const {
+        return PlanarComplexMatrix(re + other.re, im + other.im);
+    }
+
+    PlanarComplexMatrix operator-(const PlanarComplexMatrix& other) const {
+        return PlanarComplexMatrix(re - other.re, im - other.im);
+    }
+
+    PlanarComplexMatrix& operator+=(const PlanarComplexMatrix& other) {
+        re += other.re;
+        im += other.im;
+        return *this;
+    }
+
+    PlanarComplexMatrix& operator-=(const PlanarComplexMatrix& other) {
+        re -= other.re;
+        im -= other.im;
+        return *this;
+    }
+
+    ///     
+    PlanarComplexMatrix operator*(value_type scalar) const {
+        return PlanarComplexMatrix(re * scalar.real() - im * scalar.imag(), re * scalar.imag() + im * scalar.real());
+    }
+
+    ///     
+    PlanarComplexMatrix operator/(value_type scalar) const {
+        if (scalar == value_type()) {
+            throw std::invalid_argument("  ");
+        }
+        return *this * (value_type(1) / scalar);
+    }
+
+    ///    (3M)
+    PlanarComplexMatrix operator*(const PlanarComplexMatrix& other) const {
+        if (getCols() != other.getRows()) {
+            throw std::invalid_argument("        ");
+        }
+        PlanarComplexMatrix result(Matrix<R>(getRows(), other.getCols(), typename Matrix<R>::Uninitialized{}),
+            Matrix<R>(getRows(), other.getCols(), typename Matrix<R>::Uninitialized{}));
+        gemm3m<R>(getRows(), other.getCols(), getCols(), re.getData(), im.getData(), re.getStride(),
+            other.re.getData(), other.im.getData(), other.re.getStride(),
+            result.re.getData(), result.im.getData(), result.re.getStride());
+        return result;
+    }
+
+    ///  
+    friend std::ostream& operator<<(std::ostream& os, const PlanarComplexMatrix& matrix) {
+        for (size_t i = 0; i < matrix.getRows(); i++) {
+            for (size_t j = 0; j < matrix.getCols(); j++) {
+                os << std::setw(10) << matrix(i, j) << " ";
+            }
+            os << std::endl;
+        }
+        return os;
+    }
+};
+
+template<typename R>
+PlanarComplexMatrix<R> operator*(std::complex<R> scalar, const PlanarComplexMatrix<R>& matrix) {
+    return matrix * scalar;
+}
@@ -0,0 +1,484 @@
+#pragma once
+
+#include <cstddef>
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "matrix.h"
+#include "gemm.h"
+#include "lu.h"
+#include "thread_pool.h"
+
+
+/// QR-  : A = Q * R, A - m x n.
+///  H = I - tau v v^H    (v[0] = 1  ), R -    .
+///   nb     WY- H1...Hnb = I - V T V^H
+/// (T -   nb x nb),       gemm,
+///     .    (  ).
+///      TSQR:    ,
+///  R       ( ).
+
+namespace detail {
+
+///    
+inline constexpr size_t qrBlock = 64;
+
+/// ,      
+inline constexpr size_t qrLeaf = 8;
+
+///      TSQR:    ,  
+inline constexpr size_t tsqrBlockBytes = size_t(1) << 20;
+
+///      ( ,   ?NRM2)
+template<typename T>
+auto columnNorm(size_t n, const T* x, size_t ld) {
+    using R = decltype(std::abs(T()));
+    R scale = 0;
+    R ssq = 1;
+    auto add = [&](R value) {
+        if (value != R()) {
+            const R a = std::abs(value);
+            if (scale < a) {
+                ssq = 1 + ssq * (scale / a) * (scale / a);
+                scale = a;
+            }
+            else {
+                ssq += (a / scale) * (a / scale);
+            }
+        }
+    };
+    for (size_t i = 0; i < n; i++) {
+        add(std::real(x[i * ld]));
+        add(std::imag(x[i * ld]));
+    }
+    return scale * std::sqrt(ssq);
+}
+
+///    (alpha; x)  n + 1 : H^H (alpha; x) = (beta; 0), beta .
+/// x   v, alpha -  beta;  tau (0 -   )
+template<typename T>
+T householder(size_t n, T* alpha, T* x, size_t ld) {
+    using R = decltype(std::abs(T()));
+    const R xnorm = columnNorm(n, x, ld);
+    const R ar = std::real(*alpha);
+    const R ai = std::imag(*alpha);
+    if (xnorm == R() && ai == R()) {
+        return T();
+    }
+    R beta = std::hypot(std::hypot(ar, ai), xnorm);
+    if (ar >= 0) {
+        beta = -beta;
+    }
+    T tau;
+    if constexpr (is_complex<T>::value) {
+        tau = T((beta - ar) / beta, -ai / beta);
+    }
+    else {
+        tau = (beta - ar) / beta;
+    }
+    const T scale = T(1) / (*alpha - T(beta));
+    for (size_t i = 0; i < n; i++) {
+        x[i * ld] *= scale;
+    }
+    *alpha = T(beta);
+    return tau;
+}
+
+///    :  m x n   (  )
+template<typename T>
+void qrUnblocked(size_t m, size_t n, T* a, size_t ld, T* tau) {
+    const size_t k = std::min(m, n);
+    std::vector<T> w(n);
+    for (size_t j = 0; j < k; j++) {
+        T* top = a + j * ld + j;
+        tau[j] = householder(m - j - 1, top, top + ld, ld);
+        const size_t rest = n - j - 1;
+        if (rest == 0 || tau[j] == T()) {
+            continue;
+        }
+        // A[j:, j+1:] -= conj(tau) v (v^H A[j:, j+1:]);   ,  -  
+        std::copy(top + 1, top + 1 + rest, w.begin());
+        for (size_t i = j + 1; i < m; i++) {
+            const T vi = conjugate(a[i * ld + j]);
+            const T* row = a + i * ld + j + 1;
+            for (size_t c = 0; c < rest; c++) {
+                w[c] += vi * row[c];
+            }
+        }
+        const T ct = conjugate(tau[j]);
+        for (size_t c = 0; c < rest; c++) {
+            top[1 + c] -= ct * w[c];
+        }
+        for (size_t i = j + 1; i < m; i++) {
+            const T s = ct * a[i * ld + j];
+            T* row = a + i * ld + j + 1;
+            for (size_t c = 0; c < rest; c++) {
+                row[c] -= s * w[c];
+            }
+        }
+    }
+}
+
+///   count ,   : V (rows x count)    
+///    .   V^H  : gemm    
+template<typename T>
+struct Reflectors {
+    size_t rows;
+    size_t count;
+    Matrix<T> v;
+    Matrix<T> vh;
+
+    Reflectors(const T* a, size_t ld, size_t rows, size_t count)
+        : rows(rows), count(count), v(rows, count, typename Matrix<T>::Uninitialized{}),
+        vh(is_complex<T>::value ? count : 0, is_complex<T>::value ? rows : 0, typename Matrix<T>::Uninitialized{}) {
+        T* dst = v.getData();
+        const size_t ldv = v.getStride();
+        for (size_t i = 0; i < rows; i++) {
+            const T* src = a + i * ld;
+            for (size_t c = 0; c < count; c++) {
+                dst[i * ldv + c] = i > c ? src[c] : (i == c ? T(1) : T());
+            }
+        }
+        if constexpr (is_complex<T>::value) {
+            T* h = vh.getData();
+            const size_t ldh = vh.getStride();
+            for (size_t i = 0; i < rows; i++) {
+                for (size_t c = 0; c < count; c++) {
+                    h[c * ldh + i] = std::conj(dst[i * ldv + c]);
+                }
+            }
+        }
+    }
+
+    /// out (count x ncols) = V^H X
+    void adjointTimes(const T* x, size_t ldx, size_t ncols, T* out, size_t ldout) const {
+        if constexpr (is_complex<T>::value) {
+            gemm<T>(count, ncols, rows, T(1), vh.getData(), vh.getStride(), 1, x, ldx, 1, T(), out, ldout);
+        }
+        else {
+            gemm<T>(count, ncols, rows, T(1), v.getData(), 1, v.getStride(), x, ldx, 1, T(), out, ldout);
+        }
+    }
+
+    /// C (rows x ncols) -= V W
+    void subtractTimes(const T* w, size_t ldw, size_t ncols, T* c, size_t ldc) const {
+        gemm<T>(rows, ncols, count, T(-1), v.getData(), v.getStride(), 1, w, ldw, 1, T(1), c, ldc);
+    }
+};
+
+/// T  WY-: T[j][j] = tau[j], T[0:j, j] = -tau[j] T[0:j, 0:j] (V^H V)[0:j, j]
+template<typename T>
+Matrix<T> qrFormT(const Reflectors<T>& r, const T* tau) {
+    const size_t k = r.count;
+    Matrix<T> gram(k, k, typename Matrix<T>::Uninitialized{});
+    r.adjointTimes(r.v.getData(), r.v.getStride(), k, gram.getData(), gram.getStride());
+    Matrix<T> t(k, k);
+    T* tp = t.getData();
+    const T* g = gram.getData();
+    const size_t ldt = t.getStride();
+    const size_t ldg = gram.getStride();
+    for (size_t j = 0; j < k; j++) {
+        tp[j * ldt + j] = tau[j];
+        for (size_t i = 0; i < j; i++) {
+            T s = T();
+            for (size_t l = i; l < j; l++) {
+                s += tp[i * ldt + l] * g[l * ldg + j];
+            }
+            tp[i * ldt + j] = -tau[j] * s;
+        }
+    }
+    return t;
+}
+
+/// C (r.rows x ncols) = (I - V T V^H)^H C  adjoint,  (I - V T V^H) C
+template<typename T>
+void qrApplyBlock(const Reflectors<T>& r, const Matrix<T>& t, bool adjoint, T* c, size_t ldc, size_t ncols) {
+    if (ncols == 0) {
+        return;
+    }
+    const size_t k = r.count;
+    Matrix<T> w(k, ncols, typename Matrix<T>::Uninitialized{});
+    r.adjointTimes(c, ldc, ncols, w.getData(), w.getStride());
+    Matrix<T> op(k, k, typename Matrix<T>::Uninitialized{});
+    for (size_t i = 0; i < k; i++) {
+        for (size_t j = 0; j < k; j++) {
+            op(i, j) = adjoint ? conjugate(t(j, i)) : t(i, j);
+        }
+    }
+    Matrix<T> tw(k, ncols, typename Matrix<T>::Uninitialized{});
+    gemm<T>(k, ncols, k, T(1), op.getData(), op.getStride(), 1, w.getData(), w.getStride(), 1, T(), tw.getData(), tw.getStride());
+    r.subtractTimes(tw.getData(), tw.getStride(), ncols, c, ldc);
+}
+
+///    m x n (m >= n)  
+template<typename T>
+void qrPanel(size_t m, size_t n, T* a, size_t ld, T* tau) {
+    if (n <= qrLeaf) {
+        qrUnblocked(m, n, a, ld, tau);
+        return;
+    }
+    const size_t n1 = n / 2;
+    qrPanel(m, n1, a, ld, tau);
+    const Reflectors<T> r(a, ld, m, n1);
+    qrApplyBlock(r, qrFormT(r, tau), true, a + n1, ld, n - n1);
+    qrPanel(m - n1, n - n1, a + n1 * ld + n1, ld, tau + n1);
+}
+
+///   m x n  ; blocks -  T   
+template<typename T>
+void qrFactor(size_t m, size_t n, T* a, size_t ld, T* tau, std::vector<Matrix<T>>& blocks) {
+    const size_t k = std::min(m, n);
+    for (size_t j = 0; j < k; j += qrBlock) {
+        const size_t jb = std::min(qrBlock, k - j);
+        T* panel = a + j * ld + j;
+        qrPanel(m - j, jb, panel, ld, tau + j);
+        const Reflectors<T> r(panel, ld, m - j, jb);
+        blocks.push_back(qrFormT(r, tau + j));
+        qrApplyBlock(r, blocks.back(), true, panel + jb, ld, n - j - jb);
+    }
+}
+
+///    TSQR  n  (  2n,        )
+template<typename T>
+size_t tsqrBlockRows(size_t n) {
+    return std::max(2 * n, tsqrBlockBytes / (std::max<size_t>(n, 1) * sizeof(T)));
+}
+
+///  R * X = Y[0:n]    R (n x n)  factors
+template<typename T>
+Matrix<T> upperSolve(const Matrix<T>& factors, size_t n, const Matrix<T>& y) {
+    for (size_t i = 0; i < n; i++) {
+        if (factors(i, i) == T()) {
+            throw std::invalid_argument("   ,   ");
+        }
+    }
+    Matrix<T> x(n, y.getCols(), typename Matrix<T>::Uninitialized{});
+    for (size_t i = 0; i < n; i++) {
+        std::copy_n(y.getData() + i * y.getStride(), y.getCols(), x.getData() + i * x.getStride());
+    }
+    trsmUpper(n, x.getCols(), factors.getData(), factors.getStride(), x.getData(), x.getStride());
+    return x;
+}
+
+} // namespace detail
+
+
+///  A = Q * R  m x n   (,  WY)
+template<typename T>
+class QRDecomposition {
+    static_assert(std::is_floating_point_v<T> || is_complex<T>::value, "QR-      ");
+
+private:
+    Matrix<T> factors;
+    std::vector<T> tau;
+    std::vector<Matrix<T>> blocks;
+
+    void factorize() {
+        tau.assign(std::min(factors.getRows(), factors.getCols()), T());
+        detail::qrFactor(factors.getRows(), factors.getCols(), factors.getData(), factors.getStride(), tau.data(), blocks);
+    }
+
+    void apply(Matrix<T>& b, bool adjoint) const {
+        if (b.getRows() != factors.getRows()) {
+            throw std::invalid_argument("         ");
+        }
+        const size_t m = factors.getRows();
+        const size_t ld = factors.getStride();
+        for (size_t step = 0; step < blocks.size(); step++) {
+            const size_t bi = adjoint ? step : blocks.size() - 1 - step;
+            const size_t j = bi * detail::qrBlock;
+            const detail::Reflectors<T> r(factors.getData() + j * ld + j, ld, m - j, blocks[bi].getRows());
+            detail::qrApplyBlock(r, blocks[bi], adjoint, b.getData() + j * b.getStride(), b.getStride(), b.getCols());
+        }
+    }
+
+public:
+    explicit QRDecomposition(const Matrix<T>& matrix) : factors(matrix) {
+        factorize();
+    }
+
+    ///     ,  
+    explicit QRDecomposition(Matrix<T>&& matrix) : factors(std::move(matrix)) {
+        factorize();
+    }
+
+    ///     (m >= n    R  )
+    bool isFullRank() const {
+        if (factors.getRows() < factors.getCols()) {
+            return false;
+        }
+        for (size_t i = 0; i < factors.getCols(); i++) {
+            if (factors(i, i) == T()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /// B = Q^H * B (B - m )
+    void applyQH(Matrix<T>& b) const {
+        apply(b, true);
+    }
+
+    /// B = Q * B (B - m )
+    void applyQ(Matrix<T>& b) const {
+        apply(b, false);
+    }
+
+    ///    : X,  ||A * X - B||    (m >= n)
+    Matrix<T> solve(const Matrix<T>& b) const {
+        if (factors.getRows() < factors.getCols()) {
+            throw std::invalid_argument("         ,  ");
+        }
+        Matrix<T> y(b);
+        applyQH(y);
+        return detail::upperSolve(factors, factors.getCols(), y);
+    }
+
+    /// R: min(m, n) x n,  
+    Matrix<T> getR() const {
+        const size_t k = std::min(factors.getRows(), factors.getCols());
+        Matrix<T> r(k, factors.getCols());
+        for (size_t i = 0; i < k; i++) {
+            std::copy(factors.getData() + i * factors.getStride() + i, factors.getData() + i * factors.getStride() + factors.getCols(),
+                r.getData() + i * r.getStride() + i);
+        }
+        return r;
+    }
+
+    /// Q: m x min(m, n)    ( )
+    Matrix<T> getQ() const {
+        const size_t k = std::min(factors.getRows(), factors.getCols());
+        Matrix<T> q(factors.getRows(), k);
+        for (size_t i = 0; i < k; i++) {
+            q(i, i) = T(1);
+        }
+        applyQ(q);
+        return q;
+    }
+
+    ///     R    
+    const Matrix<T>& getFactors() const {
+        return factors;
+    }
+
+    const std::vector<T>& getTau() const {
+        return tau;
+    }
+};
+
+
+/// QR-    (TSQR).      ,
+///   ,  R (n x n)   ,  
+///  ,     .       ,
+///       .
+template<typename T>
+class TallSkinnyQR {
+private:
+    struct Level {
+        ///          
+        std::vector<size_t> offsets;
+        std::vector<std::unique_ptr<QRDecomposition<T>>> blocks;
+    };
+
+    size_t cols;
+    std::vector<Level> levels;
+
+    static std::vector<size_t> splitRows(size_t rows, size_t cols) {
+        const size_t count = std::max<size_t>(1, rows / detail::tsqrBlockRows<T>(cols));
+        std::vector<size_t> offsets(count + 1);
+        for (size_t i = 0; i <= count; i++) {
+            offsets[i] = rows * i / count;
+        }
+        return offsets;
+    }
+
+    static Matrix<T> copyRows(const Matrix<T>& src, size_t r0, size_t r1) {
+        Matrix<T> dst(r1 - r0, src.getCols(), typename Matrix<T>::Uninitialized{});
+        for (size_t i = r0; i < r1; i++) {
+            std::copy_n(src.getData() + i * src.getStride(), src.getCols(), dst.getData() + (i - r0) * dst.getStride());
+        }
+        return dst;
+    }
+
+public:
+    explicit TallSkinnyQR(const Matrix<T>& a) : cols(a.getCols()) {
+        if (a.getRows() < a.getCols()) {
+            throw std::invalid_argument(" TSQR     ,  ");
+        }
+        const Matrix<T>* source = &a;
+        Matrix<T> stacked(0, cols);
+        while (true) {
+            Level level;
+            level.offsets = splitRows(source->getRows(), cols);
+            const size_t count = level.offsets.size() - 1;
+            level.blocks.resize(count);
+            parallelFor(count, [&](size_t b) {
+                level.blocks[b] = std::make_unique<QRDecomposition<T>>(copyRows(*source, level.offsets[b], level.offsets[b + 1]));
+            });
+            levels.push_back(std::move(level));
+            if (count == 1) {
+                break;
+            }
+            //  R  (    n ,   R -  n x n)
+            Matrix<T> next(count * cols, cols);
+            for (size_t b = 0; b < count; b++) {
+                const Matrix<T>& f = levels.back().blocks[b]->getFactors();
+                for (size_t i = 0; i < cols; i++) {
+                    std::copy(f.getData() + i * f.getStride() + i, f.getData() + i * f.getStride() + cols,
+                        next.getData() + (b * cols + i) * next.getStride() + i);
+                }
+            }
+            stacked = std::move(next);
+            source = &stacked;
+        }
+    }
+
+    ///    
+    bool isFullRank() const {
+        return levels.back().blocks.front()->isFullRank();
+    }
+
+    /// R: n x n,  
+    Matrix<T> getR() const {
+        return levels.back().blocks.front()->getR();
+    }
+
+    ///    : Q^H   B  ,  R * X = (Q^H B)[0:n]
+    Matrix<T> solve(const Matrix<T>& b) const {
+        if (b.getRows() != levels.front().offsets.back()) {
+            throw std::invalid_argument("         ");
+        }
+        Matrix<T> current(b);
+        for (const Level& level : levels) {
+            const size_t count = level.blocks.size();
+            Matrix<T> next(count * cols, b.getCols(), typename Matrix<T>::Uninitialized{});
+            parallelFor(count, [&](size_t k) {
+                Matrix<T> piece = copyRows(current, level.offsets[k], level.offsets[k + 1]);
+                level.blocks[k]->applyQH(piece);
+                for (size_t i = 0; i < cols; i++) {
+                    std::copy_n(piece.getData() + i * piece.getStride(), b.getCols(), next.getData() + (k * cols + i) * next.getStride());
+                }
+            });
+            current = std::move(next);
+        }
+        return detail::upperSolve(levels.back().blocks.front()->getFactors(), cols, current);
+    }
+};
+
+
+///    A * X = B    (A - m x n, m >= n).
+///      TSQR,  -  QR
+template<typename T>
+Matrix<T> leastSquares(const Matrix<T>& a, const Matrix<T>& b) {
+    if (a.getRows() >= 2 * detail::tsqrBlockRows<T>(a.getCols())) {
+        return TallSkinnyQR<T>(a).solve(b);
+    }
+    return QRDecomposition<T>(a).solve(b);
+}
@@ -0,0 +1,351 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include "matrix.h"
+#include "cpu.h"
+#include "thread_pool.h"
+
+
+///   int8       : x = scale * q, q  [-127, 127].
+///   4   ,  Matrix<float>.  A * B   
+/// ( int8 * int8  int32),  C(i, j) = scaleA[i] * scaleB[j] *  -  
+///    ,  -  .
+///        :   16 ,  
+///   4    4   .    CPUID:
+///  AVX-512 VNNI - vpdpbusd (u8 * s8,    int32):   
+///    B,   128 ( xor  ),   128 * (  A)
+///    ;
+///  AVX2 - vpmaddubsw  |a|  b   a (|a| * b <= 127 * 127,   ),
+///    vpmaddwd  ;
+///   -   .
+
+///     
+enum class QuantAxis {
+    Rows,
+    Columns
+};
+
+namespace detail {
+
+///      (16  int32 -   AVX-512)
+inline constexpr size_t quantPanel = 16;
+
+///      ;      
+inline constexpr size_t quantTileRows = 8;
+
+///    
+inline constexpr size_t quantTaskRows = 128;
+
+///     (-128  :   |a|    int8)
+inline constexpr int quantLimit = 127;
+
+///   ,        int32
+inline constexpr size_t quantMaxDepth = size_t(std::numeric_limits<int32_t>::max()) / (quantLimit * quantLimit);
+
+///  ,     4
+inline size_t quantDepth(size_t k) {
+    return (k + 3) / 4 * 4;
+}
+
+///   
+enum class QuantLevel {
+    Generic,
+    Avx2,
+    Vnni
+};
+
+inline QuantLevel detectQuantLevel() {
+#if MATRIX_X86_DISPATCH
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") && __builtin_cpu_supports("avx512vnni")) {
+        return QuantLevel::Vnni;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return QuantLevel::Avx2;
+    }
+#endif
+    return QuantLevel::Generic;
+}
+
+inline QuantLevel quantLevel() {
+    static const QuantLevel level = detectQuantLevel();
+    return level;
+}
+
+///  quantTileRows x quantPanel :  a   lda,  b  kp ( 4),
+/// sums -   a.  -  out    quantPanel 
+template<QuantLevel L>
+struct QuantKernels {
+    static void tile(const int8_t* a, size_t lda, const int8_t* b, const int32_t*, size_t kp, int32_t* out) {
+        std::fill(out, out + quantTileRows * quantPanel, 0);
+        for (size_t k = 0; k < kp; k += 4) {
+            const int8_t* bk = b + k * quantPanel;
+            for (size_t r = 0; r < quantTileRows; r++) {
+                const int8_t* ak = a + r * lda + k;
+                int32_t* row = out + r * quantPanel;
+                for (size_t j = 0; j < quantPanel; j++) {
+                    const int8_t* bj = bk + j * 4;
+                    row[j] += ak[0] * bj[0] + ak[1] * bj[1] + ak[2] * bj[2] + ak[3] * bj[3];
+                }
+            }
+        }
+    }
+};
+
+#if MATRIX_X86_DISPATCH
+template<>
+struct QuantKernels<QuantLevel::Avx2> {
+    ///  4   : 8 ,        16 
+    MATRIX_TARGET("avx2")
+    static void tile(const int8_t* a, size_t lda, const int8_t* b, const int32_t*, size_t kp, int32_t* out) {
+        const __m256i ones = _mm256_set1_epi16(1);
+        for (size_t r0 = 0; r0 < quantTileRows; r0 += 4) {
+            __m256i acc[4][2];
+#pragma GCC unroll 16
+            for (size_t r = 0; r < 4; r++) {
+                acc[r][0] = _mm256_setzero_si256();
+                acc[r][1] = _mm256_setzero_si256();
+            }
+            for (size_t k = 0; k < kp; k += 4) {
+                const __m256i b0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + k * quantPanel));
+                const __m256i b1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + k * quantPanel + 32));
+#pragma GCC unroll 16
+                for (size_t r = 0; r < 4; r++) {
+                    int32_t word;
+                    std::memcpy(&word, a + (r0 + r) * lda + k, sizeof(word));
+                    const __m256i av = _mm256_set1_epi32(word);
+                    const __m256i abs = _mm256_abs_epi8(av);
+                    const __m256i p0 = _mm256_maddubs_epi16(abs, _mm256_sign_epi8(b0, av));
+                    const __m256i p1 = _mm256_maddubs_epi16(abs, _mm256_sign_epi8(b1, av));
+                    acc[r][0] = _mm256_add_epi32(acc[r][0], _mm256_madd_epi16(p0, ones));
+                    acc[r][1] = _mm256_add_epi32(acc[r][1], _mm256_madd_epi16(p1, ones));
+                }
+            }
+#pragma GCC unroll 16
+            for (size_t r = 0; r < 4; r++) {
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + (r0 + r) * quantPanel), acc[r][0]);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + (r0 + r) * quantPanel + 8), acc[r][1]);
+            }
+        }
+    }
+};
+
+template<>
+struct QuantKernels<QuantLevel::Vnni> {
+    MATRIX_TARGET("avx512f,avx512bw,avx512vnni")
+    static void tile(const int8_t* a, size_t lda, const int8_t* b, const int32_t* sums, size_t kp, int32_t* out) {
+        // a * (b + 128)     128 * sum(a):    
+        const __m512i flip = _mm512_set1_epi32(int32_t(0x80808080u));
+        __m512i acc[quantTileRows];
+#pragma GCC unroll 16
+        for (size_t r = 0; r < quantTileRows; r++) {
+            // -128 * sum   :  |sum| > 2^24     (UB),
+            //    2^32   ,      dpbusd
+            acc[r] = _mm512_set1_epi32(int32_t(uint32_t(sums[r]) * 0xFFFFFF80u));
+        }
+        for (size_t k = 0; k < kp; k += 4) {
+            const __m512i bk = _mm512_xor_si512(_mm512_loadu_si512(b + k * quantPanel), flip);
+#pragma GCC unroll 16
+            for (size_t r = 0; r < quantTileRows; r++) {
+                int32_t word;
+                std::memcpy(&word, a + r * lda + k, sizeof(word));
+                acc[r] = _mm512_dpbusd_epi32(acc[r], bk, _mm512_set1_epi32(word));
+            }
+        }
+#pragma GCC unroll 16
+        for (size_t r = 0; r < quantTileRows; r++) {
+            _mm512_storeu_si512(out + r * quantPanel, acc[r]);
+        }
+    }
+};
+#endif
+
+///  f    
+template<typename F>
+decltype(auto) withQuantKernels(F&& f) {
+    switch (quantLevel()) {
+#if MATRIX_X86_DISPATCH
+    case QuantLevel::Vnni:
+        return f(QuantKernels<QuantLevel::Vnni>());
+    case QuantLevel::Avx2:
+        return f(QuantKernels<QuantLevel::Avx2>());
+#endif
+    default:
+        return f(QuantKernels<QuantLevel::Generic>());
+    }
+}
+
+///  x    inv
+inline int8_t quantize(float x, float inv) {
+    const long q = std::lrint(x * inv);
+    return int8_t(std::clamp<long>(q, -quantLimit, quantLimit));
+}
+
+} // namespace detail
+
+
+///  int8     (QuantAxis::Rows)    (QuantAxis::Columns)
+class QuantizedMatrix {
+private:
+    size_t rows;
+    size_t cols;
+    QuantAxis axis;
+    ///    ( )    ( )
+    size_t depth;
+    std::vector<int8_t> data;
+    std::vector<float> scales;
+    ///   (  ,  ) -    VNNI
+    std::vector<int32_t> sums;
+
+    size_t index(size_t i, size_t j) const {
+        if (axis == QuantAxis::Rows) {
+            return i * depth + j;
+        }
+        return (j / detail::quantPanel) * depth * detail::quantPanel + (i / 4) * 4 * detail::quantPanel + (j % detail::quantPanel) * 4 + i % 4;
+    }
+
+public:
+    /// :   () - max |x| / 127,    
+    explicit QuantizedMatrix(const Matrix<float>& matrix, QuantAxis axis = QuantAxis::Rows)
+        : rows(matrix.getRows()), cols(matrix.getCols()), axis(axis) {
+        std::vector<float> maxima(axis == QuantAxis::Rows ? rows : cols, 0.0f);
+        for (size_t i = 0; i < rows; i++) {
+            const float* row = matrix.getData() + i * matrix.getStride();
+            for (size_t j = 0; j < cols; j++) {
+                float& m = maxima[axis == QuantAxis::Rows ? i : j];
+                m = std::max(m, std::abs(row[j]));
+            }
+        }
+        scales.resize(maxima.size());
+        std::vector<float> inverse(maxima.size());
+        for (size_t s = 0; s < maxima.size(); s++) {
+            scales[s] = maxima[s] / detail::quantLimit;
+            inverse[s] = maxima[s] > 0 ? detail::quantLimit / maxima[s] : 0.0f;
+        }
+
+        if (axis == QuantAxis::Rows) {
+            //      4      quantTileRows  
+            depth = detail::quantDepth(cols);
+            const size_t paddedRows = (rows + detail::quantTileRows - 1) / detail::quantTileRows * detail::quantTileRows;
+            data.assign(paddedRows * depth, 0);
+            sums.assign(paddedRows, 0);
+            for (size_t i = 0; i < rows; i++) {
+                const float* row = matrix.getData() + i * matrix.getStride();
+                for (size_t j = 0; j < cols; j++) {
+                    const int8_t q = detail::quantize(row[j], inverse[i]);
+                    data[i * depth + j] = q;
+                    sums[i] += q;
+                }
+            }
+            return;
+        }
+        depth = detail::quantDepth(rows);
+        const size_t panels = (cols + detail::quantPanel - 1) / detail::quantPanel;
+        data.assign(panels * depth * detail::quantPanel, 0);
+        for (size_t i = 0; i < rows; i++) {
+            const float* row = matrix.getData() + i * matrix.getStride();
+            for (size_t j = 0; j < cols; j++) {
+                data[index(i, j)] = detail::quantize(row[j], inverse[j]);
+            }
+        }
+    }
+
+    /// : x = scale * q
+    Matrix<float> toMatrix() const {
+        Matrix<float> result(rows, cols, Matrix<float>::Uninitialized{});
+        for (size_t i = 0; i < rows; i++) {
+            float* row = result.getData() + i * result.getStride();
+            for (size_t j = 0; j < cols; j++) {
+                row[j] = scales[axis == QuantAxis::Rows ? i : j] * data[index(i, j)];
+            }
+        }
+        return result;
+    }
+
+    ///   (i, j)
+    int8_t operator()(size_t i, size_t j) const {
+        if (i >= rows || j >= cols) {
+            throw std::out_of_range("  ");
+        }
+        return data[index(i, j)];
+    }
+
+    size_t getRows() const {
+        return rows;
+    }
+
+    size_t getCols() const {
+        return cols;
+    }
+
+    QuantAxis getAxis() const {
+        return axis;
+    }
+
+    ///    
+    const std::vector<float>& getScales() const {
+        return scales;
+    }
+
+    /// C = A * B      float: A -  , B -  
+    friend Matrix<float> operator*(const QuantizedMatrix& a, const QuantizedMatrix& b) {
+        if (a.cols != b.rows) {
+            throw std::invalid_argument("        ");
+        }
+        if (a.axis != QuantAxis::Rows || b.axis != QuantAxis::Columns) {
+            throw std::invalid_argument("      ,  -  ");
+        }
+        if (a.cols > detail::quantMaxDepth) {
+            throw std::length_error("   ");
+        }
+        const size_t m = a.rows;
+        const size_t n = b.cols;
+        const size_t kp = a.depth;
+        Matrix<float> c(m, n, Matrix<float>::Uninitialized{});
+        const size_t panels = (n + detail::quantPanel - 1) / detail::quantPanel;
+        const size_t tasks = (m + detail::quantTaskRows - 1) / detail::quantTaskRows;
+        detail::withQuantKernels([&](auto kernels) {
+            parallelFor(tasks, [&](size_t t) {
+                const size_t r0 = t * detail::quantTaskRows;
+                const size_t r1 = std::min(m, r0 + detail::quantTaskRows);
+                int32_t tile[detail::quantTileRows * detail::quantPanel];
+                for (size_t p = 0; p < panels; p++) {
+                    const size_t j0 = p * detail::quantPanel;
+                    const size_t width = std::min(detail::quantPanel, n - j0);
+                    const int8_t* panel = b.data.data() + p * kp * detail::quantPanel;
+                    const float* scaleB = b.scales.data() + j0;
+                    for (size_t i0 = r0; i0 < r1; i0 += detail::quantTileRows) {
+                        kernels.tile(a.data.data() + i0 * kp, kp, panel, a.sums.data() + i0, kp, tile);
+                        const size_t height = std::min(detail::quantTileRows, r1 - i0);
+                        for (size_t r = 0; r < height; r++) {
+                            float* out = c.getData() + (i0 + r) * c.getStride() + j0;
+                            const float scaleA = a.scales[i0 + r];
+                            for (size_t j = 0; j < width; j++) {
+                                out[j] = scaleA * scaleB[j] * float(tile[r * detail::quantPanel + j]);
+                            }
+                        }
+                    }
+                }
+            });
+        });
+        return c;
+    }
+
+    /// A * B   A     (B -   )
+    friend Matrix<float> operator*(const Matrix<float>& a, const QuantizedMatrix& b) {
+        return QuantizedMatrix(a, QuantAxis::Rows) * b;
+    }
+
+    friend std::ostream& operator<<(std::ostream& os, const QuantizedMatrix& matrix) {
+        return os << matrix.toMatrix();
+    }
+};
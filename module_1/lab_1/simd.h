@@ -0,0 +1,327 @@
+#pragma once
+
+#include <cstddef>
+#include <complex>
+#include <type_traits>
+
+#include "cpu.h"
+
+
+///     : c = a + b, c = a - b, c = a * s, c = a / s.
+///  float, double  std::complex<double>   SSE2/AVX2/AVX-512  CPUID,
+///    -  .       (  ).
+
+namespace detail {
+
+struct AddOp {
+    template<typename Ops, typename V>
+    static void vec(V& r, const V& a, const V& b) { Ops::add(r, a, b); }
+    template<typename R>
+    static R scalar(R a, R b) { return a + b; }
+};
+
+struct SubOp {
+    template<typename Ops, typename V>
+    static void vec(V& r, const V& a, const V& b) { Ops::sub(r, a, b); }
+    template<typename R>
+    static R scalar(R a, R b) { return a - b; }
+};
+
+struct MulOp {
+    template<typename Ops, typename V>
+    static void vec(V& r, const V& a, const V& b) { Ops::mul(r, a, b); }
+    template<typename R>
+    static R scalar(R a, R b) { return a * b; }
+};
+
+struct DivOp {
+    template<typename Ops, typename V>
+    static void vec(V& r, const V& a, const V& b) { Ops::div(r, a, b); }
+    template<typename R>
+    static R scalar(R a, R b) { return a / b; }
+};
+
+///  :      
+template<typename Op, typename T>
+inline void scalarBinary(const T* a, const T* b, T* c, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        c[i] = Op::scalar(a[i], b[i]);
+    }
+}
+
+template<typename Op, typename T>
+inline void scalarWithScalar(const T* a, T s, T* c, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        c[i] = Op::scalar(a[i], s);
+    }
+}
+
+#if MATRIX_X86_DISPATCH
+/// c[i] = a[i] op b[i],     
+template<typename R, SimdLevel L, typename Op>
+inline void simdBinary(const R* a, const R* b, R* c, size_t n) {
+    using Ops = SimdOps<R, L>;
+    using V = typename Ops::V;
+    constexpr size_t W = Ops::W;
+    size_t i = 0;
+    for (; i + 2 * W <= n; i += 2 * W) {
+        V x0, x1, y0, y1;
+        Ops::load(x0, a + i);
+        Ops::load(x1, a + i + W);
+        Ops::load(y0, b + i);
+        Ops::load(y1, b + i + W);
+        Op::template vec<Ops>(x0, x0, y0);
+        Op::template vec<Ops>(x1, x1, y1);
+        Ops::store(c + i, x0);
+        Ops::store(c + i + W, x1);
+    }
+    for (; i + W <= n; i += W) {
+        V x, y;
+        Ops::load(x, a + i);
+        Ops::load(y, b + i);
+        Op::template vec<Ops>(x, x, y);
+        Ops::store(c + i, x);
+    }
+    scalarBinary<Op>(a + i, b + i, c + i, n - i);
+}
+
+/// c[i] = a[i] op s   
+template<typename R, SimdLevel L, typename Op>
+inline void simdWithScalar(const R* a, R s, R* c, size_t n) {
+    using Ops = SimdOps<R, L>;
+    using V = typename Ops::V;
+    constexpr size_t W = Ops::W;
+    V sv;
+    Ops::broadcast(sv, s);
+    size_t i = 0;
+    for (; i + 2 * W <= n; i += 2 * W) {
+        V x0, x1;
+        Ops::load(x0, a + i);
+        Ops::load(x1, a + i + W);
+        Op::template vec<Ops>(x0, x0, sv);
+        Op::template vec<Ops>(x1, x1, sv);
+        Ops::store(c + i, x0);
+        Ops::store(c + i + W, x1);
+    }
+    for (; i + W <= n; i += W) {
+        V x;
+        Ops::load(x, a + i);
+        Op::template vec<Ops>(x, x, sv);
+        Ops::store(c + i, x);
+    }
+    scalarWithScalar<Op>(a + i, s, c + i, n - i);
+}
+
+///    (re, im)   :
+/// (re, im) * (sr, si) = (re * sr - im * si, im * sr + re * si)
+template<SimdLevel L>
+inline void simdComplexScale(const double* a, std::complex<double> s, double* c, size_t n) {
+    using Ops = SimdOps<double, L>;
+    using V = typename Ops::V;
+    constexpr size_t W = Ops::W;
+    V sr, si;
+    Ops::broadcast(sr, s.real());
+    Ops::broadcast(si, s.imag());
+    size_t i = 0;
+    for (; i + W <= 2 * n; i += W) {
+        V x, swapped, cross;
+        Ops::load(x, a + i);
+        Ops::swapPairs(swapped, x);
+        Ops::mul(cross, swapped, si);
+        Ops::fmaddsub(x, x, sr, cross);
+        Ops::store(c + i, x);
+    }
+    for (; i < 2 * n; i += 2) {
+        const double re = a[i];
+        const double im = a[i + 1];
+        c[i] = re * s.real() - im * s.imag();
+        c[i + 1] = im * s.real() + re * s.imag();
+    }
+}
+#endif
+
+///      R   L
+template<typename R, SimdLevel L>
+struct ElementwiseKernels {
+    template<typename Op>
+    static void binary(const R* a, const R* b, R* c, size_t n) {
+#if MATRIX_X86_DISPATCH && defined(__SSE2__)
+        simdBinary<R, SimdLevel::Generic, Op>(a, b, c, n);
+#else
+        scalarBinary<Op>(a, b, c, n);
+#endif
+    }
+
+    template<typename Op>
+    static void withScalar(const R* a, R s, R* c, size_t n) {
+#if MATRIX_X86_DISPATCH && defined(__SSE2__)
+        simdWithScalar<R, SimdLevel::Generic, Op>(a, s, c, n);
+#else
+        scalarWithScalar<Op>(a, s, c, n);
+#endif
+    }
+
+    static void complexScale(const R* a, std::complex<R> s, R* c, size_t n) {
+#if MATRIX_X86_DISPATCH && defined(__SSE2__)
+        if constexpr (std::is_same_v<R, double>) {
+            simdComplexScale<SimdLevel::Generic>(a, s, c, n);
+            return;
+        }
+#endif
+        scalarWithScalar<MulOp>(reinterpret_cast<const std::complex<R>*>(a), s, reinterpret_cast<std::complex<R>*>(c), n);
+    }
+};
+
+#if MATRIX_X86_DISPATCH
+template<typename R>
+struct ElementwiseKernels<R, SimdLevel::Avx2> {
+    template<typename Op>
+    MATRIX_TARGET("avx2,fma") MATRIX_FLATTEN
+    static void binary(const R* a, const R* b, R* c, size_t n) {
+        simdBinary<R, SimdLevel::Avx2, Op>(a, b, c, n);
+    }
+
+    template<typename Op>
+    MATRIX_TARGET("avx2,fma") MATRIX_FLATTEN
+    static void withScalar(const R* a, R s, R* c, size_t n) {
+        simdWithScalar<R, SimdLevel::Avx2, Op>(a, s, c, n);
+    }
+
+    MATRIX_TARGET("avx2,fma") MATRIX_FLATTEN
+    static void complexScale(const R* a, std::complex<R> s, R* c, size_t n) {
+        simdComplexScale<SimdLevel::Avx2>(a, s, c, n);
+    }
+};
+
+template<typename R>
+struct ElementwiseKernels<R, SimdLevel::Avx512> {
+    template<typename Op>
+    MATRIX_TARGET("avx512f") MATRIX_FLATTEN
+    static void binary(const R* a, const R* b, R* c, size_t n) {
+        simdBinary<R, SimdLevel::Avx512, Op>(a, b, c, n);
+    }
+
+    template<typename Op>
+    MATRIX_TARGET("avx512f") MATRIX_FLATTEN
+    static void withScalar(const R* a, R s, R* c, size_t n) {
+        simdWithScalar<R, SimdLevel::Avx512, Op>(a, s, c, n);
+    }
+
+    MATRIX_TARGET("avx512f") MATRIX_FLATTEN
+    static void complexScale(const R* a, std::complex<R> s, R* c, size_t n) {
+        simdComplexScale<SimdLevel::Avx512>(a, s, c, n);
+    }
+};
+#endif
+
+///  ,       T (void -  )
+template<typename T>
+struct SimdScalar {
+    using type = void;
+};
+
+template<> struct SimdScalar<float> { using type = float; };
+template<> struct SimdScalar<double> { using type = double; };
+template<> struct SimdScalar<std::complex<double>> { using type = double; };
+
+template<typename R, typename Op>
+void dispatchBinary(const R* a, const R* b, R* c, size_t n) {
+    switch (simdLevel()) {
+    case SimdLevel::Avx512:
+        ElementwiseKernels<R, SimdLevel::Avx512>::template binary<Op>(a, b, c, n);
+        return;
+    case SimdLevel::Avx2:
+        ElementwiseKernels<R, SimdLevel::Avx2>::template binary<Op>(a, b, c, n);
+        return;
+    default:
+        ElementwiseKernels<R, SimdLevel::Generic>::template binary<Op>(a, b, c, n);
+        return;
+    }
+}
+
+template<typename R, typename Op>
+void dispatchWithScalar(const R* a, R s, R* c, size_t n) {
+    switch (simdLevel()) {
+    case SimdLevel::Avx512:
+        ElementwiseKernels<R, SimdLevel::Avx512>::template withScalar<Op>(a, s, c, n);
+        return;
+    case SimdLevel::Avx2:
+        ElementwiseKernels<R, SimdLevel::Avx2>::template withScalar<Op>(a, s, c, n);
+        return;
+    default:
+        ElementwiseKernels<R, SimdLevel::Generic>::template withScalar<Op>(a, s, c, n);
+        return;
+    }
+}
+
+inline void dispatchComplexScale(const double* a, std::complex<double> s, double* c, size_t n) {
+    switch (simdLevel()) {
+    case SimdLevel::Avx512:
+        ElementwiseKernels<double, SimdLevel::Avx512>::complexScale(a, s, c, n);
+        return;
+    case SimdLevel::Avx2:
+        ElementwiseKernels<double, SimdLevel::Avx2>::complexScale(a, s, c, n);
+        return;
+    default:
+        ElementwiseKernels<double, SimdLevel::Generic>::complexScale(a, s, c, n);
+        return;
+    }
+}
+
+template<typename Op, typename T>
+void elementwise(const T* a, const T* b, T* c, size_t n) {
+    using R = typename SimdScalar<T>::type;
+    if constexpr (std::is_void_v<R>) {
+        scalarBinary<Op>(a, b, c, n);
+    }
+    else {
+        //         re  im 
+        constexpr size_t parts = sizeof(T) / sizeof(R);
+        dispatchBinary<R, Op>(reinterpret_cast<const R*>(a), reinterpret_cast<const R*>(b), reinterpret_cast<R*>(c), n * parts);
+    }
+}
+
+} // namespace detail
+
+
+/// c = a + b (n )
+template<typename T>
+void simdAdd(const T* a, const T* b, T* c, size_t n) {
+    detail::elementwise<detail::AddOp>(a, b, c, n);
+}
+
+/// c = a - b (n )
+template<typename T>
+void simdSub(const T* a, const T* b, T* c, size_t n) {
+    detail::elementwise<detail::SubOp>(a, b, c, n);
+}
+
+/// c = a * s (n )
+template<typename T>
+void simdScale(const T* a, T s, T* c, size_t n) {
+    using R = typename detail::SimdScalar<T>::type;
+    if constexpr (std::is_void_v<R>) {
+        detail::scalarWithScalar<detail::MulOp>(a, s, c, n);
+    }
+    else if constexpr (std::is_same_v<T, std::complex<double>>) {
+        detail::dispatchComplexScale(reinterpret_cast<const double*>(a), s, reinterpret_cast<double*>(c), n);
+    }
+    else {
+        detail::dispatchWithScalar<R, detail::MulOp>(a, s, c, n);
+    }
+}
+
+/// c = a / s (n );      1 / s
+template<typename T>
+void simdDivide(const T* a, T s, T* c, size_t n) {
+    using R = typename detail::SimdScalar<T>::type;
+    if constexpr (std::is_void_v<R>) {
+        detail::scalarWithScalar<detail::DivOp>(a, s, c, n);
+    }
+    else if constexpr (std::is_same_v<T, std::complex<double>>) {
+        simdScale(a, T(1) / s, c, n);
+    }
+    else {
+        detail::dispatchWithScalar<R, detail::DivOp>(a, s, c, n);
+    }
+}
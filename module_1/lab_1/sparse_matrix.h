@@ -0,0 +1,637 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "matrix.h"
+#include "simd.h"
+#include "thread_pool.h"
+
+
+///     : CSR ( )  CSC ( ).
+///    : offsets[o]..offsets[o + 1] -  
+/// / o   indices (   )  values.
+///       ,   rows * cols.
+
+///    
+enum class SparseLayout {
+    Row,    // CSR:  - 
+    Column  // CSC:  - 
+};
+
+///        (row, col, value)
+template<typename T>
+struct SparseEntry {
+    size_t row;
+    size_t col;
+    T value;
+};
+
+namespace detail {
+
+///   ,      
+inline constexpr size_t sparseParallelNonZeros = 1 << 15;
+
+///           
+inline std::vector<size_t> sparseChunks(const std::vector<size_t>& offsets, size_t parts) {
+    const size_t outer = offsets.size() - 1;
+    const size_t nnz = offsets.back();
+    parts = std::max<size_t>(1, std::min(parts, outer));
+    std::vector<size_t> bounds(1, 0);
+    for (size_t p = 1; p < parts; p++) {
+        const size_t target = nnz / parts * p;
+        const size_t o = size_t(std::lower_bound(offsets.begin(), offsets.end(), target) - offsets.begin());
+        if (o > bounds.back() && o < outer) {
+            bounds.push_back(o);
+        }
+    }
+    bounds.push_back(outer);
+    return bounds;
+}
+
+///        CSC-    
+inline constexpr size_t sparseScatterRatio = 2;
+
+inline size_t sparseParts(size_t nnz) {
+    return nnz < sparseParallelNonZeros ? 1 : threadCount() * 4;
+}
+
+/// C(i, j0:j1) += a(i, k) * B(k, j0:j1)    [o0, o1)   CSR
+template<typename T, typename Index>
+inline void spmmRows(const size_t* offsets, const Index* indices, const T* values, size_t o0, size_t o1,
+    const T* b, size_t ldb, T* c, size_t ldc, size_t j0, size_t j1) {
+    for (size_t i = o0; i < o1; i++) {
+        T* __restrict dst = c + i * ldc;
+        for (size_t p = offsets[i]; p < offsets[i + 1]; p++) {
+            const T a = values[p];
+            const T* __restrict src = b + size_t(indices[p]) * ldb;
+            for (size_t j = j0; j < j1; j++) {
+                dst[j] += a * src[j];
+            }
+        }
+    }
+}
+
+/// C(i, j0:j1) += a(i, k) * B(k, j0:j1)    [o0, o1)   CSC
+template<typename T, typename Index>
+inline void spmmColumns(const size_t* offsets, const Index* indices, const T* values, size_t o0, size_t o1,
+    const T* b, size_t ldb, T* c, size_t ldc, size_t j0, size_t j1) {
+    for (size_t k = o0; k < o1; k++) {
+        const T* __restrict src = b + k * ldb;
+        for (size_t p = offsets[k]; p < offsets[k + 1]; p++) {
+            const T a = values[p];
+            T* __restrict dst = c + size_t(indices[p]) * ldc;
+            for (size_t j = j0; j < j1; j++) {
+                dst[j] += a * src[j];
+            }
+        }
+    }
+}
+
+template<typename T, typename Index, SimdLevel L>
+struct SpmmKernels {
+    static void rows(const size_t* offsets, const Index* indices, const T* values, size_t o0, size_t o1,
+        const T* b, size_t ldb, T* c, size_t ldc, size_t j0, size_t j1) {
+        spmmRows(offsets, indices, values, o0, o1, b, ldb, c, ldc, j0, j1);
+    }
+
+    static void columns(const size_t* offsets, const Index* indices, const T* values, size_t o0, size_t o1,
+        const T* b, size_t ldb, T* c, size_t ldc, size_t j0, size_t j1) {
+        spmmColumns(offsets, indices, values, o0, o1, b, ldb, c, ldc, j0, j1);
+    }
+};
+
+#if MATRIX_X86_DISPATCH
+template<typename T, typename Index>
+struct SpmmKernels<T, Index, SimdLevel::Avx2> {
+    MATRIX_TARGET("avx2,fma") MATRIX_FLATTEN
+    static void rows(const size_t* offsets, const Index* indices, const T* values, size_t o0, size_t o1,
+        const T* b, size_t ldb, T* c, size_t ldc, size_t j0, size_t j1) {
+        spmmRows(offsets, indices, values, o0, o1, b, ldb, c, ldc, j0, j1);
+    }
+
+    MATRIX_TARGET("avx2,fma") MATRIX_FLATTEN
+    static void columns(const size_t* offsets, const Index* indices, const T* values, size_t o0, size_t o1,
+        const T* b, size_t ldb, T* c, size_t ldc, size_t j0, size_t j1) {
+        spmmColumns(offsets, indices, values, o0, o1, b, ldb, c, ldc, j0, j1);
+    }
+};
+
+template<typename T, typename Index>
+struct SpmmKernels<T, Index, SimdLevel::Avx512> {
+    MATRIX_TARGET("avx512f") MATRIX_FLATTEN
+    static void rows(const size_t* offsets, const Index* indices, const T* values, size_t o0, size_t o1,
+        const T* b, size_t ldb, T* c, size_t ldc, size_t j0, size_t j1) {
+        spmmRows(offsets, indices, values, o0, o1, b, ldb, c, ldc, j0, j1);
+    }
+
+    MATRIX_TARGET("avx512f") MATRIX_FLATTEN
+    static void columns(const size_t* offsets, const Index* indices, const T* values, size_t o0, size_t o1,
+        const T* b, size_t ldb, T* c, size_t ldc, size_t j0, size_t j1) {
+        spmmColumns(offsets, indices, values, o0, o1, b, ldb, c, ldc, j0, j1);
+    }
+};
+#endif
+
+template<typename T, typename Index, bool ByRows>
+void spmmDispatch(const size_t* offsets, const Index* indices, const T* values, size_t o0, size_t o1,
+    const T* b, size_t ldb, T* c, size_t ldc, size_t j0, size_t j1) {
+    switch (simdLevel()) {
+    case SimdLevel::Avx512:
+        if constexpr (ByRows) {
+            SpmmKernels<T, Index, SimdLevel::Avx512>::rows(offsets, indices, values, o0, o1, b, ldb, c, ldc, j0, j1);
+        }
+        else {
+            SpmmKernels<T, Index, SimdLevel::Avx512>::columns(offsets, indices, values, o0, o1, b, ldb, c, ldc, j0, j1);
+        }
+        return;
+    case SimdLevel::Avx2:
+        if constexpr (ByRows) {
+            SpmmKernels<T, Index, SimdLevel::Avx2>::rows(offsets, indices, values, o0, o1, b, ldb, c, ldc, j0, j1);
+        }
+        else {
+            SpmmKernels<T, Index, SimdLevel::Avx2>::columns(offsets, indices, values, o0, o1, b, ldb, c, ldc, j0, j1);
+        }
+        return;
+    default:
+        if constexpr (ByRows) {
+            SpmmKernels<T, Index, SimdLevel::Generic>::rows(offsets, indices, values, o0, o1, b, ldb, c, ldc, j0, j1);
+        }
+        else {
+            SpmmKernels<T, Index, SimdLevel::Generic>::columns(offsets, indices, values, o0, o1, b, ldb, c, ldc, j0, j1);
+        }
+        return;
+    }
+}
+
+} // namespace detail
+
+
+template<typename T, SparseLayout L = SparseLayout::Row>
+class SparseMatrix {
+    template<typename, SparseLayout>
+    friend class SparseMatrix;
+
+public:
+    using value_type = T;
+    ///   32-:       
+    using Index = uint32_t;
+    static constexpr SparseLayout layout = L;
+
+private:
+    size_t rows;
+    size_t cols;
+    std::vector<size_t> offsets;
+    std::vector<Index> indices;
+    std::vector<T> values;
+
+    static void checkSize(size_t rows, size_t cols) {
+        if (std::max(rows, cols) > std::numeric_limits<Index>::max()) {
+            throw std::length_error("   ");
+        }
+    }
+
+    size_t outerSize() const {
+        return L == SparseLayout::Row ? rows : cols;
+    }
+
+    size_t innerSize() const {
+        return L == SparseLayout::Row ? cols : rows;
+    }
+
+    ///     :  Op(a, b)   
+    template<typename Op>
+    SparseMatrix merge(const SparseMatrix& other) const {
+        if (rows != other.rows || cols != other.cols) {
+            throw std::invalid_argument("      ");
+        }
+        const size_t outer = outerSize();
+        SparseMatrix result(rows, cols);
+        const std::vector<size_t> bounds = detail::sparseChunks(offsets, detail::sparseParts(nonZeros() + other.nonZeros()));
+
+        auto mergeOuter = [&](size_t o, auto&& emit) {
+            size_t p = offsets[o];
+            size_t q = other.offsets[o];
+            const size_t pEnd = offsets[o + 1];
+            const size_t qEnd = other.offsets[o + 1];
+            while (p < pEnd || q < qEnd) {
+                T value;
+                Index index;
+                if (q == qEnd || (p < pEnd && indices[p] < other.indices[q])) {
+                    index = indices[p];
+                    value = Op::scalar(values[p++], T());
+                }
+                else if (p == pEnd || other.indices[q] < indices[p]) {
+                    index = other.indices[q];
+                    value = Op::scalar(T(), other.values[q++]);
+                }
+                else {
+                    index = indices[p];
+                    value = Op::scalar(values[p++], other.values[q++]);
+                }
+                if (value != T()) {
+                    emit(index, value);
+                }
+            }
+        };
+
+        //  1:       
+        parallelFor(bounds.size() - 1, [&](size_t t) {
+            for (size_t o = bounds[t]; o < bounds[t + 1]; o++) {
+                size_t count = 0;
+                mergeOuter(o, [&](Index, const T&) { count++; });
+                result.offsets[o + 1] = count;
+            }
+        });
+        for (size_t o = 0; o < outer; o++) {
+            result.offsets[o + 1] += result.offsets[o];
+        }
+
+        //  2: 
+        result.indices.resize(result.offsets[outer]);
+        result.values.resize(result.offsets[outer]);
+        parallelFor(bounds.size() - 1, [&](size_t t) {
+            for (size_t o = bounds[t]; o < bounds[t + 1]; o++) {
+                size_t pos = result.offsets[o];
+                mergeOuter(o, [&](Index index, const T& value) {
+                    result.indices[pos] = index;
+                    result.values[pos] = value;
+                    pos++;
+                });
+            }
+        });
+        return result;
+    }
+
+public:
+    ///   rows x cols (  )
+    SparseMatrix(size_t rows = 0, size_t cols = 0) : rows(rows), cols(cols) {
+        checkSize(rows, cols);
+        offsets.assign(outerSize() + 1, 0);
+    }
+
+    ///      ()
+    SparseMatrix(size_t rows, size_t cols, std::vector<size_t> offsets, std::vector<Index> indices, std::vector<T> values)
+        : rows(rows), cols(cols), offsets(std::move(offsets)), indices(std::move(indices)), values(std::move(values)) {
+        checkSize(rows, cols);
+        const size_t outer = outerSize();
+        if (this->offsets.size() != outer + 1 || this->offsets[0] != 0 || this->indices.size() != this->values.size()
+            || this->offsets[outer] != this->indices.size()) {
+            throw std::invalid_argument("    ");
+        }
+        for (size_t o = 0; o < outer; o++) {
+            if (this->offsets[o] > this->offsets[o + 1]) {
+                throw std::invalid_argument("    ");
+            }
+            for (size_t p = this->offsets[o]; p < this->offsets[o + 1]; p++) {
+                if (this->indices[p] >= innerSize() || (p > this->offsets[o] && this->indices[p - 1] >= this->indices[p])) {
+                    throw std::invalid_argument("         ");
+                }
+            }
+        }
+    }
+
+    ///   (row, col, value);   
+    SparseMatrix(size_t rows, size_t cols, const std::vector<SparseEntry<T>>& entries) : SparseMatrix(rows, cols) {
+        const size_t outer = outerSize();
+        for (const SparseEntry<T>& e : entries) {
+            if (e.row >= rows || e.col >= cols) {
+                throw std::out_of_range("  ");
+            }
+            offsets[(L == SparseLayout::Row ? e.row : e.col) + 1]++;
+        }
+        for (size_t o = 0; o < outer; o++) {
+            offsets[o + 1] += offsets[o];
+        }
+        std::vector<size_t> next(offsets.begin(), offsets.end() - 1);
+        std::vector<Index> rawIndices(entries.size());
+        std::vector<T> rawValues(entries.size());
+        for (const SparseEntry<T>& e : entries) {
+            const size_t pos = next[L == SparseLayout::Row ? e.row : e.col]++;
+            rawIndices[pos] = Index(L == SparseLayout::Row ? e.col : e.row);
+            rawValues[pos] = e.value;
+        }
+
+        //       
+        std::vector<size_t> order;
+        indices.reserve(entries.size());
+        values.reserve(entries.size());
+        size_t begin = 0;
+        for (size_t o = 0; o < outer; o++) {
+            const size_t end = offsets[o + 1];
+            order.resize(end - begin);
+            for (size_t p = 0; p < order.size(); p++) {
+                order[p] = begin + p;
+            }
+            std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return rawIndices[a] < rawIndices[b]; });
+            offsets[o] = indices.size();
+            for (size_t p = 0; p < order.size(); p++) {
+                if (p > 0 && rawIndices[order[p]] == indices.back()) {
+                    values.back() += rawValues[order[p]];
+                }
+                else {
+                    indices.push_back(rawIndices[order[p]]);
+                    values.push_back(rawValues[order[p]]);
+                }
+            }
+            begin = end;
+        }
+        offsets[outer] = indices.size();
+    }
+
+    ///   :  ,   
+    explicit SparseMatrix(const Matrix<T>& dense) : SparseMatrix(dense.getRows(), dense.getCols()) {
+        const T* data = dense.getData();
+        const size_t stride = dense.getStride();
+        if constexpr (L == SparseLayout::Row) {
+            for (size_t i = 0; i < rows; i++) {
+                const T* row = data + i * stride;
+                for (size_t j = 0; j < cols; j++) {
+                    if (row[j] != T()) {
+                        indices.push_back(Index(j));
+                        values.push_back(row[j]);
+                    }
+                }
+                offsets[i + 1] = indices.size();
+            }
+        }
+        else {
+            for (size_t j = 0; j < cols; j++) {
+                for (size_t i = 0; i < rows; i++) {
+                    if (data[i * stride + j] != T()) {
+                        indices.push_back(Index(i));
+                        values.push_back(data[i * stride + j]);
+                    }
+                }
+                offsets[j + 1] = indices.size();
+            }
+        }
+    }
+
+    ///   CSR <-> CSC (  )
+    template<SparseLayout M>
+    explicit SparseMatrix(const SparseMatrix<T, M>& other) : SparseMatrix(other.rows, other.cols) {
+        static_assert(M != L, "      ");
+        const size_t outer = outerSize();
+        for (Index index : other.indices) {
+            offsets[size_t(index) + 1]++;
+        }
+        for (size_t o = 0; o < outer; o++) {
+            offsets[o + 1] += offsets[o];
+        }
+        indices.resize(other.indices.size());
+        values.resize(other.values.size());
+        std::vector<size_t> next(offsets.begin(), offsets.end() - 1);
+        for (size_t o = 0; o + 1 < other.offsets.size(); o++) {
+            for (size_t p = other.offsets[o]; p < other.offsets[o + 1]; p++) {
+                const size_t pos = next[other.indices[p]]++;
+                indices[pos] = Index(o);
+                values[pos] = other.values[p];
+            }
+        }
+    }
+
+    ///  
+    Matrix<T> toMatrix() const {
+        Matrix<T> result(rows, cols);
+        T* data = result.getData();
+        const size_t stride = result.getStride();
+        for (size_t o = 0; o < outerSize(); o++) {
+            for (size_t p = offsets[o]; p < offsets[o + 1]; p++) {
+                if constexpr (L == SparseLayout::Row) {
+                    data[o * stride + indices[p]] = values[p];
+                }
+                else {
+                    data[size_t(indices[p]) * stride + o] = values[p];
+                }
+            }
+        }
+        return result;
+    }
+
+    ///  (row, col):     ,  - 
+    T operator()(size_t row, size_t col) const {
+        if (row >= rows || col >= cols) {
+            throw std::out_of_range("  ");
+        }
+        const size_t o = L == SparseLayout::Row ? row : col;
+        const Index inner = Index(L == SparseLayout::Row ? col : row);
+        const auto first = indices.begin() + std::ptrdiff_t(offsets[o]);
+        const auto last = indices.begin() + std::ptrdiff_t(offsets[o + 1]);
+        const auto it = std::lower_bound(first, last, inner);
+        return it != last && *it == inner ? values[size_t(it - indices.begin())] : T();
+    }
+
+    size_t getRows() const {
+        return rows;
+    }
+
+    size_t getCols() const {
+        return cols;
+    }
+
+    ///   () 
+    size_t nonZeros() const {
+        return values.size();
+    }
+
+    const std::vector<size_t>& getOffsets() const {
+        return offsets;
+    }
+
+    const std::vector<Index>& getIndices() const {
+        return indices;
+    }
+
+    const std::vector<T>& getValues() const {
+        return values;
+    }
+
+    /// y = A * x (x  cols, y  rows)
+    void multiply(const T* x, T* y) const {
+        if constexpr (L == SparseLayout::Row) {
+            const std::vector<size_t> bounds = detail::sparseChunks(offsets, detail::sparseParts(nonZeros()));
+            parallelFor(bounds.size() - 1, [&](size_t t) {
+                for (size_t i = bounds[t]; i < bounds[t + 1]; i++) {
+                    T sum = T();
+                    for (size_t p = offsets[i]; p < offsets[i + 1]; p++) {
+                        sum += values[p] * x[indices[p]];
+                    }
+                    y[i] = sum;
+                }
+            });
+        }
+        else {
+            //     :      y,  -  
+            //   rows,   .   ,  
+            // sparseScatterRatio,       O(nnz)
+            const size_t limit = std::max<size_t>(1, detail::sparseScatterRatio * nonZeros() / std::max<size_t>(rows, 1));
+            const std::vector<size_t> bounds = detail::sparseChunks(offsets, std::min(detail::sparseParts(nonZeros()), limit));
+            const size_t parts = bounds.size() - 1;
+            std::vector<std::vector<T>> partial(parts - 1);
+            parallelFor(parts, [&](size_t t) {
+                T* acc = y;
+                if (t > 0) {
+                    partial[t - 1].assign(rows, T());
+                    acc = partial[t - 1].data();
+                }
+                else {
+                    std::fill(y, y + rows, T());
+                }
+                for (size_t j = bounds[t]; j < bounds[t + 1]; j++) {
+                    const T xj = x[j];
+                    for (size_t p = offsets[j]; p < offsets[j + 1]; p++) {
+                        acc[indices[p]] += values[p] * xj;
+                    }
+                }
+            });
+            if (parts == 1) {
+                return;
+            }
+            const size_t rowsPerTask = std::max<size_t>(1, detail::sparseParallelNonZeros / parts);
+            parallelFor((rows + rowsPerTask - 1) / rowsPerTask, [&](size_t t) {
+                const size_t r1 = std::min(rows, (t + 1) * rowsPerTask);
+                for (size_t i = t * rowsPerTask; i < r1; i++) {
+                    T sum = y[i];
+                    for (const std::vector<T>& acc : partial) {
+                        sum += acc[i];
+                    }
+                    y[i] = sum;
+                }
+            });
+        }
+    }
+
+    ///   
+    std::vector<T> operator*(const std::vector<T>& x) const {
+        if (x.size() != cols) {
+            throw std::invalid_argument("       ");
+        }
+        std::vector<T> y(rows);
+        multiply(x.data(), y.data());
+        return y;
+    }
+
+    ///    :   a(i, k)  a(i, k) * B(k, :)  C(i, :)
+    Matrix<T> operator*(const Matrix<T>& dense) const {
+        if (cols != dense.getRows()) {
+            throw std::invalid_argument("        ");
+        }
+        const size_t n = dense.getCols();
+        Matrix<T> result(rows, n);
+        const T* b = dense.getData();
+        const size_t ldb = dense.getStride();
+        T* c = result.getData();
+        const size_t ldc = result.getStride();
+        if constexpr (L == SparseLayout::Row) {
+            const std::vector<size_t> bounds = detail::sparseChunks(offsets, detail::sparseParts(nonZeros() * n));
+            parallelFor(bounds.size() - 1, [&](size_t t) {
+                detail::spmmDispatch<T, Index, true>(offsets.data(), indices.data(), values.data(), bounds[t], bounds[t + 1],
+                    b, ldb, c, ldc, 0, n);
+            });
+        }
+        else {
+            //   A    C  ,     C
+            const size_t panel = std::max<size_t>(64, (n + threadCount() - 1) / threadCount());
+            const size_t panels = nonZeros() * n < detail::sparseParallelNonZeros ? 1 : (n + panel - 1) / panel;
+            const size_t width = (n + panels - 1) / std::max<size_t>(panels, 1);
+            parallelFor(panels, [&](size_t t) {
+                detail::spmmDispatch<T, Index, false>(offsets.data(), indices.data(), values.data(), 0, cols,
+                    b, ldb, c, ldc, t * width, std::min(n, (t + 1) * width));
+            });
+        }
+        return result;
+    }
+
+    ///      (,   ,  )
+    SparseMatrix operator+(const SparseMatrix& other) const {
+        return merge<detail::AddOp>(other);
+    }
+
+    SparseMatrix operator-(const SparseMatrix& other) const {
+        return merge<detail::SubOp>(other);
+    }
+
+    ///    ( )
+    SparseMatrix operator*(T scalar) const {
+        SparseMatrix result(*this);
+        for (T& value : result.values) {
+            value *= scalar;
+        }
+        return result;
+    }
+
+    ///   : , , 
+    friend std::ostream& operator<<(std::ostream& os, const SparseMatrix& matrix) {
+        for (size_t o = 0; o < matrix.outerSize(); o++) {
+            for (size_t p = matrix.offsets[o]; p < matrix.offsets[o + 1]; p++) {
+                const size_t row = L == SparseLayout::Row ? o : matrix.indices[p];
+                const size_t col = L == SparseLayout::Row ? matrix.indices[p] : o;
+                os << "(" << row << ", " << col << ") " << matrix.values[p] << std::endl;
+            }
+        }
+        return os;
+    }
+};
+
+template<typename T>
+using CsrMatrix = SparseMatrix<T, SparseLayout::Row>;
+
+template<typename T>
+using CscMatrix = SparseMatrix<T, SparseLayout::Column>;
+
+
+template<typename T, SparseLayout L>
+SparseMatrix<T, L> operator*(T scalar, const SparseMatrix<T, L>& matrix) {
+    return matrix * scalar;
+}
+
+///    :  C ,    A
+template<typename T, SparseLayout L>
+Matrix<T> operator*(const Matrix<T>& dense, const SparseMatrix<T, L>& sparse) {
+    if (dense.getCols() != sparse.getRows()) {
+        throw std::invalid_argument("        ");
+    }
+    const size_t m = dense.getRows();
+    Matrix<T> result(m, sparse.getCols());
+    const std::vector<size_t>& offsets = sparse.getOffsets();
+    const auto& indices = sparse.getIndices();
+    const std::vector<T>& values = sparse.getValues();
+    const size_t rowsPerTask = std::max<size_t>(1, detail::sparseParallelNonZeros / std::max<size_t>(sparse.nonZeros(), 1));
+    const size_t tasks = (m + rowsPerTask - 1) / rowsPerTask;
+    parallelFor(tasks, [&](size_t t) {
+        const size_t r1 = std::min(m, (t + 1) * rowsPerTask);
+        for (size_t i = t * rowsPerTask; i < r1; i++) {
+            const T* a = dense.getData() + i * dense.getStride();
+            T* c = result.getData() + i * result.getStride();
+            if constexpr (L == SparseLayout::Row) {
+                // C(i, :) += A(i, k) * S(k, :)
+                for (size_t k = 0; k < dense.getCols(); k++) {
+                    if (a[k] == T()) {
+                        continue;
+                    }
+                    for (size_t p = offsets[k]; p < offsets[k + 1]; p++) {
+                        c[indices[p]] += a[k] * values[p];
+                    }
+                }
+            }
+            else {
+                // C(i, j) = A(i, :) . S(:, j)
+                for (size_t j = 0; j < sparse.getCols(); j++) {
+                    T sum = T();
+                    for (size_t p = offsets[j]; p < offsets[j + 1]; p++) {
+                        sum += a[indices[p]] * values[p];
+                    }
+                    c[j] = sum;
+                }
+            }
+        }
+    });
+    return result;
+}
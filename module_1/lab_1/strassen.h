@@ -0,0 +1,299 @@
+#pragma once
+
+#include <cstddef>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+#include "gemm.h"
+#include "simd.h"
+#include "thread_pool.h"
+
+
+///    -: 7     15 
+///  8 .  ,      crossover,
+///      gemm.    
+///  /.   (  )    
+///  ,       ;  ,
+///     ,   ,   .
+///     ,     
+///  (. strassenErrorReport);     strassenSettings().
+
+///   
+struct StrassenSettings {
+    bool enabled = false;
+    ///  ,     .    
+    /// AVX-512: n = 2048   10-15%, n = 3072 ( ) -  30%;  
+    ///  1024      gemm    .
+    size_t crossover = 1536;
+};
+
+inline StrassenSettings& strassenSettings() {
+    static StrassenSettings settings;
+    return settings;
+}
+
+namespace detail {
+
+///    :   
+inline size_t strassenStride(size_t cols) {
+    return (cols + 7) / 8 * 8;
+}
+
+inline bool strassenRecurses(size_t m, size_t n, size_t k, size_t crossover) {
+    return std::min({m, n, k}) >= std::max<size_t>(crossover, 2);
+}
+
+///    ( )   m x k  k x n
+inline size_t strassenWorkspace(size_t m, size_t n, size_t k, size_t crossover) {
+    if (!strassenRecurses(m, n, k, crossover)) {
+        return 0;
+    }
+    const size_t m2 = m / 2;
+    const size_t n2 = n / 2;
+    const size_t k2 = k / 2;
+    return m2 * strassenStride(std::max(k2, n2)) + k2 * strassenStride(n2) + strassenWorkspace(m2, n2, k2, crossover);
+}
+
+///   
+inline size_t strassenLevels(size_t m, size_t n, size_t k, size_t crossover) {
+    size_t levels = 0;
+    while (strassenRecurses(m, n, k, crossover)) {
+        m /= 2;
+        n /= 2;
+        k /= 2;
+        levels++;
+    }
+    return levels;
+}
+
+///   :        .
+///   ,      ( wait()  parallelFor)  
+///  -          ,   
+template<typename T>
+class StrassenArena {
+private:
+    std::unique_ptr<PackBuffer<T>> buffer;
+    size_t capacity = 0;
+    bool busy = false;
+
+public:
+    ///  ;    
+    T* reserve(size_t count) {
+        if (count > capacity && !busy) {
+            buffer.reset();
+            buffer = std::make_unique<PackBuffer<T>>(count);
+            capacity = count;
+        }
+        return buffer ? buffer->get() : nullptr;
+    }
+
+    bool isBusy() const {
+        return busy;
+    }
+
+    void setBusy(bool value) {
+        busy = value;
+    }
+
+    size_t size() const {
+        return capacity;
+    }
+};
+
+template<typename T>
+StrassenArena<T>& strassenArena() {
+    thread_local StrassenArena<T> arena;
+    return arena;
+}
+
+///      :  ,   ,
+///  (     ) -  
+template<typename T>
+class StrassenWorkspace {
+private:
+    StrassenArena<T>& arena;
+    std::unique_ptr<PackBuffer<T>> own;
+    bool borrowed = false;
+    T* work = nullptr;
+
+public:
+    explicit StrassenWorkspace(size_t count) : arena(strassenArena<T>()) {
+        if (!arena.isBusy()) {
+            work = arena.reserve(count);
+            arena.setBusy(true);
+            borrowed = true;
+        }
+        else if (count > 0) {
+            own = std::make_unique<PackBuffer<T>>(count);
+            work = own->get();
+        }
+    }
+
+    StrassenWorkspace(const StrassenWorkspace&) = delete;
+    StrassenWorkspace& operator=(const StrassenWorkspace&) = delete;
+
+    ~StrassenWorkspace() {
+        if (borrowed) {
+            arena.setBusy(false);
+        }
+    }
+
+    T* get() const {
+        return work;
+    }
+};
+
+///     m x n (   lda, ldb, ldc),   -  
+template<typename Op, typename T>
+void strassenCombine(size_t m, size_t n, const T* a, size_t lda, const T* b, size_t ldb, T* c, size_t ldc) {
+    const size_t rowsPerTask = std::max<size_t>(1, (1 << 16) / std::max<size_t>(n, 1));
+    parallelFor((m + rowsPerTask - 1) / rowsPerTask, [&](size_t t) {
+        const size_t r1 = std::min(m, (t + 1) * rowsPerTask);
+        for (size_t i = t * rowsPerTask; i < r1; i++) {
+            elementwise<Op>(a + i * lda, b + i * ldb, c + i * ldc, n);
+        }
+    });
+}
+
+/// C = A * B (beta = 0), work -    strassenWorkspace(m, n, k)
+template<typename T>
+void strassenRecursive(size_t m, size_t n, size_t k, const T* a, size_t lda, const T* b, size_t ldb,
+    T* c, size_t ldc, T* work, size_t crossover) {
+    if (!strassenRecurses(m, n, k, crossover)) {
+        gemm<T>(m, n, k, T(1), a, lda, 1, b, ldb, 1, T(), c, ldc);
+        return;
+    }
+    const size_t m2 = m / 2;
+    const size_t n2 = n / 2;
+    const size_t k2 = k / 2;
+
+    const T* a11 = a;
+    const T* a12 = a + k2;
+    const T* a21 = a + m2 * lda;
+    const T* a22 = a21 + k2;
+    const T* b11 = b;
+    const T* b12 = b + n2;
+    const T* b21 = b + k2 * ldb;
+    const T* b22 = b21 + n2;
+    T* c11 = c;
+    T* c12 = c + n2;
+    T* c21 = c + m2 * ldc;
+    T* c22 = c21 + n2;
+
+    //   : X (m2 x max(k2, n2))  Y (k2 x n2),  -   
+    const size_t ldx = strassenStride(std::max(k2, n2));
+    const size_t ldy = strassenStride(n2);
+    T* x = work;
+    T* y = x + m2 * ldx;
+    T* rest = y + k2 * ldy;
+
+    //       (Boyer, Dumas, Pernet, Zhou)
+    strassenCombine<SubOp>(m2, k2, a11, lda, a21, lda, x, ldx);               // S3 = A11 - A21
+    strassenCombine<SubOp>(k2, n2, b22, ldb, b12, ldb, y, ldy);               // T3 = B22 - B12
+    strassenRecursive(m2, n2, k2, x, ldx, y, ldy, c21, ldc, rest, crossover); // P7 = S3 * T3
+    strassenCombine<AddOp>(m2, k2, a21, lda, a22, lda, x, ldx);               // S1 = A21 + A22
+    strassenCombine<SubOp>(k2, n2, b12, ldb, b11, ldb, y, ldy);               // T1 = B12 - B11
+    strassenRecursive(m2, n2, k2, x, ldx, y, ldy, c22, ldc, rest, crossover); // P5 = S1 * T1
+    strassenCombine<SubOp>(m2, k2, x, ldx, a11, lda, x, ldx);                 // S2 = S1 - A11
+    strassenCombine<SubOp>(k2, n2, b22, ldb, y, ldy, y, ldy);                 // T2 = B22 - T1
+    strassenRecursive(m2, n2, k2, x, ldx, y, ldy, c12, ldc, rest, crossover); // P6 = S2 * T2
+    strassenCombine<SubOp>(m2, k2, a12, lda, x, ldx, x, ldx);                 // S4 = A12 - S2
+    strassenRecursive(m2, n2, k2, x, ldx, b22, ldb, c11, ldc, rest, crossover); // P3 = S4 * B22
+    strassenRecursive(m2, n2, k2, a11, lda, b11, ldb, x, ldx, rest, crossover); // P1 = A11 * B11
+    strassenCombine<AddOp>(m2, n2, x, ldx, c12, ldc, c12, ldc);               // U2 = P1 + P6
+    strassenCombine<AddOp>(m2, n2, c12, ldc, c21, ldc, c21, ldc);             // U3 = U2 + P7
+    strassenCombine<AddOp>(m2, n2, c12, ldc, c22, ldc, c12, ldc);             // U4 = U2 + P5
+    strassenCombine<AddOp>(m2, n2, c21, ldc, c22, ldc, c22, ldc);             // U7 = U3 + P5 = C22
+    strassenCombine<AddOp>(m2, n2, c12, ldc, c11, ldc, c12, ldc);             // U5 = U4 + P3 = C12
+    strassenCombine<SubOp>(k2, n2, y, ldy, b21, ldb, y, ldy);                 // T4 = T2 - B21
+    strassenRecursive(m2, n2, k2, a22, lda, y, ldy, c11, ldc, rest, crossover); // P4 = A22 * T4
+    strassenCombine<SubOp>(m2, n2, c21, ldc, c11, ldc, c21, ldc);             // U6 = U3 - P4 = C21
+    strassenRecursive(m2, n2, k2, a12, lda, b21, ldb, c11, ldc, rest, crossover); // P2 = A12 * B21
+    strassenCombine<AddOp>(m2, n2, x, ldx, c11, ldc, c11, ldc);               // U1 = P1 + P2 = C11
+
+    //       
+    if (k % 2 != 0) {
+        gemm<T>(2 * m2, 2 * n2, 1, T(1), a + 2 * k2, lda, 1, b + 2 * k2 * ldb, ldb, 1, T(1), c, ldc);
+    }
+    if (n % 2 != 0) {
+        gemm<T>(2 * m2, 1, k, T(1), a, lda, 1, b + 2 * n2, ldb, 1, T(), c + 2 * n2, ldc);
+    }
+    if (m % 2 != 0) {
+        gemm<T>(1, n, k, T(1), a + 2 * m2 * lda, lda, 1, b, ldb, 1, T(), c + 2 * m2 * ldc, ldc);
+    }
+}
+
+} // namespace detail
+
+
+///    m x k  k x n      
+template<typename T>
+bool strassenApplies(size_t m, size_t n, size_t k) {
+    const StrassenSettings& settings = strassenSettings();
+    return std::is_floating_point_v<T> && settings.enabled && detail::strassenRecurses(m, n, k, settings.crossover);
+}
+
+///         n x n
+template<typename T>
+void reserveStrassenWorkspace(size_t n) {
+    detail::strassenArena<T>().reserve(detail::strassenWorkspace(n, n, n, strassenSettings().crossover));
+}
+
+/// C = A * B  - ( A, B, C   lda, ldb, ldc)
+template<typename T>
+void strassen(size_t m, size_t n, size_t k, const T* a, size_t lda, const T* b, size_t ldb, T* c, size_t ldc) {
+    const size_t crossover = strassenSettings().crossover;
+    const detail::StrassenWorkspace<T> work(detail::strassenWorkspace(m, n, k, crossover));
+    detail::strassenRecursive(m, n, k, a, lda, b, ldb, c, ldc, work.get(), crossover);
+}
+
+
+///         n x n  [-1, 1]
+struct StrassenErrorReport {
+    size_t n = 0;
+    size_t levels = 0;
+    /// max |C_strassen - C_classic|
+    double maxAbsError = 0;
+    /// maxAbsError / max |C_classic|
+    double maxRelError = 0;
+    /// maxAbsError   n * eps * max|A| * max|B| (   )
+    double errorInUnits = 0;
+};
+
+template<typename T>
+StrassenErrorReport strassenErrorReport(size_t n, unsigned seed = 1) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<T> dis(T(-1), T(1));
+    std::vector<T> a(n * n);
+    std::vector<T> b(n * n);
+    for (size_t i = 0; i < n * n; i++) {
+        a[i] = dis(gen);
+        b[i] = dis(gen);
+    }
+    std::vector<T> classic(n * n);
+    std::vector<T> fast(n * n);
+    gemm<T>(n, n, n, T(1), a.data(), n, 1, b.data(), n, 1, T(), classic.data(), n);
+    strassen<T>(n, n, n, a.data(), n, b.data(), n, fast.data(), n);
+
+    StrassenErrorReport report;
+    report.n = n;
+    report.levels = detail::strassenLevels(n, n, n, strassenSettings().crossover);
+    double maxValue = 0;
+    double maxA = 0;
+    double maxB = 0;
+    for (size_t i = 0; i < n * n; i++) {
+        report.maxAbsError = std::max(report.maxAbsError, double(std::abs(fast[i] - classic[i])));
+        maxValue = std::max(maxValue, double(std::abs(classic[i])));
+        maxA = std::max(maxA, double(std::abs(a[i])));
+        maxB = std::max(maxB, double(std::abs(b[i])));
+    }
+    report.maxRelError = maxValue > 0 ? report.maxAbsError / maxValue : 0;
+    const double unit = double(n) * double(std::numeric_limits<T>::epsilon()) * maxA * maxB;
+    report.errorInUnits = unit > 0 ? report.maxAbsError / unit : 0;
+    return report;
+}
@@ -0,0 +1,1139 @@
+#include <iostream>
+#include <random>
+#include <filesystem>
+#include <tuple>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <complex>
+#include <functional>
+#include <stdexcept>
+
+#include "matrix.h"
+#include "blas.h"
+#include "dense_vector.h"
+#include "fixed_matrix.h"
+#include "lu.h"
+#include "matrix_arena.h"
+#include "matrix_batch.h"
+#include "matrix_chain.h"
+#include "matrix_io.h"
+#include "matrix_out_of_core.h"
+#include "matrix_power.h"
+#include "matrix_random.h"
+#include "matrix_view.h"
+#include "mixed_precision.h"
+#include "mod_int.h"
+#include "packed_matrix.h"
+#include "planar_complex.h"
+#include "qr.h"
+#include "quantized_matrix.h"
+#include "simd.h"
+#include "sparse_matrix.h"
+#include "strassen.h"
+#include "thread_pool.h"
+#include "transpose.h"
+
+
+using namespace std;
+
+///     :   -   ,
+///      ;   -  .
+
+namespace {
+
+int failures = 0;
+
+void check(bool condition, const string& what) {
+    if (!condition) {
+        cerr << "FAIL: " << what << endl;
+        failures++;
+    }
+}
+
+/// true,  f  invalid_argument
+bool throwsInvalidArgument(const function<void()>& f) {
+    try {
+        f();
+    }
+    catch (const invalid_argument&) {
+        return true;
+    }
+    return false;
+}
+
+bool throwsRuntimeError(const function<void()>& f) {
+    try {
+        f();
+    }
+    catch (const runtime_error&) {
+        return true;
+    }
+    return false;
+}
+
+///     :     double 
+Matrix<double> integerMatrix(size_t rows, size_t cols, unsigned seed) {
+    Matrix<double> result(rows, cols);
+    unsigned state = seed;
+    for (size_t i = 0; i < rows; i++) {
+        for (size_t j = 0; j < cols; j++) {
+            state = state * 1103515245u + 12345u;
+            result(i, j) = double(int((state >> 16) % 9) - 4);
+        }
+    }
+    return result;
+}
+
+Matrix<double> fromRows(const vector<vector<double>>& rows) {
+    Matrix<double> result(rows.size(), rows.empty() ? 0 : rows[0].size());
+    for (size_t i = 0; i < result.getRows(); i++) {
+        for (size_t j = 0; j < result.getCols(); j++) {
+            result(i, j) = rows[i][j];
+        }
+    }
+    return result;
+}
+
+Matrix<double> identity(size_t n) {
+    Matrix<double> result(n, n);
+    for (size_t i = 0; i < n; i++) {
+        result(i, i) = 1;
+    }
+    return result;
+}
+
+///    -    
+template<typename T>
+Matrix<T> naiveProduct(const Matrix<T>& a, const Matrix<T>& b) {
+    Matrix<T> c(a.getRows(), b.getCols());
+    for (size_t i = 0; i < a.getRows(); i++) {
+        for (size_t t = 0; t < a.getCols(); t++) {
+            for (size_t j = 0; j < b.getCols(); j++) {
+                c(i, j) += a(i, t) * b(t, j);
+            }
+        }
+    }
+    return c;
+}
+
+/// max |a - b| / (1 + max |b|)
+template<typename T>
+double relativeDifference(const Matrix<T>& a, const Matrix<T>& b) {
+    if (a.getRows() != b.getRows() || a.getCols() != b.getCols()) {
+        return INFINITY;
+    }
+    double diff = 0;
+    double scale = 0;
+    for (size_t i = 0; i < a.getRows(); i++) {
+        for (size_t j = 0; j < a.getCols(); j++) {
+            diff = max(diff, double(abs(a(i, j) - b(i, j))));
+            scale = max(scale, double(abs(b(i, j))));
+        }
+    }
+    return diff / (1 + scale);
+}
+
+bool exactlyEqual(const Matrix<double>& a, const Matrix<double>& b) {
+    return relativeDifference(a, b) == 0;
+}
+
+///        
+class StrassenScope {
+private:
+    StrassenSettings saved;
+
+public:
+    explicit StrassenScope(size_t crossover) : saved(strassenSettings()) {
+        strassenSettings().enabled = true;
+        strassenSettings().crossover = crossover;
+    }
+
+    ~StrassenScope() {
+        strassenSettings() = saved;
+    }
+};
+
+///     ,  ,  : , 
+///   ,    ,     
+///     (    ,   )
+void testStrassenConcurrent() {
+    setThreadCount(4);
+    const vector<size_t> sizes = {600, 1100, 520, 900, 1100, 600, 700, 1000};
+    vector<Matrix<double>> a;
+    vector<Matrix<double>> b;
+    vector<Matrix<double>> expected;
+    for (size_t i = 0; i < sizes.size(); i++) {
+        a.push_back(integerMatrix(sizes[i], sizes[i], unsigned(2 * i + 1)));
+        b.push_back(integerMatrix(sizes[i], sizes[i], unsigned(2 * i + 2)));
+        expected.push_back(a[i] * b[i]);
+    }
+    const StrassenScope scope(256);
+    for (int repeat = 0; repeat < 3; repeat++) {
+        vector<Matrix<double>> c(sizes.size(), Matrix<double>(0, 0));
+        TaskGroup group(threadPool());
+        for (size_t i = 0; i < sizes.size(); i++) {
+            group.run([&, i] { c[i] = a[i] * b[i]; });
+        }
+        group.wait();
+        for (size_t i = 0; i < sizes.size(); i++) {
+            check(exactlyEqual(c[i], expected[i]), "   , n = " + to_string(sizes[i]));
+        }
+    }
+    setThreadCount(0);
+}
+
+///    :      ,     
+///  ,   -       ,   
+void testStrassenNested() {
+    const StrassenScope scope(256);
+    const size_t outerSize = detail::strassenWorkspace(600, 600, 600, 256);
+    const detail::StrassenWorkspace<double> outer(outerSize);
+    double* work = outer.get();
+    for (size_t i = 0; i < outerSize; i++) {
+        work[i] = double(i % 1000);
+    }
+    const Matrix<double> a = integerMatrix(1100, 1100, 5);
+    const Matrix<double> b = integerMatrix(1100, 1100, 6);
+    const Matrix<double> c = a * b;
+    bool intact = outer.get() == work;
+    for (size_t i = 0; i < outerSize && intact; i++) {
+        intact = work[i] == double(i % 1000);
+    }
+    check(intact, "      ");
+    strassenSettings().enabled = false;
+    check(exactlyEqual(c, a * b), "  ");
+}
+
+///     :    ,    
+///  ;      
+void testChainStrassen() {
+    setThreadCount(4);
+    const vector<size_t> dims = {300, 600, 300, 600, 300};
+    vector<Matrix<double>> matrices;
+    for (size_t i = 0; i + 1 < dims.size(); i++) {
+        matrices.push_back(integerMatrix(dims[i], dims[i + 1], unsigned(i + 11)));
+    }
+    const Matrix<double> expected = matrices[0] * matrices[1] * matrices[2] * matrices[3];
+    const StrassenScope scope(128);
+    for (int repeat = 0; repeat < 3; repeat++) {
+        const Matrix<double> product = multiplyChain(matrices[0], matrices[1], matrices[2], matrices[3]);
+        check(exactlyEqual(product, expected), "  ");
+    }
+    check(chainOrder<double>({&matrices[0], &matrices[1], &matrices[2], &matrices[3]}).toString() == "((A0 * A1) * (A2 * A3))",
+        " ");
+    setThreadCount(0);
+}
+
+///   LU:     - ,    -  
+void testLUSingular() {
+    // -     1e-16,   0:  ,     
+    const Matrix<double> a = fromRows({{1, 2, 3}, {4, 5, 6}, {7, 8, 9}});
+    const LUDecomposition<double> lu(a);
+    check(!lu.isSingular() && lu.isNearlySingular() && lu.pivotRatio() < 1e-15, "LU:    3 x 3");
+
+    const Matrix<double> exact = fromRows({{1, 2, 3}, {2, 4, 6}, {1, 0, 1}});
+    const LUDecomposition<double> exactLU(exact);
+    check(exactLU.isSingular() && exactLU.pivotRatio() == 0, "LU:   ");
+    check(throwsInvalidArgument([&] { inverse(exact); }), "LU:    ");
+    check(throwsInvalidArgument([&] { solve(exact, fromRows({{1}, {2}, {3}})); }), "LU:    ");
+
+    //  ,     
+    const Matrix<double> scaled = fromRows({{1, 0}, {0, 1e-20}});
+    const LUDecomposition<double> scaledLU(scaled);
+    check(!scaledLU.isSingular() && scaledLU.isNearlySingular(), "LU: diag(1, 1e-20)  ");
+    check(exactlyEqual(scaledLU.solve(fromRows({{3}, {2e-20}})), fromRows({{3}, {2}})), "LU:   diag(1, 1e-20)");
+
+    const Matrix<double> b = integerMatrix(300, 300, 21);
+    const Matrix<double> x = integerMatrix(300, 4, 22);
+    check(relativeDifference(solve(b, b * x), x) < 1e-9, "LU:  ");
+    check(relativeDifference(b * inverse(b), identity(300)) < 1e-9, "LU:  ");
+    check(!LUDecomposition<double>(b).isNearlySingular(), "LU:   ");
+}
+
+///  :    double       
+void testMixedPrecision() {
+    const Matrix<double> a = integerMatrix(200, 200, 31);
+    const Matrix<double> x = integerMatrix(200, 3, 32);
+    const MixedPrecisionSolver<double> solver(a);
+    RefinementInfo info;
+    check(relativeDifference(solver.solve(a * x, &info), x) < 1e-10 && info.converged, " : ");
+    check(relativeDifference(a * inverseMixed(a), identity(200)) < 1e-10, " : ");
+
+    const Matrix<double> singular = fromRows({{1, 2, 3}, {2, 4, 6}, {1, 0, 1}});
+    const Matrix<double> b = fromRows({{1}, {2}, {3}});
+    const MixedPrecisionSolver<double> singularSolver(singular);
+    check(throwsInvalidArgument([&] { singularSolver.inverse(); }), " :   ");
+    check(throwsInvalidArgument([&] { singularSolver.solve(b); }), " :   ");
+    check(throwsInvalidArgument([&] { inverseMixed(singular); }), " : inverseMixed ");
+
+    //   float ,        LU  double.
+    //      inf  NaN,    NaN     
+    const LUDecomposition<float> unrelated(Matrix<float>(3, 3, 0.0f, 1.0f, 7));
+    check(throwsInvalidArgument([&] {
+        detail::refineSolve(singular, detail::normInf(singular), unrelated, identity(3), 30, nullptr,
+            [&] { return LUDecomposition<double>(singular); }, detail::singularInverseMessage);
+    }), " :   ");
+
+    //   10 x 10 (cond ~ 1e13):   float  ,  
+    //  A  double   -     A   
+    Matrix<double> hilbert(10, 10);
+    for (size_t i = 0; i < 10; i++) {
+        for (size_t j = 0; j < 10; j++) {
+            hilbert(i, j) = 1.0 / double(i + j + 1);
+        }
+    }
+    const MixedPrecisionSolver<double> hilbertSolver(hilbert);
+    const Matrix<double> rhs = hilbert * integerMatrix(10, 2, 33);
+    const size_t before = matrixHeapAllocations();
+    const Matrix<double> first = hilbertSolver.solve(rhs, &info);
+    const size_t firstAllocations = matrixHeapAllocations() - before;
+    check(hilbertSolver.usesLowPrecision() && !info.converged, " :   ");
+    const Matrix<double> second = hilbertSolver.solve(rhs, &info);
+    const size_t secondAllocations = matrixHeapAllocations() - before - firstAllocations;
+    check(exactlyEqual(first, second) && secondAllocations + 1 == firstAllocations,
+        " :   double  ");
+    check(relativeDifference(hilbert * first, rhs) < 1e-12, " :     double");
+}
+
+///      (  )
+vector<SparseEntry<double>> sparseEntries(size_t rows, size_t cols, size_t count, unsigned seed) {
+    vector<SparseEntry<double>> entries;
+    unsigned state = seed;
+    auto next = [&state] {
+        state = state * 1103515245u + 12345u;
+        return state >> 8;
+    };
+    for (size_t e = 0; e < count; e++) {
+        const size_t row = next() % rows;
+        const size_t col = next() % cols;
+        entries.push_back({row, col, double(int(next() % 9) - 4)});
+    }
+    return entries;
+}
+
+/// y = A * x   A
+vector<double> denseMatVec(const Matrix<double>& a, const vector<double>& x) {
+    vector<double> y(a.getRows());
+    for (size_t i = 0; i < a.getRows(); i++) {
+        for (size_t j = 0; j < a.getCols(); j++) {
+            y[i] += a(i, j) * x[j];
+        }
+    }
+    return y;
+}
+
+template<SparseLayout L>
+void checkSparse(size_t rows, size_t cols, size_t count, const string& name) {
+    const vector<SparseEntry<double>> entries = sparseEntries(rows, cols, count, unsigned(rows + cols));
+    const SparseMatrix<double, L> a(rows, cols, entries);
+    Matrix<double> dense(rows, cols);
+    for (const SparseEntry<double>& e : entries) {
+        dense(e.row, e.col) += e.value;
+    }
+    check(exactlyEqual(a.toMatrix(), dense), name + ":   ");
+    vector<double> x(cols);
+    for (size_t j = 0; j < cols; j++) {
+        x[j] = double(int(j % 7) - 3);
+    }
+    check(a * x == denseMatVec(dense, x), name + ":   ");
+    const Matrix<double> b = integerMatrix(cols, 5, 41);
+    check(exactlyEqual(a * b, naiveProduct(dense, b)), name + ":    ");
+    const Matrix<double> c = integerMatrix(3, rows, 42);
+    check(exactlyEqual(c * a, naiveProduct(c, dense)), name + ":   ");
+    const SparseMatrix<double, L> twice = a + a * 2.0;
+    check(exactlyEqual((twice - a).toMatrix(), dense * 2.0), name + ":   ");
+}
+
+///       ,      
+///      ,    CSC   
+void testSparse() {
+    setThreadCount(4);
+    checkSparse<SparseLayout::Row>(3000, 2000, 60000, "CSR");
+    checkSparse<SparseLayout::Column>(3000, 2000, 60000, "CSC");
+    checkSparse<SparseLayout::Column>(200000, 40, 40000, "CSC,  ");
+    checkSparse<SparseLayout::Column>(50, 0, 0, "CSC  ");
+    const CsrMatrix<double> csr(3000, 2000, sparseEntries(3000, 2000, 60000, 5000));
+    check(exactlyEqual(CscMatrix<double>(csr).toMatrix(), csr.toMatrix()), "  CSR -> CSC");
+    setThreadCount(0);
+}
+
+///     
+Matrix<double> productWithThreads(const Matrix<double>& a, const Matrix<double>& b, size_t threads) {
+    setThreadCount(threads);
+    Matrix<double> c = a * b;
+    setThreadCount(0);
+    return c;
+}
+
+///   gemm    :     
+///     ,    ,    
+void testGemmColumnPath() {
+    for (size_t n : {513, 1025}) {
+        const Matrix<double> a(300, n, -1.0, 1.0, 141);
+        const Matrix<double> b(n, n, -1.0, 1.0, 142);
+        check(relativeDifference(productWithThreads(a, b, 1), productWithThreads(a, b, 8)) == 0,
+            "gemm: 1  8 , n = " + to_string(n));
+    }
+    const Matrix<double> a(5000, 700, -1.0, 1.0, 143);
+    const Matrix<double> x(700, 1, -1.0, 1.0, 144);
+    const Matrix<double> y = productWithThreads(a, x, 1);
+    check(relativeDifference(y, productWithThreads(a, x, 4)) == 0, "gemm: , 1  4 ");
+    check(relativeDifference(y, naiveProduct(a, x)) < 1e-13, "gemm:   ");
+
+    //  3M       gemmComplex3mMinSide
+    for (size_t n : {1, 8, 16, 40}) {
+        Matrix<complex<double>> c(60, 50);
+        Matrix<complex<double>> d(50, n);
+        for (size_t i = 0; i < 60; i++) {
+            for (size_t j = 0; j < 50; j++) {
+                c(i, j) = complex<double>(double(int((i * 3 + j) % 9) - 4), double(int((i + 2 * j) % 7) - 3));
+            }
+        }
+        for (size_t i = 0; i < 50; i++) {
+            for (size_t j = 0; j < n; j++) {
+                d(i, j) = complex<double>(double(int((i + j * 5) % 9) - 4), double(int((3 * i + j) % 5) - 2));
+            }
+        }
+        check(relativeDifference(c * d, naiveProduct(c, d)) == 0, " gemm, n = " + to_string(n));
+    }
+}
+
+///  gemm     ,    
+void testGemm() {
+    for (const auto& [m, k, n] : vector<tuple<size_t, size_t, size_t>>{{1, 1, 1}, {7, 13, 5}, {65, 130, 33}, {200, 301, 257}}) {
+        const Matrix<double> a = integerMatrix(m, k, unsigned(m + 1));
+        const Matrix<double> b = integerMatrix(k, n, unsigned(n + 2));
+        check(exactlyEqual(a * b, naiveProduct(a, b)), "gemm " + to_string(m) + " x " + to_string(k) + " x " + to_string(n));
+        const Matrix<float> af(m, k, -1.0f, 1.0f, 151);
+        const Matrix<float> bf(k, n, -1.0f, 1.0f, 152);
+        check(relativeDifference(af * bf, naiveProduct(af, bf)) < 1e-5, "gemm float " + to_string(m) + " x " + to_string(k) + " x " + to_string(n));
+    }
+    Matrix<int> a(9, 11);
+    Matrix<int> b(11, 6);
+    for (size_t i = 0; i < 11; i++) {
+        for (size_t j = 0; j < 9; j++) {
+            a(j, i) = int(i * j % 7) - 3;
+        }
+        for (size_t j = 0; j < 6; j++) {
+            b(i, j) = int((i + j) % 5) - 2;
+        }
+    }
+    check(a * b == naiveProduct(a, b), "gemm  ");
+}
+
+///  :       ,
+///      ,  ;   -    
+void testGemmDeterministic() {
+    for (const auto& [m, k, n] : vector<tuple<size_t, size_t, size_t>>{{700, 900, 650}, {64, 3000, 64}, {1500, 200, 130}}) {
+        const Matrix<double> a(m, k, -1.0, 1.0, 161);
+        const Matrix<double> b(k, n, -1.0, 1.0, 162);
+        const Matrix<double> single = productWithThreads(a, b, 1);
+        for (size_t threads : {2, 3, 8}) {
+            check(relativeDifference(productWithThreads(a, b, threads), single) == 0,
+                "gemm: " + to_string(threads) + "   , " + to_string(m) + " x " + to_string(k) + " x " + to_string(n));
+        }
+        gemmSettings().deterministic = false;
+        check(relativeDifference(productWithThreads(a, b, 8), single) < 1e-13, "gemm:  ");
+        gemmSettings().deterministic = true;
+    }
+}
+
+///    L        0  70 (  )
+template<typename R, SimdLevel L>
+bool elementwiseMatchesScalar() {
+    bool ok = true;
+    for (size_t n = 0; n <= 70; n++) {
+        vector<R> a(n), b(n), c(n), expected(n);
+        for (size_t i = 0; i < n; i++) {
+            a[i] = R(int(i % 11) - 5) / R(4);
+            b[i] = R(int(i % 7) + 1) / R(8);
+        }
+        auto compare = [&](auto kernel, auto scalar) {
+            kernel(c.data());
+            scalar(expected.data());
+            ok &= c == expected;
+        };
+        using detail::ElementwiseKernels;
+        compare([&](R* out) { ElementwiseKernels<R, L>::template binary<detail::AddOp>(a.data(), b.data(), out, n); },
+            [&](R* out) { detail::scalarBinary<detail::AddOp>(a.data(), b.data(), out, n); });
+        compare([&](R* out) { ElementwiseKernels<R, L>::template binary<detail::SubOp>(a.data(), b.data(), out, n); },
+            [&](R* out) { detail::scalarBinary<detail::SubOp>(a.data(), b.data(), out, n); });
+        compare([&](R* out) { ElementwiseKernels<R, L>::template binary<detail::MulOp>(a.data(), b.data(), out, n); },
+            [&](R* out) { detail::scalarBinary<detail::MulOp>(a.data(), b.data(), out, n); });
+        compare([&](R* out) { ElementwiseKernels<R, L>::template binary<detail::DivOp>(a.data(), b.data(), out, n); },
+            [&](R* out) { detail::scalarBinary<detail::DivOp>(a.data(), b.data(), out, n); });
+        compare([&](R* out) { ElementwiseKernels<R, L>::template withScalar<detail::MulOp>(a.data(), R(3), out, n); },
+            [&](R* out) { detail::scalarWithScalar<detail::MulOp>(a.data(), R(3), out, n); });
+        compare([&](R* out) { ElementwiseKernels<R, L>::template withScalar<detail::DivOp>(a.data(), R(3), out, n); },
+            [&](R* out) { detail::scalarWithScalar<detail::DivOp>(a.data(), R(3), out, n); });
+        //  :     
+        vector<R> inPlace(a);
+        ElementwiseKernels<R, L>::template binary<detail::AddOp>(inPlace.data(), b.data(), inPlace.data(), n);
+        detail::scalarBinary<detail::AddOp>(a.data(), b.data(), expected.data(), n);
+        ok &= inPlace == expected;
+        if constexpr (is_same_v<R, double>) {
+            //    : n  ,  
+            vector<R> z(2 * n), out(2 * n);
+            for (size_t i = 0; i < 2 * n; i++) {
+                z[i] = R(int(i % 9) - 4);
+            }
+            ElementwiseKernels<R, L>::complexScale(z.data(), complex<R>(2, -3), out.data(), n);
+            for (size_t i = 0; i < n; i++) {
+                ok &= complex<R>(out[2 * i], out[2 * i + 1]) == complex<R>(z[2 * i], z[2 * i + 1]) * complex<R>(2, -3);
+            }
+        }
+    }
+    return ok;
+}
+
+///   ,   ,    Matrix
+void testElementwiseSimd() {
+    check(elementwiseMatchesScalar<float, SimdLevel::Generic>(), "  SSE2, float");
+    check(elementwiseMatchesScalar<double, SimdLevel::Generic>(), "  SSE2, double");
+#if MATRIX_X86_DISPATCH
+    if (simdLevel() >= SimdLevel::Avx2) {
+        check(elementwiseMatchesScalar<float, SimdLevel::Avx2>(), "  AVX2, float");
+        check(elementwiseMatchesScalar<double, SimdLevel::Avx2>(), "  AVX2, double");
+    }
+    if (simdLevel() >= SimdLevel::Avx512) {
+        check(elementwiseMatchesScalar<float, SimdLevel::Avx512>(), "  AVX-512, float");
+        check(elementwiseMatchesScalar<double, SimdLevel::Avx512>(), "  AVX-512, double");
+    }
+#endif
+    const Matrix<double> a = integerMatrix(13, 37, 171);
+    const Matrix<double> b = integerMatrix(13, 37, 172);
+    const Matrix<double> sum = a + b;
+    bool ok = true;
+    for (size_t i = 0; i < 13; i++) {
+        for (size_t j = 0; j < 37; j++) {
+            ok &= sum(i, j) == a(i, j) + b(i, j);
+        }
+    }
+    check(ok, "    ");
+}
+
+///        ,      
+void testExpressions() {
+    const Matrix<double> a = integerMatrix(37, 53, 181);
+    const Matrix<double> b = integerMatrix(37, 53, 182);
+    const Matrix<double> fused = a + a * 2.0 - b / 4.0;
+    bool ok = fused.getRows() == 37 && fused.getCols() == 53;
+    for (size_t i = 0; ok && i < 37; i++) {
+        for (size_t j = 0; j < 53; j++) {
+            ok &= fused(i, j) == a(i, j) + a(i, j) * 2.0 - b(i, j) / 4.0;
+        }
+    }
+    check(ok, " a + a * 2 - b / 4");
+
+    //    ,     
+    Matrix<double> c = a;
+    c = c * 2.0 + b;
+    Matrix<double> d = a;
+    d += b - d * 3.0;
+    Matrix<double> e = a;
+    e -= 0.5 * e;
+    ok = true;
+    for (size_t i = 0; i < 37; i++) {
+        for (size_t j = 0; j < 53; j++) {
+            ok &= c(i, j) == a(i, j) * 2.0 + b(i, j);
+            ok &= d(i, j) == a(i, j) + (b(i, j) - a(i, j) * 3.0);
+            ok &= e(i, j) == a(i, j) - 0.5 * a(i, j);
+        }
+    }
+    check(ok, "    ");
+
+    //      ,   
+    const Matrix<double> big = Matrix<double>(700, 900, -1.0, 1.0, 183);
+    const Matrix<double> twice = big * 2.0 - big;
+    check(twice == big, "     ");
+
+    Matrix<complex<double>> z(3, 5, complex<double>(1, 2));
+    z = z * complex<double>(0, 1) + z;
+    check(z(2, 4) == complex<double>(-1, 3), " ");
+
+    check(throwsInvalidArgument([&] { Matrix<double> r = a + integerMatrix(37, 52, 1); }), "   ");
+    check(throwsInvalidArgument([&] { Matrix<double> r = a / 0.0; }), "   ");
+}
+
+///    ( 3M)  
+void testPlanarComplex() {
+    Matrix<complex<double>> a(70, 45);
+    Matrix<complex<double>> b(45, 33);
+    for (size_t i = 0; i < 70; i++) {
+        for (size_t j = 0; j < 45; j++) {
+            a(i, j) = complex<double>(double(int((i * 3 + j) % 9) - 4), double(int((i + 2 * j) % 7) - 3));
+        }
+    }
+    for (size_t i = 0; i < 45; i++) {
+        for (size_t j = 0; j < 33; j++) {
+            b(i, j) = complex<double>(double(int((i + j * 5) % 9) - 4), double(int((3 * i + j) % 5) - 2));
+        }
+    }
+    const PlanarComplexMatrix<double> pa(a);
+    const PlanarComplexMatrix<double> pb(b);
+    check(relativeDifference(pa.toInterleaved(), a) == 0, ":   ");
+    check(relativeDifference((pa * pb).toInterleaved(), naiveProduct(a, b)) == 0, ": ");
+    check(relativeDifference((pa + pa - pa).toInterleaved(), a) == 0, ": ");
+}
+
+///     LU   
+void testFixedMatrix() {
+    const FixedMatrix<double, 3, 3> m{2, -1, 0, 1, 3, 2, 0, 1, 4};
+    const Matrix<double> dense = m.toMatrix();
+    check(abs(det(m) - det(dense)) < 1e-12, ": ");
+    check(relativeDifference((inverse(m) * m).toMatrix(), identity(3)) < 1e-12, ": ");
+    const FixedMatrix<double, 3, 2> r{1, 2, 3, 4, 5, 6};
+    check(exactlyEqual((m * r).toMatrix(), naiveProduct(dense, r.toMatrix())), ": ");
+    const FixedMatrix<double, 5, 5> big(integerMatrix(5, 5, 121) + identity(5) * 20.0);
+    check(relativeDifference((inverse(big) * big).toMatrix(), identity(5)) < 1e-12, " 5 x 5: ");
+}
+
+///        
+void testMatrixBatch() {
+    const size_t count = 103;
+    MatrixBatch<double, 3> a(count);
+    MatrixBatch<double, 3> b(count);
+    for (size_t e = 0; e < count; e++) {
+        FixedMatrix<double, 3, 3> x(integerMatrix(3, 3, unsigned(200 + e)));
+        if (e % 10 != 3) {
+            x = x + FixedMatrix<double, 3, 3>::identity() * 10.0;
+        }
+        else {
+            for (size_t j = 0; j < 3; j++) {
+                x(2, j) = x(0, j) + x(1, j);
+            }
+        }
+        a.set(e, x);
+        b.set(e, FixedMatrix<double, 3, 3>(integerMatrix(3, 3, unsigned(400 + e))));
+    }
+    const MatrixBatch<double, 3> product = a * b;
+    const vector<double> dets = a.det();
+    vector<uint8_t> singular;
+    const MatrixBatch<double, 3> inv = a.inverse(singular);
+    bool productOk = true;
+    bool detOk = true;
+    bool inverseOk = true;
+    for (size_t e = 0; e < count; e++) {
+        productOk &= product.get(e) == a.get(e) * b.get(e);
+        detOk &= abs(dets[e] - det(a.get(e).toMatrix())) < 1e-9 * (1 + abs(dets[e]));
+        if (e % 10 == 3) {
+            inverseOk &= singular[e] != 0;
+        }
+        else {
+            inverseOk &= singular[e] == 0 && relativeDifference((inv.get(e) * a.get(e)).toMatrix(), identity(3)) < 1e-12;
+        }
+    }
+    MatrixBatch<float, 4> c(count);
+    for (size_t e = 0; e < count; e++) {
+        Matrix<float> x(4, 4);
+        x.fillRandom(-4.0f, 4.0f, e);
+        c.set(e, FixedMatrix<float, 4, 4>(x));
+    }
+    const MatrixBatch<float, 4> square = c * c;
+    for (size_t e = 0; e < count; e++) {
+        productOk &= relativeDifference(square.get(e).toMatrix(), (c.get(e) * c.get(e)).toMatrix()) < 1e-6;
+    }
+    check(productOk, ": ");
+    check(detOk, ": ");
+    check(inverseOk, ":    ");
+}
+
+///     ,    
+class TemporaryDirectory {
+private:
+    filesystem::path path;
+
+public:
+    TemporaryDirectory() : path(filesystem::temp_directory_path() / ("lab_1_tests_" + to_string(random_device()()))) {
+        filesystem::create_directories(path);
+    }
+
+    ~TemporaryDirectory() {
+        error_code error;
+        filesystem::remove_all(path, error);
+    }
+
+    string file(const string& name) const {
+        return (path / name).string();
+    }
+};
+
+/// ,     
+void testMatrixIO() {
+    const TemporaryDirectory directory;
+    const Matrix<double> a = integerMatrix(37, 53, 101);
+    saveMatrix(a, directory.file("a.mat"));
+    check(exactlyEqual(loadMatrix<double>(directory.file("a.mat")), a), " : ");
+    MappedMatrix<double> mapped(directory.file("a.mat"));
+    check(exactlyEqual(Matrix<double>(mapped), a), " : ");
+    const Matrix<double> b = integerMatrix(53, 20, 102);
+    check(exactlyEqual(mapped * b, naiveProduct(a, b)), " :  ");
+    MappedMatrix<double> moved(std::move(mapped));
+    check(exactlyEqual(Matrix<double>(moved), a), " :  ");
+    check(mapped.getRows() == 0 && mapped.getCols() == 0 && mapped.getStride() == 0 && mapped.getData() == nullptr,
+        " :     ");
+    mapped.prefetchRows(0, 10);
+    saveMatrix(b, directory.file("b.mat"));
+    MappedMatrix<double> assigned(directory.file("b.mat"));
+    assigned = std::move(moved);
+    check(exactlyEqual(Matrix<double>(assigned), a) && moved.getRows() == 0 && moved.getData() == nullptr,
+        " :  ");
+    check(throwsInvalidArgument([&] { loadMatrix<float>(directory.file("a.mat")); }), " :   ");
+    check(throwsRuntimeError([&] { loadMatrix<double>(directory.file("missing.mat")); }), " :  ");
+}
+
+/// , ,      ,  
+void testViews() {
+    const Matrix<double> a = integerMatrix(77, 130, 51);
+    const Matrix<double> b = integerMatrix(130, 60, 52);
+    const Matrix<double> block = a.block(10, 20, 40, 50) * b.block(30, 5, 50, 25);
+    Matrix<double> left(40, 50);
+    Matrix<double> right(50, 25);
+    for (size_t i = 0; i < 40; i++) {
+        for (size_t j = 0; j < 50; j++) {
+            left(i, j) = a(10 + i, 20 + j);
+        }
+    }
+    for (size_t i = 0; i < 50; i++) {
+        for (size_t j = 0; j < 25; j++) {
+            right(i, j) = b(30 + i, 5 + j);
+        }
+    }
+    check(exactlyEqual(block, naiveProduct(left, right)), " ");
+    check(exactlyEqual(Matrix<double>(a.block(10, 20, 40, 50)), left), " ");
+
+    const Matrix<double> t = a.transposed();
+    check(exactlyEqual(t.transposed() * b, naiveProduct(a, b)), " ");
+    check(exactlyEqual(Matrix<double>(a.block(10, 20, 40, 50) + t.transposed().block(10, 20, 40, 50) * 2.0), left * 3.0),
+        "  ");
+
+    //      
+    Matrix<double> c = a;
+    c.row(3) = a.row(5);
+    c.col(7) = a.col(9) * 2.0;
+    bool ok = true;
+    for (size_t j = 0; j < a.getCols(); j++) {
+        ok &= c(3, j) == (j == 7 ? a(3, 9) * 2.0 : a(5, j));
+    }
+    for (size_t i = 0; i < a.getRows(); i++) {
+        ok &= c(i, 7) == a(i, 9) * 2.0;
+    }
+    check(ok, "   ");
+
+    Matrix<double> square = integerMatrix(64, 64, 53);
+    const Matrix<double> original = square;
+    square = square.transposed() + square;
+    ok = true;
+    for (size_t i = 0; i < 64; i++) {
+        for (size_t j = 0; j < 64; j++) {
+            ok &= square(i, j) == original(j, i) + original(i, j);
+        }
+    }
+    check(ok, "     ");
+}
+
+///  rows x cols   :      
+template<typename T>
+bool transposeMatches(const Matrix<T>& a) {
+    const Matrix<T> t = a.transposed();
+    bool ok = t.getRows() == a.getCols() && t.getCols() == a.getRows();
+    for (size_t i = 0; ok && i < a.getRows(); i++) {
+        for (size_t j = 0; j < a.getCols(); j++) {
+            ok &= t(j, i) == a(i, j);
+        }
+    }
+    Matrix<T> inPlace(a);
+    inPlace.transposeInPlace();
+    return ok && inPlace == t;
+}
+
+///        ;     
+void testTranspose() {
+    check(transposeMatches(integerMatrix(77, 130, 61)), " 77 x 130");
+    check(transposeMatches(integerMatrix(1000, 37, 62)), " 1000 x 37");
+    check(transposeMatches(integerMatrix(333, 333, 63)), " 333 x 333");
+    check(transposeMatches(integerMatrix(1, 9, 64)), " ");
+    check(transposeMatches(Matrix<float>(129, 67, -1.0f, 1.0f, 65)), " float");
+    check(transposeMatches(Matrix<complex<double>>(45, 70, complex<double>(-1, -1), complex<double>(1, 1), 66)),
+        " complex<double>");
+    check(transposeMatches(Matrix<int>(50, 31, 7)), " int");
+}
+
+/// :       ,   
+void testArena() {
+    const Matrix<double> a = integerMatrix(64, 64, 61);
+    const Matrix<double> expected = naiveProduct(a, a) + a;
+    MatrixArena arena;
+    {
+        const MatrixArenaScope scope(arena);
+        for (int iteration = 0; iteration < 4; iteration++) {
+            const Matrix<double> c = a * a + a;
+            check(exactlyEqual(c, expected), ": ");
+        }
+    }
+    check(arena.stats().hits > 0, ":   ");
+
+    //               ,  
+    setThreadCount(1);
+    const Matrix<double> left = integerMatrix(200, 300, 62);
+    const Matrix<double> right = integerMatrix(300, 150, 63);
+    const Matrix<double> product = naiveProduct(left, right) + right.block(0, 0, 200, 150);
+    size_t matrixBuffers = 0;
+    size_t packBuffers = 0;
+    bool same = true;
+    {
+        const MatrixArenaScope scope(arena);
+        for (int iteration = 0; iteration < 4; iteration++) {
+            if (iteration == 1) {
+                matrixBuffers = matrixHeapAllocations();
+                packBuffers = detail::packCache().heapAllocations();
+            }
+            const Matrix<double> c = left * right + right.block(0, 0, 200, 150);
+            same &= exactlyEqual(c, product);
+        }
+    }
+    check(same, ":  ");
+    check(packBuffers > 0 && matrixHeapAllocations() == matrixBuffers && detail::packCache().heapAllocations() == packBuffers,
+        ":      ");
+    setThreadCount(0);
+}
+
+///   [r0, r1)   L      Philox
+template<typename T, SimdLevel L>
+bool randomKernelMatchesGeneric(size_t rows, size_t cols) {
+    Matrix<T> expected(rows, cols);
+    Matrix<T> actual(rows, cols);
+    const T lower = T(-2);
+    const T upper = T(3);
+    detail::RandomKernel<T, SimdLevel::Generic>::run(expected.getData(), cols, expected.getStride(), lower, upper, 191, 0, rows);
+    detail::RandomKernel<T, L>::run(actual.getData(), cols, actual.getStride(), lower, upper, 191, 0, rows);
+    return actual == expected;
+}
+
+///      seed  :       
+void testRandomFill() {
+    setThreadCount(1);
+    const Matrix<double> serial(2000, 1500, -1.0, 1.0, 192);
+    const Matrix<float> serialFloat(301, 517, -1.0f, 1.0f, 193);
+    const Matrix<complex<double>> serialComplex(257, 129, complex<double>(-1, 0), complex<double>(1, 2), 194);
+    setThreadCount(4);
+    const Matrix<double> parallel(2000, 1500, -1.0, 1.0, 192);
+    const Matrix<float> parallelFloat(301, 517, -1.0f, 1.0f, 193);
+    const Matrix<complex<double>> parallelComplex(257, 129, complex<double>(-1, 0), complex<double>(1, 2), 194);
+    setThreadCount(0);
+    check(parallel == serial, " : 1  4 ");
+    check(parallelFloat == serialFloat, "  float: 1  4 ");
+    check(parallelComplex == serialComplex, "  complex: 1  4 ");
+
+    bool inRange = true;
+    for (size_t i = 0; i < serial.getRows(); i++) {
+        for (size_t j = 0; j < serial.getCols(); j++) {
+            inRange &= serial(i, j) >= -1.0 && serial(i, j) < 1.0;
+        }
+    }
+    for (size_t i = 0; i < serialComplex.getRows(); i++) {
+        for (size_t j = 0; j < serialComplex.getCols(); j++) {
+            const complex<double> z = serialComplex(i, j);
+            inRange &= z.real() >= -1.0 && z.real() < 1.0 && z.imag() >= 0.0 && z.imag() < 2.0;
+        }
+    }
+    check(inRange, " :   [lower, upper)");
+    check(!(Matrix<double>(2000, 1500, -1.0, 1.0, 195) == serial), " :  seed");
+
+#if MATRIX_X86_DISPATCH
+    if (simdLevel() >= SimdLevel::Avx2) {
+        check(randomKernelMatchesGeneric<double, SimdLevel::Avx2>(37, 53), " Philox AVX2, double");
+        check(randomKernelMatchesGeneric<float, SimdLevel::Avx2>(37, 53), " Philox AVX2, float");
+    }
+    if (simdLevel() >= SimdLevel::Avx512) {
+        check(randomKernelMatchesGeneric<double, SimdLevel::Avx512>(37, 53), " Philox AVX-512, double");
+        check(randomKernelMatchesGeneric<float, SimdLevel::Avx512>(37, 53), " Philox AVX-512, float");
+    }
+#endif
+}
+
+///   BLAS- 2  
+void testBlas() {
+    const size_t n = 203;
+    Vector<double> x(n);
+    Vector<double> y(n);
+    for (size_t i = 0; i < n; i++) {
+        x[i] = double(int(i % 7) - 3);
+        y[i] = double(int(i % 5) - 2);
+    }
+    double expectedDot = 0;
+    for (size_t i = 0; i < n; i++) {
+        expectedDot += x[i] * y[i];
+    }
+    check(dot(x, y) == expectedDot, "dot");
+    check(abs(nrm2(x) - sqrt(dot(x, x))) < 1e-12, "nrm2");
+    Vector<double> z(y);
+    axpy(2.0, x, z);
+    bool axpyOk = true;
+    for (size_t i = 0; i < n; i++) {
+        axpyOk &= z[i] == y[i] + 2 * x[i];
+    }
+    check(axpyOk, "axpy");
+
+    const Matrix<double> a = integerMatrix(150, n, 71);
+    const Vector<double> ax = a * x;
+    bool gemvOk = ax.size() == a.getRows();
+    for (size_t i = 0; i < a.getRows() && gemvOk; i++) {
+        double sum = 0;
+        for (size_t j = 0; j < n; j++) {
+            sum += a(i, j) * x[j];
+        }
+        gemvOk = ax[i] == sum;
+    }
+    check(gemvOk, "gemv");
+    Vector<double> w(150);
+    for (size_t i = 0; i < 150; i++) {
+        w[i] = double(int(i % 3) - 1);
+    }
+    const Vector<double> wa = w * a;
+    bool transposedOk = wa.size() == n;
+    for (size_t j = 0; j < n && transposedOk; j++) {
+        double sum = 0;
+        for (size_t i = 0; i < 150; i++) {
+            sum += w[i] * a(i, j);
+        }
+        transposedOk = wa[j] == sum;
+    }
+    check(transposedOk, "gemv  ");
+
+    const Vector<complex<double>> u = {{1, 2}, {3, -1}, {0, 4}};
+    const Vector<complex<double>> v = {{2, 1}, {-1, 1}, {5, 0}};
+    check(dotc(u, v) == conj(u[0]) * v[0] + conj(u[1]) * v[1] + conj(u[2]) * v[2], "dotc");
+}
+
+///      operator*
+void testOutOfCore() {
+    const TemporaryDirectory directory;
+    const Matrix<double> a = integerMatrix(310, 270, 111);
+    const Matrix<double> b = integerMatrix(270, 190, 112);
+    saveMatrix(a, directory.file("a.mat"));
+    saveMatrix(b, directory.file("b.mat"));
+    OutOfCoreOptions options;
+    options.tileRows = 64;
+    options.tileCols = 48;
+    options.tileDepth = 100;
+    multiplyOutOfCore<double>(directory.file("a.mat"), directory.file("b.mat"), directory.file("c.mat"), options);
+    check(exactlyEqual(loadMatrix<double>(directory.file("c.mat")), a * b), " : ");
+    multiplyOutOfCore<double>(directory.file("a.mat"), directory.file("b.mat"), directory.file("c.mat"));
+    check(exactlyEqual(loadMatrix<double>(directory.file("c.mat")), a * b), " :   ");
+}
+
+/// QR: Q * R = A, Q ,      
+void testQR() {
+    const Matrix<double> a = integerMatrix(300, 120, 81);
+    const QRDecomposition<double> qr(a);
+    const Matrix<double> q = qr.getQ();
+    check(qr.isFullRank(), "QR:  ");
+    check(relativeDifference(q * qr.getR(), a) < 1e-12, "QR:  A");
+    check(relativeDifference(Matrix<double>(q.transposed()) * q, identity(120)) < 1e-12, "QR:  Q");
+    const Matrix<double> x = integerMatrix(120, 3, 82);
+    check(relativeDifference(qr.solve(a * x), x) < 1e-10, "QR:  ");
+
+    Matrix<complex<double>> c(90, 40);
+    for (size_t i = 0; i < c.getRows(); i++) {
+        for (size_t j = 0; j < c.getCols(); j++) {
+            c(i, j) = complex<double>(double(int((i * 7 + j * 3) % 9) - 4), double(int((i + 5 * j) % 7) - 3));
+        }
+    }
+    const QRDecomposition<complex<double>> complexQR(c);
+    check(relativeDifference(complexQR.getQ() * complexQR.getR(), c) < 1e-12, "QR:  ");
+
+    const Matrix<double> tall = integerMatrix(20000, 16, 83);
+    const Matrix<double> y = integerMatrix(16, 2, 84);
+    const TallSkinnyQR<double> tsqr(tall);
+    check(tsqr.isFullRank(), "TSQR:  ");
+    check(relativeDifference(tsqr.solve(tall * y), y) < 1e-10, "TSQR:  ");
+}
+
+///  ,      
+void testPacked() {
+    const size_t n = 150;
+    const Matrix<double> g = integerMatrix(n, n, 91);
+    Matrix<double> spd = Matrix<double>(g.transposed()) * g;
+    for (size_t i = 0; i < n; i++) {
+        spd(i, i) += double(n);
+    }
+    const SymmetricMatrix<double> symmetric(spd);
+    check(exactlyEqual(symmetric.toMatrix(), spd), ": ");
+    const Matrix<double> b = integerMatrix(n, 4, 92);
+    check(exactlyEqual(symmetric * b, naiveProduct(spd, b)), ": ");
+    const Matrix<double> x = symmetric.solve(b);
+    check(relativeDifference(spd * x, b) < 1e-10, ":  ");
+    const TriangularMatrix<double, Triangle::Upper> factor = symmetric.cholesky();
+    check(relativeDifference(Matrix<double>(factor.toMatrix().transposed()) * factor.toMatrix(), spd) < 1e-12, " ");
+
+    Matrix<double> upperDense(n, n);
+    Matrix<double> lowerDense(n, n);
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = 0; j < n; j++) {
+            const double value = i == j ? 8.0 : g(i, j);
+            if (j >= i) {
+                upperDense(i, j) = value;
+            }
+            if (j <= i) {
+                lowerDense(i, j) = value;
+            }
+        }
+    }
+    const TriangularMatrix<double, Triangle::Upper> upper(upperDense);
+    const TriangularMatrix<double, Triangle::Lower> lower(lowerDense);
+    check(exactlyEqual(upper * b, naiveProduct(upperDense, b)), " : ");
+    check(exactlyEqual(lower * b, naiveProduct(lowerDense, b)), " : ");
+    check(relativeDifference(upperDense * upper.solve(b), b) < 1e-10, " : ");
+    check(relativeDifference(lowerDense * lower.solve(b), b) < 1e-10, " : ");
+
+    const size_t kl = 3;
+    const size_t ku = 5;
+    Matrix<double> bandDense(n, n);
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = i > kl ? i - kl : 0; j < min(n, i + ku + 1); j++) {
+            bandDense(i, j) = g(i, j);
+        }
+    }
+    const BandMatrix<double> band(bandDense, kl, ku);
+    check(exactlyEqual(band.toMatrix(), bandDense), ": ");
+    check(exactlyEqual(band * b, naiveProduct(bandDense, b)), ": ");
+    check(relativeDifference(bandDense * band.solve(b), b) < 1e-9, ": ");
+
+    check(exactlyEqual((symmetric + symmetric * 2.0 - 0.5 * symmetric).toMatrix(), Matrix<double>(spd * 2.5)),
+        ":  ");
+    check(exactlyEqual((upper + upper * 2.0 - 0.5 * upper).toMatrix(), Matrix<double>(upperDense * 2.5)),
+        " :  ");
+    check(exactlyEqual((band * 2.0).toMatrix(), Matrix<double>(bandDense * 2.0)) && exactlyEqual((0.5 * band).toMatrix(),
+        Matrix<double>(bandDense * 0.5)), ":   ");
+}
+
+///         int8  
+void testQuantized() {
+    for (const auto& [m, k, n] : vector<tuple<size_t, size_t, size_t>>{{37, 61, 29}, {64, 256, 48}, {5, 1, 3}}) {
+        Matrix<float> a(m, k);
+        Matrix<float> b(k, n);
+        a.fillRandom(-1.0f, 1.0f, 131);
+        b.fillRandom(-1.0f, 1.0f, 132);
+        a(0, 0) = -1.0f;
+        const QuantizedMatrix qa(a, QuantAxis::Rows);
+        const QuantizedMatrix qb(b, QuantAxis::Columns);
+        const Matrix<float> c = qa * qb;
+        bool exact = true;
+        for (size_t i = 0; i < m; i++) {
+            for (size_t j = 0; j < n; j++) {
+                int32_t sum = 0;
+                for (size_t t = 0; t < k; t++) {
+                    sum += int32_t(qa(i, t)) * int32_t(qb(t, j));
+                }
+                exact &= c(i, j) == qa.getScales()[i] * qb.getScales()[j] * float(sum);
+            }
+        }
+        check(exact, "  " + to_string(m) + " x " + to_string(k) + " x " + to_string(n));
+        check(relativeDifference(a * qb, c) == 0, "    ");
+        check(relativeDifference(qa.toMatrix(), a) < 0.01, ": ");
+    }
+}
+
+///  :   , double -   
+void testPower() {
+    using Mod = ModInt<998244353>;
+    const size_t n = 24;
+    Matrix<Mod> a(n, n);
+    Matrix<double> d(n, n);
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = 0; j < n; j++) {
+            a(i, j) = Mod(int64_t(i * 31 + j * 17) - 200);
+            d(i, j) = double(int((i * 5 + j * 3) % 5) - 2) / 4;
+        }
+    }
+    Matrix<Mod> repeated = a;
+    Matrix<double> repeatedDouble = d;
+    for (uint64_t k = 2; k <= 23; k++) {
+        repeated = naiveProduct(repeated, a);
+        repeatedDouble = naiveProduct(repeatedDouble, d);
+        const Matrix<Mod> power = pow(a, k);
+        bool equal = true;
+        for (size_t i = 0; i < n; i++) {
+            for (size_t j = 0; j < n; j++) {
+                equal &= power(i, j) == repeated(i, j);
+            }
+        }
+        check(equal, " , k = " + to_string(k));
+        check(relativeDifference(pow(d, k), repeatedDouble) < 1e-12, " double, k = " + to_string(k));
+    }
+    check(exactlyEqual(pow(d, 0), identity(n)), " ");
+
+    Matrix<Mod> v(n, 3);
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = 0; j < 3; j++) {
+            v(i, j) = Mod(int64_t(i + 7 * j));
+        }
+    }
+    for (uint64_t k : {1, 2, 5, 1000}) {
+        const Matrix<Mod> applied = applyPower(a, k, v);
+        const Matrix<Mod> expected = naiveProduct(pow(a, k), v);
+        bool equal = true;
+        for (size_t i = 0; i < n; i++) {
+            for (size_t j = 0; j < 3; j++) {
+                equal &= applied(i, j) == expected(i, j);
+            }
+        }
+        check(equal, "A^k * V, k = " + to_string(k));
+    }
+
+    Mod previous = 0;
+    Mod current = 1;
+    for (int i = 1; i < 100000; i++) {
+        const Mod next = previous + current;
+        previous = current;
+        current = next;
+    }
+    check(linearRecurrence<Mod>({1, 1}, {0, 1}, 100000) == current, "   ");
+    check(Mod(3) * Mod(3).inverse() == Mod(1) && Mod(-1).get() == 998244352, " ");
+}
+
+} // namespace
+
+
+int main() {
+    const vector<pair<string, function<void()>>> tests = {
+        {"strassen concurrent", testStrassenConcurrent},
+        {"strassen nested", testStrassenNested},
+        {"chain strassen", testChainStrassen},
+        {"lu singular", testLUSingular},
+        {"mixed precision", testMixedPrecision},
+        {"sparse", testSparse},
+        {"gemm column path", testGemmColumnPath},
+        {"gemm", testGemm},
+        {"gemm deterministic", testGemmDeterministic},
+        {"elementwise simd", testElementwiseSimd},
+        {"expressions", testExpressions},
+        {"planar complex", testPlanarComplex},
+        {"fixed matrix", testFixedMatrix},
+        {"matrix batch", testMatrixBatch},
+        {"matrix io", testMatrixIO},
+        {"views", testViews},
+        {"transpose", testTranspose},
+        {"arena", testArena},
+        {"random fill", testRandomFill},
+        {"blas", testBlas},
+        {"out of core", testOutOfCore},
+        {"qr", testQR},
+        {"packed", testPacked},
+        {"quantized", testQuantized},
+        {"power", testPower},
+    };
+    for (const auto& [name, test] : tests) {
+        try {
+            test();
+        }
+        catch (const exception& e) {
+            check(false, name + ":  " + e.what());
+        }
+        cerr << name << ": done" << endl;
+    }
+    cerr << (failures == 0 ? "OK" : to_string(failures) + " FAIL") << endl;
+    return failures;
+}
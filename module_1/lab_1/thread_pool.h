@@ -0,0 +1,258 @@
+#pragma once
+
+#include <cstddef>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+///      (work stealing).
+///      :      (LIFO,  ),
+///       .      .
+/// ,   ,   ,     .
+class ThreadPool {
+public:
+    using Task = std::function<void()>;
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    size_t threads;
+    std::vector<std::unique_ptr<Queue>> queues;  // queues[threads - 1] -  
+    std::vector<std::thread> workers;
+    std::atomic<size_t> queued{0};
+    std::atomic<bool> stopping{false};
+    std::mutex sleepMutex;
+    std::condition_variable wakeUp;
+
+    ///         (  )
+    size_t ownQueue() const {
+        return currentPool() == this ? currentIndex() : threads - 1;
+    }
+
+    static const ThreadPool*& currentPool() {
+        thread_local const ThreadPool* pool = nullptr;
+        return pool;
+    }
+
+    static size_t& currentIndex() {
+        thread_local size_t index = 0;
+        return index;
+    }
+
+    bool tryPop(Task& task) {
+        const size_t own = ownQueue();
+        {
+            Queue& queue = *queues[own];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (!queue.tasks.empty()) {
+                task = std::move(queue.tasks.back());
+                queue.tasks.pop_back();
+                queued--;
+                return true;
+            }
+        }
+        for (size_t shift = 1; shift < queues.size(); shift++) {
+            Queue& victim = *queues[(own + shift) % queues.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.tasks.empty()) {
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                queued--;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void workerLoop(size_t index) {
+        currentPool() = this;
+        currentIndex() = index;
+        Task task;
+        while (true) {
+            if (tryPop(task)) {
+                task();
+                task = nullptr;
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            wakeUp.wait(lock, [this] { return stopping || queued > 0; });
+            if (stopping && queued == 0) {
+                return;
+            }
+        }
+    }
+
+public:
+    /// threads -       (  threads - 1)
+    explicit ThreadPool(size_t threads) : threads(threads == 0 ? 1 : threads) {
+        for (size_t i = 0; i < this->threads; i++) {
+            queues.push_back(std::make_unique<Queue>());
+        }
+        for (size_t i = 0; i + 1 < this->threads; i++) {
+            workers.emplace_back(&ThreadPool::workerLoop, this, i);
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            stopping = true;
+        }
+        wakeUp.notify_all();
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+    }
+
+    ///  ,  
+    size_t size() const {
+        return threads;
+    }
+
+    ///      
+    void submit(Task task) {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            queued++;
+        }
+        Queue& queue = *queues[ownQueue()];
+        {
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.tasks.push_back(std::move(task));
+        }
+        wakeUp.notify_one();
+    }
+
+    ///        ; false,   
+    bool runOne() {
+        Task task;
+        if (!tryPop(task)) {
+            return false;
+        }
+        task();
+        return true;
+    }
+};
+
+
+///  : run()    , wait()  ,   .
+///       wait().
+class TaskGroup {
+private:
+    ThreadPool& pool;
+    std::atomic<size_t> pending{0};
+    std::mutex errorMutex;
+    std::exception_ptr error;
+
+public:
+    explicit TaskGroup(ThreadPool& pool) : pool(pool) {}
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    ~TaskGroup() {
+        while (pending > 0) {
+            if (!pool.runOne()) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    template<typename F>
+    void run(F&& f) {
+        pending++;
+        pool.submit([this, f = std::forward<F>(f)]() mutable {
+            try {
+                f();
+            }
+            catch (...) {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if (!error) {
+                    error = std::current_exception();
+                }
+            }
+            pending--;
+        });
+    }
+
+    void wait() {
+        while (pending > 0) {
+            if (!pool.runOne()) {
+                std::this_thread::yield();
+            }
+        }
+        if (error) {
+            std::exception_ptr e = error;
+            error = nullptr;
+            std::rethrow_exception(e);
+        }
+    }
+};
+
+
+namespace detail {
+
+inline std::mutex& threadPoolMutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+
+inline std::unique_ptr<ThreadPool>& threadPoolSlot() {
+    static std::unique_ptr<ThreadPool> pool;
+    return pool;
+}
+
+} // namespace detail
+
+///       (    )
+inline ThreadPool& threadPool() {
+    std::lock_guard<std::mutex> lock(detail::threadPoolMutex());
+    std::unique_ptr<ThreadPool>& pool = detail::threadPoolSlot();
+    if (!pool) {
+        pool = std::make_unique<ThreadPool>(std::thread::hardware_concurrency());
+    }
+    return *pool;
+}
+
+///     (0 -   ).
+///  ,     .
+inline void setThreadCount(size_t threads) {
+    std::lock_guard<std::mutex> lock(detail::threadPoolMutex());
+    std::unique_ptr<ThreadPool>& pool = detail::threadPoolSlot();
+    pool.reset();
+    pool = std::make_unique<ThreadPool>(threads == 0 ? std::thread::hardware_concurrency() : threads);
+}
+
+inline size_t threadCount() {
+    return threadPool().size();
+}
+
+///     [0, count)   
+template<typename F>
+void parallelFor(size_t count, F f) {
+    ThreadPool& pool = threadPool();
+    if (count <= 1 || pool.size() == 1) {
+        for (size_t i = 0; i < count; i++) {
+            f(i);
+        }
+        return;
+    }
+    TaskGroup group(pool);
+    for (size_t i = 0; i < count; i++) {
+        group.run([&f, i] { f(i); });
+    }
+    group.wait();
+}
@@ -0,0 +1,474 @@
+#pragma once
+
+#include <cstddef>
+#include <algorithm>
+#include <complex>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#include "cpu.h"
+#include "thread_pool.h"
+
+
+///   "" .
+///     ,      transposeLeaf x transposeLeaf
+/// (      L1) - - ,   
+///  .     W x W,    
+///  SIMD (8 x 8 double  AVX-512, 4 x 4  AVX2, 8 x 8 float, 4 x 4 complex<double>).
+///        , 
+///  -    .
+
+namespace detail {
+
+///     ( )
+inline constexpr size_t transposeLeaf = 32;
+///  ,     
+inline constexpr size_t transposeTask = 256;
+
+///   W x W: b = a^T (a  b  :     )
+template<typename T, SimdLevel L>
+struct TransposeMicro {
+    static constexpr size_t W = 1;
+    static void run(const T* a, size_t, T* b, size_t) {
+        b[0] = a[0];
+    }
+};
+
+#if MATRIX_X86_DISPATCH && defined(__SSE2__)
+template<>
+struct TransposeMicro<double, SimdLevel::Generic> {
+    static constexpr size_t W = 2;
+    static void run(const double* a, size_t lda, double* b, size_t ldb) {
+        const __m128d r0 = _mm_loadu_pd(a);
+        const __m128d r1 = _mm_loadu_pd(a + lda);
+        _mm_storeu_pd(b, _mm_unpacklo_pd(r0, r1));
+        _mm_storeu_pd(b + ldb, _mm_unpackhi_pd(r0, r1));
+    }
+};
+
+template<>
+struct TransposeMicro<float, SimdLevel::Generic> {
+    static constexpr size_t W = 4;
+    static void run(const float* a, size_t lda, float* b, size_t ldb) {
+        __m128 r0 = _mm_loadu_ps(a);
+        __m128 r1 = _mm_loadu_ps(a + lda);
+        __m128 r2 = _mm_loadu_ps(a + 2 * lda);
+        __m128 r3 = _mm_loadu_ps(a + 3 * lda);
+        _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+        _mm_storeu_ps(b, r0);
+        _mm_storeu_ps(b + ldb, r1);
+        _mm_storeu_ps(b + 2 * ldb, r2);
+        _mm_storeu_ps(b + 3 * ldb, r3);
+    }
+};
+#endif
+
+#if MATRIX_X86_DISPATCH
+template<>
+struct TransposeMicro<double, SimdLevel::Avx2> {
+    static constexpr size_t W = 4;
+    MATRIX_TARGET("avx2,fma")
+    static void run(const double* a, size_t lda, double* b, size_t ldb) {
+        const __m256d r0 = _mm256_loadu_pd(a);
+        const __m256d r1 = _mm256_loadu_pd(a + lda);
+        const __m256d r2 = _mm256_loadu_pd(a + 2 * lda);
+        const __m256d r3 = _mm256_loadu_pd(a + 3 * lda);
+        const __m256d t0 = _mm256_unpacklo_pd(r0, r1);
+        const __m256d t1 = _mm256_unpackhi_pd(r0, r1);
+        const __m256d t2 = _mm256_unpacklo_pd(r2, r3);
+        const __m256d t3 = _mm256_unpackhi_pd(r2, r3);
+        _mm256_storeu_pd(b, _mm256_permute2f128_pd(t0, t2, 0x20));
+        _mm256_storeu_pd(b + ldb, _mm256_permute2f128_pd(t1, t3, 0x20));
+        _mm256_storeu_pd(b + 2 * ldb, _mm256_permute2f128_pd(t0, t2, 0x31));
+        _mm256_storeu_pd(b + 3 * ldb, _mm256_permute2f128_pd(t1, t3, 0x31));
+    }
+};
+
+template<>
+struct TransposeMicro<double, SimdLevel::Avx512> {
+    static constexpr size_t W = 8;
+    MATRIX_TARGET("avx512f")
+    static void run(const double* a, size_t lda, double* b, size_t ldb) {
+        const __m512d r0 = _mm512_loadu_pd(a);
+        const __m512d r1 = _mm512_loadu_pd(a + lda);
+        const __m512d r2 = _mm512_loadu_pd(a + 2 * lda);
+        const __m512d r3 = _mm512_loadu_pd(a + 3 * lda);
+        const __m512d r4 = _mm512_loadu_pd(a + 4 * lda);
+        const __m512d r5 = _mm512_loadu_pd(a + 5 * lda);
+        const __m512d r6 = _mm512_loadu_pd(a + 6 * lda);
+        const __m512d r7 = _mm512_loadu_pd(a + 7 * lda);
+        //  : [a00 a10 | a02 a12 | a04 a14 | a06 a16]  [a01 a11 | ...]
+        const __m512d t0 = _mm512_unpacklo_pd(r0, r1);
+        const __m512d t1 = _mm512_unpackhi_pd(r0, r1);
+        const __m512d t2 = _mm512_unpacklo_pd(r2, r3);
+        const __m512d t3 = _mm512_unpackhi_pd(r2, r3);
+        const __m512d t4 = _mm512_unpacklo_pd(r4, r5);
+        const __m512d t5 = _mm512_unpackhi_pd(r4, r5);
+        const __m512d t6 = _mm512_unpacklo_pd(r6, r7);
+        const __m512d t7 = _mm512_unpackhi_pd(r6, r7);
+        //  :     j  j + 4
+        const __m512i even = _mm512_set_epi64(13, 12, 5, 4, 9, 8, 1, 0);
+        const __m512i odd = _mm512_set_epi64(15, 14, 7, 6, 11, 10, 3, 2);
+        const __m512d u0 = _mm512_permutex2var_pd(t0, even, t2);
+        const __m512d u1 = _mm512_permutex2var_pd(t1, even, t3);
+        const __m512d u2 = _mm512_permutex2var_pd(t0, odd, t2);
+        const __m512d u3 = _mm512_permutex2var_pd(t1, odd, t3);
+        const __m512d v0 = _mm512_permutex2var_pd(t4, even, t6);
+        const __m512d v1 = _mm512_permutex2var_pd(t5, even, t7);
+        const __m512d v2 = _mm512_permutex2var_pd(t4, odd, t6);
+        const __m512d v3 = _mm512_permutex2var_pd(t5, odd, t7);
+        //    0-3  4-7
+        _mm512_storeu_pd(b, _mm512_shuffle_f64x2(u0, v0, 0x44));
+        _mm512_storeu_pd(b + ldb, _mm512_shuffle_f64x2(u1, v1, 0x44));
+        _mm512_storeu_pd(b + 2 * ldb, _mm512_shuffle_f64x2(u2, v2, 0x44));
+        _mm512_storeu_pd(b + 3 * ldb, _mm512_shuffle_f64x2(u3, v3, 0x44));
+        _mm512_storeu_pd(b + 4 * ldb, _mm512_shuffle_f64x2(u0, v0, 0xEE));
+        _mm512_storeu_pd(b + 5 * ldb, _mm512_shuffle_f64x2(u1, v1, 0xEE));
+        _mm512_storeu_pd(b + 6 * ldb, _mm512_shuffle_f64x2(u2, v2, 0xEE));
+        _mm512_storeu_pd(b + 7 * ldb, _mm512_shuffle_f64x2(u3, v3, 0xEE));
+    }
+};
+
+template<>
+struct TransposeMicro<float, SimdLevel::Avx2> {
+    static constexpr size_t W = 8;
+    MATRIX_TARGET("avx2,fma")
+    static void run(const float* a, size_t lda, float* b, size_t ldb) {
+        __m256 r[8];
+        for (size_t i = 0; i < 8; i++) {
+            r[i] = _mm256_loadu_ps(a + i * lda);
+        }
+        __m256 t[8];
+        for (size_t i = 0; i < 8; i += 2) {
+            t[i] = _mm256_unpacklo_ps(r[i], r[i + 1]);
+            t[i + 1] = _mm256_unpackhi_ps(r[i], r[i + 1]);
+        }
+        __m256 s[8];
+        for (size_t h = 0; h < 8; h += 4) {
+            s[h] = _mm256_shuffle_ps(t[h], t[h + 2], _MM_SHUFFLE(1, 0, 1, 0));
+            s[h + 1] = _mm256_shuffle_ps(t[h], t[h + 2], _MM_SHUFFLE(3, 2, 3, 2));
+            s[h + 2] = _mm256_shuffle_ps(t[h + 1], t[h + 3], _MM_SHUFFLE(1, 0, 1, 0));
+            s[h + 3] = _mm256_shuffle_ps(t[h + 1], t[h + 3], _MM_SHUFFLE(3, 2, 3, 2));
+        }
+        for (size_t j = 0; j < 4; j++) {
+            _mm256_storeu_ps(b + j * ldb, _mm256_permute2f128_ps(s[j], s[j + 4], 0x20));
+            _mm256_storeu_ps(b + (j + 4) * ldb, _mm256_permute2f128_ps(s[j], s[j + 4], 0x31));
+        }
+    }
+};
+
+/// 8 x 8 float   AVX -   , AVX-512  AVX2
+template<>
+struct TransposeMicro<float, SimdLevel::Avx512> : TransposeMicro<float, SimdLevel::Avx2> {};
+
+/// complex<double> - 128- :      
+template<>
+struct TransposeMicro<std::complex<double>, SimdLevel::Avx2> {
+    static constexpr size_t W = 2;
+    MATRIX_TARGET("avx2,fma")
+    static void run(const std::complex<double>* a, size_t lda, std::complex<double>* b, size_t ldb) {
+        const __m256d r0 = _mm256_loadu_pd(reinterpret_cast<const double*>(a));
+        const __m256d r1 = _mm256_loadu_pd(reinterpret_cast<const double*>(a + lda));
+        _mm256_storeu_pd(reinterpret_cast<double*>(b), _mm256_permute2f128_pd(r0, r1, 0x20));
+        _mm256_storeu_pd(reinterpret_cast<double*>(b + ldb), _mm256_permute2f128_pd(r0, r1, 0x31));
+    }
+};
+
+template<>
+struct TransposeMicro<std::complex<double>, SimdLevel::Avx512> {
+    static constexpr size_t W = 4;
+    MATRIX_TARGET("avx512f")
+    static void run(const std::complex<double>* a, size_t lda, std::complex<double>* b, size_t ldb) {
+        const __m512d r0 = _mm512_loadu_pd(reinterpret_cast<const double*>(a));
+        const __m512d r1 = _mm512_loadu_pd(reinterpret_cast<const double*>(a + lda));
+        const __m512d r2 = _mm512_loadu_pd(reinterpret_cast<const double*>(a + 2 * lda));
+        const __m512d r3 = _mm512_loadu_pd(reinterpret_cast<const double*>(a + 3 * lda));
+        // ׸     ,     
+        const __m512d t0 = _mm512_shuffle_f64x2(r0, r1, 0x88);
+        const __m512d t1 = _mm512_shuffle_f64x2(r0, r1, 0xDD);
+        const __m512d t2 = _mm512_shuffle_f64x2(r2, r3, 0x88);
+        const __m512d t3 = _mm512_shuffle_f64x2(r2, r3, 0xDD);
+        _mm512_storeu_pd(reinterpret_cast<double*>(b), _mm512_shuffle_f64x2(t0, t2, 0x88));
+        _mm512_storeu_pd(reinterpret_cast<double*>(b + ldb), _mm512_shuffle_f64x2(t1, t3, 0x88));
+        _mm512_storeu_pd(reinterpret_cast<double*>(b + 2 * ldb), _mm512_shuffle_f64x2(t0, t2, 0xDD));
+        _mm512_storeu_pd(reinterpret_cast<double*>(b + 3 * ldb), _mm512_shuffle_f64x2(t1, t3, 0xDD));
+    }
+};
+#endif
+
+/// : b = a^T   rows x cols
+template<typename K, typename T>
+inline void transposeLeafBlock(const T* a, size_t lda, T* b, size_t ldb, size_t rows, size_t cols) {
+    constexpr size_t W = K::W;
+    const size_t rowsTiled = rows / W * W;
+    const size_t colsTiled = cols / W * W;
+    for (size_t i = 0; i < rowsTiled; i += W) {
+        for (size_t j = 0; j < colsTiled; j += W) {
+            K::run(a + i * lda + j, lda, b + j * ldb + i, ldb);
+        }
+    }
+    for (size_t i = 0; i < rows; i++) {
+        for (size_t j = i < rowsTiled ? colsTiled : 0; j < cols; j++) {
+            b[j * ldb + i] = a[i * lda + j];
+        }
+    }
+}
+
+///   W x W  : X = Y^T, Y = X^T
+template<typename K, typename T>
+inline void transposeSwapTile(T* x, T* y, size_t ld) {
+    constexpr size_t W = K::W;
+    T tile[W * W];
+    K::run(x, ld, tile, W);
+    K::run(y, ld, x, ld);
+    for (size_t i = 0; i < W; i++) {
+        std::copy(tile + i * W, tile + (i + 1) * W, y + i * ld);
+    }
+}
+
+///  :  X (rows x cols)   Y (cols x rows)    
+template<typename K, typename T>
+inline void transposeSwapBlock(T* x, T* y, size_t ld, size_t rows, size_t cols) {
+    constexpr size_t W = K::W;
+    const size_t rowsTiled = rows / W * W;
+    const size_t colsTiled = cols / W * W;
+    for (size_t i = 0; i < rowsTiled; i += W) {
+        for (size_t j = 0; j < colsTiled; j += W) {
+            transposeSwapTile<K>(x + i * ld + j, y + j * ld + i, ld);
+        }
+    }
+    for (size_t i = 0; i < rows; i++) {
+        for (size_t j = i < rowsTiled ? colsTiled : 0; j < cols; j++) {
+            std::swap(x[i * ld + j], y[j * ld + i]);
+        }
+    }
+}
+
+///   :   n x n  
+template<typename K, typename T>
+inline void transposeDiagonalBlock(T* a, size_t ld, size_t n) {
+    constexpr size_t W = K::W;
+    const size_t tiled = n / W * W;
+    for (size_t i = 0; i < tiled; i += W) {
+        K::run(a + i * ld + i, ld, a + i * ld + i, ld);
+        for (size_t j = i + W; j < tiled; j += W) {
+            transposeSwapTile<K>(a + i * ld + j, a + j * ld + i, ld);
+        }
+    }
+    for (size_t i = tiled; i < n; i++) {
+        for (size_t j = 0; j < i; j++) {
+            std::swap(a[i * ld + j], a[j * ld + i]);
+        }
+    }
+}
+
+template<typename T, SimdLevel L>
+struct TransposeKernels {
+    static void block(const T* a, size_t lda, T* b, size_t ldb, size_t rows, size_t cols) {
+        transposeLeafBlock<TransposeMicro<T, L>>(a, lda, b, ldb, rows, cols);
+    }
+
+    static void swap(T* x, T* y, size_t ld, size_t rows, size_t cols) {
+        transposeSwapBlock<TransposeMicro<T, L>>(x, y, ld, rows, cols);
+    }
+
+    static void diagonal(T* a, size_t ld, size_t n) {
+        transposeDiagonalBlock<TransposeMicro<T, L>>(a, ld, n);
+    }
+};
+
+#if MATRIX_X86_DISPATCH
+template<typename T>
+struct TransposeKernels<T, SimdLevel::Avx2> {
+    MATRIX_TARGET("avx2,fma") MATRIX_FLATTEN
+    static void block(const T* a, size_t lda, T* b, size_t ldb, size_t rows, size_t cols) {
+        transposeLeafBlock<TransposeMicro<T, SimdLevel::Avx2>>(a, lda, b, ldb, rows, cols);
+    }
+
+    MATRIX_TARGET("avx2,fma") MATRIX_FLATTEN
+    static void swap(T* x, T* y, size_t ld, size_t rows, size_t cols) {
+        transposeSwapBlock<TransposeMicro<T, SimdLevel::Avx2>>(x, y, ld, rows, cols);
+    }
+
+    MATRIX_TARGET("avx2,fma") MATRIX_FLATTEN
+    static void diagonal(T* a, size_t ld, size_t n) {
+        transposeDiagonalBlock<TransposeMicro<T, SimdLevel::Avx2>>(a, ld, n);
+    }
+};
+
+template<typename T>
+struct TransposeKernels<T, SimdLevel::Avx512> {
+    MATRIX_TARGET("avx512f") MATRIX_FLATTEN
+    static void block(const T* a, size_t lda, T* b, size_t ldb, size_t rows, size_t cols) {
+        transposeLeafBlock<TransposeMicro<T, SimdLevel::Avx512>>(a, lda, b, ldb, rows, cols);
+    }
+
+    MATRIX_TARGET("avx512f") MATRIX_FLATTEN
+    static void swap(T* x, T* y, size_t ld, size_t rows, size_t cols) {
+        transposeSwapBlock<TransposeMicro<T, SimdLevel::Avx512>>(x, y, ld, rows, cols);
+    }
+
+    MATRIX_TARGET("avx512f") MATRIX_FLATTEN
+    static void diagonal(T* a, size_t ld, size_t n) {
+        transposeDiagonalBlock<TransposeMicro<T, SimdLevel::Avx512>>(a, ld, n);
+    }
+};
+#endif
+
+///    
+template<typename T>
+struct TransposeLeaves {
+    void (*block)(const T*, size_t, T*, size_t, size_t, size_t);
+    void (*swap)(T*, T*, size_t, size_t, size_t);
+    void (*diagonal)(T*, size_t, size_t);
+};
+
+template<typename T>
+TransposeLeaves<T> transposeLeaves() {
+    switch (simdLevel()) {
+    case SimdLevel::Avx512:
+        return {&TransposeKernels<T, SimdLevel::Avx512>::block, &TransposeKernels<T, SimdLevel::Avx512>::swap,
+            &TransposeKernels<T, SimdLevel::Avx512>::diagonal};
+    case SimdLevel::Avx2:
+        return {&TransposeKernels<T, SimdLevel::Avx2>::block, &TransposeKernels<T, SimdLevel::Avx2>::swap,
+            &TransposeKernels<T, SimdLevel::Avx2>::diagonal};
+    default:
+        return {&TransposeKernels<T, SimdLevel::Generic>::block, &TransposeKernels<T, SimdLevel::Generic>::swap,
+            &TransposeKernels<T, SimdLevel::Generic>::diagonal};
+    }
+}
+
+///  : ,   ,  8,     
+inline size_t transposeSplit(size_t n) {
+    const size_t half = (n / 2 + 7) / 8 * 8;
+    return half < n ? half : n / 2;
+}
+
+template<typename T>
+void transposeRecursive(const TransposeLeaves<T>& leaves, const T* a, size_t lda, T* b, size_t ldb, size_t rows, size_t cols) {
+    if (rows <= transposeLeaf && cols <= transposeLeaf) {
+        leaves.block(a, lda, b, ldb, rows, cols);
+        return;
+    }
+    if (rows >= cols) {
+        const size_t r = transposeSplit(rows);
+        transposeRecursive(leaves, a, lda, b, ldb, r, cols);
+        transposeRecursive(leaves, a + r * lda, lda, b + r, ldb, rows - r, cols);
+    }
+    else {
+        const size_t c = transposeSplit(cols);
+        transposeRecursive(leaves, a, lda, b, ldb, rows, c);
+        transposeRecursive(leaves, a + c, lda, b + c * ldb, ldb, rows, cols - c);
+    }
+}
+
+/// X (rows x cols)  Y (cols x rows)    
+template<typename T>
+void transposeSwapRecursive(const TransposeLeaves<T>& leaves, T* x, T* y, size_t ld, size_t rows, size_t cols) {
+    if (rows <= transposeLeaf && cols <= transposeLeaf) {
+        leaves.swap(x, y, ld, rows, cols);
+        return;
+    }
+    if (rows >= cols) {
+        const size_t r = transposeSplit(rows);
+        transposeSwapRecursive(leaves, x, y, ld, r, cols);
+        transposeSwapRecursive(leaves, x + r * ld, y + r, ld, rows - r, cols);
+    }
+    else {
+        const size_t c = transposeSplit(cols);
+        transposeSwapRecursive(leaves, x, y, ld, rows, c);
+        transposeSwapRecursive(leaves, x + c, y + c * ld, ld, rows, cols - c);
+    }
+}
+
+template<typename T>
+void transposeSquareRecursive(const TransposeLeaves<T>& leaves, T* a, size_t ld, size_t n) {
+    if (n <= transposeLeaf) {
+        leaves.diagonal(a, ld, n);
+        return;
+    }
+    const size_t h = transposeSplit(n);
+    transposeSquareRecursive(leaves, a, ld, h);
+    transposeSquareRecursive(leaves, a + h * ld + h, ld, n - h);
+    transposeSwapRecursive(leaves, a + h, a + h * ld, ld, h, n - h);
+}
+
+} // namespace detail
+
+
+/// B = A^T: A - rows x cols    lda, B - cols x rows    ldb.
+///    .       transposeTask.
+template<typename T>
+void transpose(size_t rows, size_t cols, const T* a, size_t lda, T* b, size_t ldb) {
+    const detail::TransposeLeaves<T> leaves = detail::transposeLeaves<T>();
+    const size_t task = detail::transposeTask;
+    const size_t rowTasks = (rows + task - 1) / task;
+    const size_t colTasks = (cols + task - 1) / task;
+    parallelFor(rowTasks * colTasks, [&](size_t t) {
+        const size_t i = t / colTasks * task;
+        const size_t j = t % colTasks * task;
+        detail::transposeRecursive(leaves, a + i * lda + j, lda, b + j * ldb + i, ldb,
+            std::min(task, rows - i), std::min(task, cols - j));
+    });
+}
+
+///    n x n   (  ld).
+///   -      ,   .
+template<typename T>
+void transposeSquareInPlace(size_t n, T* a, size_t ld) {
+    const detail::TransposeLeaves<T> leaves = detail::transposeLeaves<T>();
+    const size_t task = detail::transposeTask;
+    const size_t blocks = (n + task - 1) / task;
+    parallelFor(blocks * (blocks + 1) / 2, [&](size_t t) {
+        //  t ->   (bi <= bj)   
+        size_t bi = 0;
+        while (t >= blocks - bi) {
+            t -= blocks - bi;
+            bi++;
+        }
+        const size_t bj = bi + t;
+        const size_t i = bi * task;
+        const size_t j = bj * task;
+        const size_t rows = std::min(task, n - i);
+        const size_t cols = std::min(task, n - j);
+        if (bi == bj) {
+            detail::transposeSquareRecursive(leaves, a + i * ld + i, ld, rows);
+        }
+        else {
+            detail::transposeSwapRecursive(leaves, a + i * ld + j, a + j * ld + i, ld, rows, cols);
+        }
+    });
+}
+
+///   (  )  rows x cols  .
+///     ,   
+///    (rows * cols ).
+template<typename T>
+void transposeInPlace(size_t rows, size_t cols, T* data) {
+    if (rows == cols) {
+        transposeSquareInPlace(rows, data, cols);
+        return;
+    }
+    const size_t size = rows * cols;
+    if (rows <= 1 || cols <= 1) {
+        return;
+    }
+    const size_t last = size - 1;
+    std::vector<bool> visited(size);
+    //       
+    for (size_t start = 1; start < last; start++) {
+        if (visited[start]) {
+            continue;
+        }
+        //  (i, j)   p = i * cols + j   j * rows + i
+        T value = data[start];
+        size_t p = start;
+        do {
+            const size_t next = p % cols * rows + p / cols;
+            std::swap(value, data[next]);
+            visited[next] = true;
+            p = next;
+        } while (p != start);
+    }
+}